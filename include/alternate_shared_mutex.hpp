@@ -26,6 +26,7 @@
 #ifndef YAMC_ALTERNATE_SHARED_MUTEX_HPP_
 #define YAMC_ALTERNATE_SHARED_MUTEX_HPP_
 
+#include <atomic>
 #include <cassert>
 #include <chrono>
 #include <condition_variable>
@@ -42,6 +43,14 @@ namespace yamc {
  * - yamc::alternate::shared_timed_mutex
  * - yamc::alternate::basic_shared_mutex<RwLockPolicy>
  * - yamc::alternate::basic_shared_timed_mutex<RwLockPolicy>
+ *
+ * With yamc::rwlock::LockFree<RwLockPolicy>, uncontended lock operations are a single CAS.
+ *
+ * Upgrade ownership (Boost.Thread UpgradeLockable):
+ * - lock_upgrade(), try_lock_upgrade(), unlock_upgrade()
+ * - unlock_upgrade_and_lock(): promote to exclusive-lock without releasing
+ * - unlock_upgrade_and_lock_shared(): demote to shared-lock
+ * Only one thread owns upgrade-lock at the same time, which coexists with shared-locks.
  */
 namespace alternate {
 
@@ -106,41 +115,49 @@ protected:
       cv_.notify_all();
     }
   }
-};
-
-} // namespace detail
-
-
-template <typename RwLockPolicy>
-class basic_shared_mutex : private detail::shared_mutex_base<RwLockPolicy> {
-  using base = detail::shared_mutex_base<RwLockPolicy>;
-
-public:
-  basic_shared_mutex() = default;
-  ~basic_shared_mutex() = default;
-
-  basic_shared_mutex(const basic_shared_mutex&) = delete;
-  basic_shared_mutex& operator=(const basic_shared_mutex&) = delete;
 
-  using base::lock;
-  using base::try_lock;
-  using base::unlock;
-
-  using base::lock_shared;
-  using base::try_lock_shared;
-  using base::unlock_shared;
-};
+  void lock_upgrade()
+  {
+    std::unique_lock<decltype(mtx_)> lk(mtx_);
+    while (RwLockPolicy::wait_ulock(state_)) {
+      cv_.wait(lk);
+    }
+    RwLockPolicy::acquire_ulock(state_);
+  }
 
-using shared_mutex = basic_shared_mutex<YAMC_RWLOCK_SCHED_DEFAULT>;
+  bool try_lock_upgrade()
+  {
+    std::lock_guard<decltype(mtx_)> lk(mtx_);
+    if (RwLockPolicy::wait_ulock(state_))
+      return false;
+    RwLockPolicy::acquire_ulock(state_);
+    return true;
+  }
 
+  void unlock_upgrade()
+  {
+    std::lock_guard<decltype(mtx_)> lk(mtx_);
+    RwLockPolicy::release_ulock(state_);
+    cv_.notify_all();
+  }
 
-template <typename RwLockPolicy>
-class basic_shared_timed_mutex : private detail::shared_mutex_base<RwLockPolicy> {
-  using base = detail::shared_mutex_base<RwLockPolicy>;
+  void unlock_upgrade_and_lock()
+  {
+    std::unique_lock<decltype(mtx_)> lk(mtx_);
+    RwLockPolicy::before_wait_upgrade(state_);
+    while (RwLockPolicy::wait_upgrade(state_)) {
+      cv_.wait(lk);
+    }
+    RwLockPolicy::after_wait_upgrade(state_);
+    RwLockPolicy::upgrade_ulock(state_);
+  }
 
-  using base::state_;
-  using base::cv_;
-  using base::mtx_;
+  void unlock_upgrade_and_lock_shared()
+  {
+    std::lock_guard<decltype(mtx_)> lk(mtx_);
+    RwLockPolicy::downgrade_ulock(state_);
+    cv_.notify_all();
+  }
 
   template<typename Clock, typename Duration>
   bool do_try_lockwait(const std::chrono::time_point<Clock, Duration>& tp)
@@ -174,6 +191,271 @@ class basic_shared_timed_mutex : private detail::shared_mutex_base<RwLockPolicy>
     RwLockPolicy::acquire_rlock(state_);
     return true;
   }
+};
+
+
+/// shared mutex with lock-free fast path
+///
+/// The policy state is stored into single atomic word, and thread takes mtx_ only when wait.
+/// nwait_ denote the number of waiting threads, lock releaser notify them via cv_.
+///
+template <typename RwLockPolicy>
+class shared_mutex_base<yamc::rwlock::LockFree<RwLockPolicy>> {
+protected:
+  using policy = yamc::rwlock::LockFree<RwLockPolicy>;
+  using state = typename policy::state;
+
+  std::atomic<std::size_t> state_{policy::pack(state{})};
+  std::atomic<std::size_t> nwait_{0};  // modified under mtx_
+  std::condition_variable cv_;
+  std::mutex mtx_;
+
+  // apply state transition f if it returns true
+  template <typename F>
+  bool transit(F f)
+  {
+    std::size_t word = state_.load(std::memory_order_seq_cst);
+    for (;;) {
+      state s = policy::unpack(word);
+      if (!f(s))
+        return false;
+      // seq_cst CAS pairs with nwait_ in notify_waiters()
+      if (state_.compare_exchange_weak(word, policy::pack(s), std::memory_order_seq_cst))
+        return true;
+    }
+  }
+
+  void notify_waiters()
+  {
+    if (nwait_.load(std::memory_order_seq_cst) != 0) {
+      std::lock_guard<decltype(mtx_)> lk(mtx_);
+      cv_.notify_all();
+    }
+  }
+
+  static bool try_wlock(state& s)
+  {
+    if (policy::wait_wlock(s))
+      return false;
+    policy::acquire_wlock(s);
+    return true;
+  }
+
+  static bool try_wlock_after_wait(state& s)
+  {
+    if (policy::wait_wlock(s))
+      return false;
+    policy::after_wait_wlock(s);
+    policy::acquire_wlock(s);
+    return true;
+  }
+
+  static bool try_rlock(state& s)
+  {
+    if (policy::wait_rlock(s))
+      return false;
+    policy::acquire_rlock(s);
+    return true;
+  }
+
+  static bool try_ulock(state& s)
+  {
+    if (policy::wait_ulock(s))
+      return false;
+    policy::acquire_ulock(s);
+    return true;
+  }
+
+  static bool try_upgrade(state& s)
+  {
+    if (policy::wait_upgrade(s))
+      return false;
+    policy::upgrade_ulock(s);
+    return true;
+  }
+
+  static bool try_upgrade_after_wait(state& s)
+  {
+    if (policy::wait_upgrade(s))
+      return false;
+    policy::after_wait_upgrade(s);
+    policy::upgrade_ulock(s);
+    return true;
+  }
+
+  void lock()
+  {
+    if (transit(try_wlock))
+      return;
+    std::unique_lock<decltype(mtx_)> lk(mtx_);
+    nwait_.fetch_add(1, std::memory_order_seq_cst);
+    transit([](state& s) { policy::before_wait_wlock(s); return true; });
+    while (!transit(try_wlock_after_wait)) {
+      cv_.wait(lk);
+    }
+    nwait_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  bool try_lock()
+  {
+    return transit(try_wlock);
+  }
+
+  void unlock()
+  {
+    transit([](state& s) { policy::release_wlock(s); return true; });
+    notify_waiters();
+  }
+
+  void lock_shared()
+  {
+    if (transit(try_rlock))
+      return;
+    std::unique_lock<decltype(mtx_)> lk(mtx_);
+    nwait_.fetch_add(1, std::memory_order_seq_cst);
+    while (!transit(try_rlock)) {
+      cv_.wait(lk);
+    }
+    nwait_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  bool try_lock_shared()
+  {
+    return transit(try_rlock);
+  }
+
+  void unlock_shared()
+  {
+    bool last = false;
+    transit([&last](state& s) { last = policy::release_rlock(s); return true; });
+    if (last) {
+      notify_waiters();
+    }
+  }
+
+  void lock_upgrade()
+  {
+    if (transit(try_ulock))
+      return;
+    std::unique_lock<decltype(mtx_)> lk(mtx_);
+    nwait_.fetch_add(1, std::memory_order_seq_cst);
+    while (!transit(try_ulock)) {
+      cv_.wait(lk);
+    }
+    nwait_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  bool try_lock_upgrade()
+  {
+    return transit(try_ulock);
+  }
+
+  void unlock_upgrade()
+  {
+    transit([](state& s) { policy::release_ulock(s); return true; });
+    notify_waiters();
+  }
+
+  void unlock_upgrade_and_lock()
+  {
+    if (transit(try_upgrade))
+      return;
+    std::unique_lock<decltype(mtx_)> lk(mtx_);
+    nwait_.fetch_add(1, std::memory_order_seq_cst);
+    transit([](state& s) { policy::before_wait_upgrade(s); return true; });
+    while (!transit(try_upgrade_after_wait)) {
+      cv_.wait(lk);
+    }
+    nwait_.fetch_sub(1, std::memory_order_relaxed);
+  }
+
+  void unlock_upgrade_and_lock_shared()
+  {
+    transit([](state& s) { policy::downgrade_ulock(s); return true; });
+    notify_waiters();
+  }
+
+  template<typename Clock, typename Duration>
+  bool do_try_lockwait(const std::chrono::time_point<Clock, Duration>& tp)
+  {
+    if (transit(try_wlock))
+      return true;
+    std::unique_lock<decltype(mtx_)> lk(mtx_);
+    nwait_.fetch_add(1, std::memory_order_seq_cst);
+    transit([](state& s) { policy::before_wait_wlock(s); return true; });
+    bool result = true;
+    while (!transit(try_wlock_after_wait)) {
+      if (cv_.wait_until(lk, tp) == std::cv_status::timeout) {
+        if (transit(try_wlock_after_wait))  // re-check predicate
+          break;
+        transit([](state& s) { policy::after_wait_wlock(s); return true; });
+        // blocked readers may proceed (WriterPrefer)
+        cv_.notify_all();
+        result = false;
+        break;
+      }
+    }
+    nwait_.fetch_sub(1, std::memory_order_relaxed);
+    return result;
+  }
+
+  template<typename Clock, typename Duration>
+  bool do_try_lock_sharedwait(const std::chrono::time_point<Clock, Duration>& tp)
+  {
+    if (transit(try_rlock))
+      return true;
+    std::unique_lock<decltype(mtx_)> lk(mtx_);
+    nwait_.fetch_add(1, std::memory_order_seq_cst);
+    bool result = true;
+    while (!transit(try_rlock)) {
+      if (cv_.wait_until(lk, tp) == std::cv_status::timeout) {
+        result = transit(try_rlock);  // re-check predicate
+        break;
+      }
+    }
+    nwait_.fetch_sub(1, std::memory_order_relaxed);
+    return result;
+  }
+};
+
+} // namespace detail
+
+
+template <typename RwLockPolicy>
+class basic_shared_mutex : private detail::shared_mutex_base<RwLockPolicy> {
+  using base = detail::shared_mutex_base<RwLockPolicy>;
+
+public:
+  basic_shared_mutex() = default;
+  ~basic_shared_mutex() = default;
+
+  basic_shared_mutex(const basic_shared_mutex&) = delete;
+  basic_shared_mutex& operator=(const basic_shared_mutex&) = delete;
+
+  using base::lock;
+  using base::try_lock;
+  using base::unlock;
+
+  using base::lock_shared;
+  using base::try_lock_shared;
+  using base::unlock_shared;
+
+  using base::lock_upgrade;
+  using base::try_lock_upgrade;
+  using base::unlock_upgrade;
+  using base::unlock_upgrade_and_lock;
+  using base::unlock_upgrade_and_lock_shared;
+};
+
+using shared_mutex = basic_shared_mutex<YAMC_RWLOCK_SCHED_DEFAULT>;
+
+
+template <typename RwLockPolicy>
+class basic_shared_timed_mutex : private detail::shared_mutex_base<RwLockPolicy> {
+  using base = detail::shared_mutex_base<RwLockPolicy>;
+
+  using base::do_try_lockwait;
+  using base::do_try_lock_sharedwait;
 
 public:
   basic_shared_timed_mutex() = default;
@@ -203,6 +485,12 @@ public:
   using base::try_lock_shared;
   using base::unlock_shared;
 
+  using base::lock_upgrade;
+  using base::try_lock_upgrade;
+  using base::unlock_upgrade;
+  using base::unlock_upgrade_and_lock;
+  using base::unlock_upgrade_and_lock_shared;
+
   template<typename Rep, typename Period>
   bool try_lock_shared_for(const std::chrono::duration<Rep, Period>& duration)
   {
@@ -33,6 +33,7 @@
 #include <mutex>
 #include <system_error>
 #include <thread>
+#include "yamc_checked_sampling.hpp"
 #include "yamc_lock_validator.hpp"
 
 
@@ -56,6 +57,11 @@ namespace yamc {
  * - yamc::checked::timed_mutex
  * - yamc::checked::recursive_mutex
  * - yamc::checked::recursive_timed_mutex
+ *
+ * Unsampled objects (see yamc::checked::sampling) just forward to std::mutex,
+ * std::timed_mutex, std::recursive_mutex and std::recursive_timed_mutex respectively.
+ * With YAMC_CHECKED_SAMPLING=1, each object embeds the forwarded native primitive next to
+ * the checking state (checked::mutex forwards to its inner std::mutex instead).
  */
 namespace checked {
 
@@ -100,17 +106,16 @@ protected:
       throw std::system_error(std::make_error_code(std::errc::resource_deadlock_would_occur), "recursive lock");
 #endif
     }
-    while (owner_ != std::thread::id()) {
-      if (!validator::enqueue(reinterpret_cast<uintptr_t>(this), tid, false)) {
-        // deadlock detection
+    if (!validator::enqueue(reinterpret_cast<uintptr_t>(this), tid, false)) {
+      // deadlock detection
 #if YAMC_CHECKED_CALL_ABORT
-        std::abort();
+      std::abort();
 #else
-        throw std::system_error(std::make_error_code(std::errc::resource_deadlock_would_occur), "deadlock");
+      throw std::system_error(std::make_error_code(std::errc::resource_deadlock_would_occur), "deadlock");
 #endif
-      }
+    }
+    while (owner_ != std::thread::id()) {
       cv_.wait(lk);
-      validator::dequeue(reinterpret_cast<uintptr_t>(this), tid);
     }
     owner_ = tid;
     validator::locked(reinterpret_cast<uintptr_t>(this), tid, false);
@@ -184,17 +189,16 @@ protected:
       ++ncount_;
       return;
     }
-    while (ncount_ != 0) {
-      if (!validator::enqueue(reinterpret_cast<uintptr_t>(this), tid, false)) {
-        // deadlock detection
+    if (!validator::enqueue(reinterpret_cast<uintptr_t>(this), tid, false)) {
+      // deadlock detection
 #if YAMC_CHECKED_CALL_ABORT
-        std::abort();
+      std::abort();
 #else
-        throw std::system_error(std::make_error_code(std::errc::resource_deadlock_would_occur), "deadlock");
+      throw std::system_error(std::make_error_code(std::errc::resource_deadlock_would_occur), "deadlock");
 #endif
-      }
+    }
+    while (ncount_ != 0) {
       cv_.wait(lk);
-      validator::dequeue(reinterpret_cast<uintptr_t>(this), tid);
     }
     assert(owner_ == std::thread::id());
     ncount_ = 1;
@@ -244,17 +248,24 @@ protected:
 } // namespace detail
 
 
-class mutex : private detail::mutex_base {
+class mutex : private detail::mutex_base,
+    private detail::bypass<void> {
   using base = detail::mutex_base;
+  using bypass = detail::bypass<void>;
 
 public:
-  mutex()
+  mutex() : mutex(sampling::select()) {}
+
+  explicit mutex(bool sampled) : bypass(sampled)
   {
-    detail::validator::ctor(reinterpret_cast<uintptr_t>(this));
+    if (sampled_)
+      detail::validator::ctor(reinterpret_cast<uintptr_t>(this));
   }
 
   ~mutex() noexcept(false)
   {
+    if (!sampled_)
+      return;
     detail::validator::dtor(reinterpret_cast<uintptr_t>(this));
     dtor_precondition("abandoned mutex");
   }
@@ -262,14 +273,38 @@ public:
   mutex(const mutex&) = delete;
   mutex& operator=(const mutex&) = delete;
 
-  using base::lock;
-  using base::try_lock;
-  using base::unlock;
+  bool sampled() const noexcept
+  {
+    return sampled_;
+  }
+
+  void lock()
+  {
+    if (sampled_)
+      base::lock();
+    else
+      mtx_.lock();
+  }
+
+  bool try_lock()
+  {
+    return sampled_ ? base::try_lock() : mtx_.try_lock();
+  }
+
+  void unlock()
+  {
+    if (sampled_)
+      base::unlock();
+    else
+      mtx_.unlock();
+  }
 };
 
 
-class timed_mutex : private detail::mutex_base {
+class timed_mutex : private detail::mutex_base,
+    private detail::bypass<std::timed_mutex> {
   using base = detail::mutex_base;
+  using bypass = detail::bypass<std::timed_mutex>;
 
   template<typename Clock, typename Duration>
   bool do_try_lockwait(const std::chrono::time_point<Clock, Duration>& tp, const char* emsg)
@@ -298,13 +333,18 @@ class timed_mutex : private detail::mutex_base {
   }
 
 public:
-  timed_mutex()
+  timed_mutex() : timed_mutex(sampling::select()) {}
+
+  explicit timed_mutex(bool sampled) : bypass(sampled)
   {
-    detail::validator::ctor(reinterpret_cast<uintptr_t>(this));
+    if (sampled_)
+      detail::validator::ctor(reinterpret_cast<uintptr_t>(this));
   }
 
   ~timed_mutex() noexcept(false)
   {
+    if (!sampled_)
+      return;
     detail::validator::dtor(reinterpret_cast<uintptr_t>(this));
     dtor_precondition("abandoned timed_mutex");
   }
@@ -312,13 +352,37 @@ public:
   timed_mutex(const timed_mutex&) = delete;
   timed_mutex& operator=(const timed_mutex&) = delete;
 
-  using base::lock;
-  using base::try_lock;
-  using base::unlock;
+  bool sampled() const noexcept
+  {
+    return sampled_;
+  }
+
+  void lock()
+  {
+    if (sampled_)
+      base::lock();
+    else
+      raw_.lock();
+  }
+
+  bool try_lock()
+  {
+    return sampled_ ? base::try_lock() : raw_.try_lock();
+  }
+
+  void unlock()
+  {
+    if (sampled_)
+      base::unlock();
+    else
+      raw_.unlock();
+  }
 
   template<typename Rep, typename Period>
   bool try_lock_for(const std::chrono::duration<Rep, Period>& duration)
   {
+    if (!sampled_)
+      return raw_.try_lock_for(duration);
     const auto tp = std::chrono::steady_clock::now() + duration;
     return do_try_lockwait(tp, "recursive try_lock_for");
   }
@@ -326,22 +390,31 @@ public:
   template<typename Clock, typename Duration>
   bool try_lock_until(const std::chrono::time_point<Clock, Duration>& tp)
   {
+    if (!sampled_)
+      return raw_.try_lock_until(tp);
     return do_try_lockwait(tp, "recursive try_lock_until");
   }
 };
 
 
-class recursive_mutex : private detail::recursive_mutex_base {
+class recursive_mutex : private detail::recursive_mutex_base,
+    private detail::bypass<std::recursive_mutex> {
   using base = detail::recursive_mutex_base;
+  using bypass = detail::bypass<std::recursive_mutex>;
 
 public:
-  recursive_mutex()
+  recursive_mutex() : recursive_mutex(sampling::select()) {}
+
+  explicit recursive_mutex(bool sampled) : bypass(sampled)
   {
-    detail::validator::ctor(reinterpret_cast<uintptr_t>(this));
+    if (sampled_)
+      detail::validator::ctor(reinterpret_cast<uintptr_t>(this));
   }
 
   ~recursive_mutex() noexcept(false)
   {
+    if (!sampled_)
+      return;
     detail::validator::dtor(reinterpret_cast<uintptr_t>(this));
     dtor_precondition("abandoned recursive_mutex");
   }
@@ -349,14 +422,38 @@ public:
   recursive_mutex(const recursive_mutex&) = delete;
   recursive_mutex& operator=(const recursive_mutex&) = delete;
 
-  using base::lock;
-  using base::try_lock;
-  using base::unlock;
+  bool sampled() const noexcept
+  {
+    return sampled_;
+  }
+
+  void lock()
+  {
+    if (sampled_)
+      base::lock();
+    else
+      raw_.lock();
+  }
+
+  bool try_lock()
+  {
+    return sampled_ ? base::try_lock() : raw_.try_lock();
+  }
+
+  void unlock()
+  {
+    if (sampled_)
+      base::unlock();
+    else
+      raw_.unlock();
+  }
 };
 
 
-class recursive_timed_mutex : private detail::recursive_mutex_base {
+class recursive_timed_mutex : private detail::recursive_mutex_base,
+    private detail::bypass<std::recursive_timed_mutex> {
   using base = detail::recursive_mutex_base;
+  using bypass = detail::bypass<std::recursive_timed_mutex>;
 
   template<typename Clock, typename Duration>
   bool do_try_lockwait(const std::chrono::time_point<Clock, Duration>& tp)
@@ -382,13 +479,18 @@ class recursive_timed_mutex : private detail::recursive_mutex_base {
   }
 
 public:
-  recursive_timed_mutex()
+  recursive_timed_mutex() : recursive_timed_mutex(sampling::select()) {}
+
+  explicit recursive_timed_mutex(bool sampled) : bypass(sampled)
   {
-    detail::validator::ctor(reinterpret_cast<uintptr_t>(this));
+    if (sampled_)
+      detail::validator::ctor(reinterpret_cast<uintptr_t>(this));
   }
 
   ~recursive_timed_mutex() noexcept(false)
   {
+    if (!sampled_)
+      return;
     detail::validator::dtor(reinterpret_cast<uintptr_t>(this));
     dtor_precondition("abandoned recursive_timed_mutex");
   }
@@ -396,13 +498,37 @@ public:
   recursive_timed_mutex(const recursive_timed_mutex&) = delete;
   recursive_timed_mutex& operator=(const recursive_timed_mutex&) = delete;
 
-  using base::lock;
-  using base::try_lock;
-  using base::unlock;
+  bool sampled() const noexcept
+  {
+    return sampled_;
+  }
+
+  void lock()
+  {
+    if (sampled_)
+      base::lock();
+    else
+      raw_.lock();
+  }
+
+  bool try_lock()
+  {
+    return sampled_ ? base::try_lock() : raw_.try_lock();
+  }
+
+  void unlock()
+  {
+    if (sampled_)
+      base::unlock();
+    else
+      raw_.unlock();
+  }
 
   template<typename Rep, typename Period>
   bool try_lock_for(const std::chrono::duration<Rep, Period>& duration)
   {
+    if (!sampled_)
+      return raw_.try_lock_for(duration);
     const auto tp = std::chrono::steady_clock::now() + duration;
     return do_try_lockwait(tp);
   }
@@ -410,6 +536,8 @@ public:
   template<typename Clock, typename Duration>
   bool try_lock_until(const std::chrono::time_point<Clock, Duration>& tp)
   {
+    if (!sampled_)
+      return raw_.try_lock_until(tp);
     return do_try_lockwait(tp);
   }
 };
@@ -34,7 +34,9 @@
 #include <system_error>
 #include <thread>
 #include <vector>
+#include "alternate_shared_mutex.hpp"
 #include "yamc_rwlock_sched.hpp"
+#include "yamc_checked_sampling.hpp"
 #include "yamc_lock_validator.hpp"
 
 
@@ -58,6 +60,9 @@ namespace yamc {
  * - yamc::checked::shared_timed_mutex
  * - yamc::checked::basic_shared_mutex<RwLockPolicy>
  * - yamc::checked::basic_shared_timed_mutex<RwLockPolicy>
+ *
+ * Unsampled objects (see yamc::checked::sampling, YAMC_CHECKED_SAMPLING=1) just forward to
+ * yamc::alternate::basic_shared_(timed_)mutex<RwLockPolicy>.
  */
 namespace checked {
 
@@ -110,18 +115,17 @@ protected:
       throw std::system_error(std::make_error_code(std::errc::resource_deadlock_would_occur), "recursive lock");
 #endif
     }
-    RwLockPolicy::before_wait_wlock(state_);
-    while (RwLockPolicy::wait_wlock(state_)) {
-      if (!validator::enqueue(reinterpret_cast<uintptr_t>(this), tid, false)) {
-        // deadlock detection
+    if (!validator::enqueue(reinterpret_cast<uintptr_t>(this), tid, false)) {
+      // deadlock detection
 #if YAMC_CHECKED_CALL_ABORT
-        std::abort();
+      std::abort();
 #else
-        throw std::system_error(std::make_error_code(std::errc::resource_deadlock_would_occur), "deadlock");
+      throw std::system_error(std::make_error_code(std::errc::resource_deadlock_would_occur), "deadlock");
 #endif
-      }
+    }
+    RwLockPolicy::before_wait_wlock(state_);
+    while (RwLockPolicy::wait_wlock(state_)) {
       cv_.wait(lk);
-      validator::dequeue(reinterpret_cast<uintptr_t>(this), tid);
     }
     RwLockPolicy::after_wait_wlock(state_);
     RwLockPolicy::acquire_wlock(state_);
@@ -179,17 +183,16 @@ protected:
       throw std::system_error(std::make_error_code(std::errc::resource_deadlock_would_occur), "recursive lock_shared");
 #endif
     }
-    while (RwLockPolicy::wait_rlock(state_)) {
-      if (!validator::enqueue(reinterpret_cast<uintptr_t>(this), tid, true)) {
-        // deadlock detection
+    if (!validator::enqueue(reinterpret_cast<uintptr_t>(this), tid, true)) {
+      // deadlock detection
 #if YAMC_CHECKED_CALL_ABORT
-        std::abort();
+      std::abort();
 #else
-        throw std::system_error(std::make_error_code(std::errc::resource_deadlock_would_occur), "deadlock");
+      throw std::system_error(std::make_error_code(std::errc::resource_deadlock_would_occur), "deadlock");
 #endif
-      }
+    }
+    while (RwLockPolicy::wait_rlock(state_)) {
       cv_.wait(lk);
-      validator::dequeue(reinterpret_cast<uintptr_t>(this), tid);
     }
     RwLockPolicy::acquire_rlock(state_);
     s_owner_.push_back(tid);
@@ -241,17 +244,24 @@ protected:
 
 
 template <typename RwLockPolicy>
-class basic_shared_mutex : private detail::shared_mutex_base<RwLockPolicy> {
+class basic_shared_mutex : private detail::shared_mutex_base<RwLockPolicy>,
+    private detail::bypass<yamc::alternate::basic_shared_mutex<RwLockPolicy>> {
   using base = detail::shared_mutex_base<RwLockPolicy>;
+  using bypass = detail::bypass<yamc::alternate::basic_shared_mutex<RwLockPolicy>>;
 
 public:
-  basic_shared_mutex()
+  basic_shared_mutex() : basic_shared_mutex(sampling::select()) {}
+
+  explicit basic_shared_mutex(bool sampled) : bypass(sampled)
   {
-    detail::validator::ctor(reinterpret_cast<uintptr_t>(this));
+    if (this->sampled_)
+      detail::validator::ctor(reinterpret_cast<uintptr_t>(this));
   }
 
   ~basic_shared_mutex() noexcept(false)
   {
+    if (!this->sampled_)
+      return;
     detail::validator::dtor(reinterpret_cast<uintptr_t>(this));
     base::dtor_precondition("abandoned shared_mutex");
   }
@@ -259,21 +269,62 @@ public:
   basic_shared_mutex(const basic_shared_mutex&) = delete;
   basic_shared_mutex& operator=(const basic_shared_mutex&) = delete;
 
-  using base::lock;
-  using base::try_lock;
-  using base::unlock;
+  bool sampled() const noexcept
+  {
+    return this->sampled_;
+  }
 
-  using base::lock_shared;
-  using base::try_lock_shared;
-  using base::unlock_shared;
+  void lock()
+  {
+    if (this->sampled_)
+      base::lock();
+    else
+      this->raw_.lock();
+  }
+
+  bool try_lock()
+  {
+    return this->sampled_ ? base::try_lock() : this->raw_.try_lock();
+  }
+
+  void unlock()
+  {
+    if (this->sampled_)
+      base::unlock();
+    else
+      this->raw_.unlock();
+  }
+
+  void lock_shared()
+  {
+    if (this->sampled_)
+      base::lock_shared();
+    else
+      this->raw_.lock_shared();
+  }
+
+  bool try_lock_shared()
+  {
+    return this->sampled_ ? base::try_lock_shared() : this->raw_.try_lock_shared();
+  }
+
+  void unlock_shared()
+  {
+    if (this->sampled_)
+      base::unlock_shared();
+    else
+      this->raw_.unlock_shared();
+  }
 };
 
 using shared_mutex = basic_shared_mutex<YAMC_RWLOCK_SCHED_DEFAULT>;
 
 
 template <typename RwLockPolicy>
-class basic_shared_timed_mutex : private detail::shared_mutex_base<RwLockPolicy> {
+class basic_shared_timed_mutex : private detail::shared_mutex_base<RwLockPolicy>,
+    private detail::bypass<yamc::alternate::basic_shared_timed_mutex<RwLockPolicy>> {
   using base = detail::shared_mutex_base<RwLockPolicy>;
+  using bypass = detail::bypass<yamc::alternate::basic_shared_timed_mutex<RwLockPolicy>>;
 
   using base::state_;
   using base::e_owner_;
@@ -339,13 +390,18 @@ class basic_shared_timed_mutex : private detail::shared_mutex_base<RwLockPolicy>
   }
 
 public:
-  basic_shared_timed_mutex()
+  basic_shared_timed_mutex() : basic_shared_timed_mutex(sampling::select()) {}
+
+  explicit basic_shared_timed_mutex(bool sampled) : bypass(sampled)
   {
-    detail::validator::ctor(reinterpret_cast<uintptr_t>(this));
+    if (this->sampled_)
+      detail::validator::ctor(reinterpret_cast<uintptr_t>(this));
   }
 
   ~basic_shared_timed_mutex() noexcept(false)
   {
+    if (!this->sampled_)
+      return;
     detail::validator::dtor(reinterpret_cast<uintptr_t>(this));
     base::dtor_precondition("abandoned shared_timed_mutex");
   }
@@ -353,13 +409,37 @@ public:
   basic_shared_timed_mutex(const basic_shared_timed_mutex&) = delete;
   basic_shared_timed_mutex& operator=(const basic_shared_timed_mutex&) = delete;
 
-  using base::lock;
-  using base::try_lock;
-  using base::unlock;
+  bool sampled() const noexcept
+  {
+    return this->sampled_;
+  }
+
+  void lock()
+  {
+    if (this->sampled_)
+      base::lock();
+    else
+      this->raw_.lock();
+  }
+
+  bool try_lock()
+  {
+    return this->sampled_ ? base::try_lock() : this->raw_.try_lock();
+  }
+
+  void unlock()
+  {
+    if (this->sampled_)
+      base::unlock();
+    else
+      this->raw_.unlock();
+  }
 
   template<typename Rep, typename Period>
   bool try_lock_for(const std::chrono::duration<Rep, Period>& duration)
   {
+    if (!this->sampled_)
+      return this->raw_.try_lock_for(duration);
     const auto tp = std::chrono::steady_clock::now() + duration;
     return do_try_lockwait(tp, "recursive try_lock_for");
   }
@@ -367,16 +447,37 @@ public:
   template<typename Clock, typename Duration>
   bool try_lock_until(const std::chrono::time_point<Clock, Duration>& tp)
   {
+    if (!this->sampled_)
+      return this->raw_.try_lock_until(tp);
     return do_try_lockwait(tp, "recursive try_lock_until");
   }
 
-  using base::lock_shared;
-  using base::try_lock_shared;
-  using base::unlock_shared;
+  void lock_shared()
+  {
+    if (this->sampled_)
+      base::lock_shared();
+    else
+      this->raw_.lock_shared();
+  }
+
+  bool try_lock_shared()
+  {
+    return this->sampled_ ? base::try_lock_shared() : this->raw_.try_lock_shared();
+  }
+
+  void unlock_shared()
+  {
+    if (this->sampled_)
+      base::unlock_shared();
+    else
+      this->raw_.unlock_shared();
+  }
 
   template<typename Rep, typename Period>
   bool try_lock_shared_for(const std::chrono::duration<Rep, Period>& duration)
   {
+    if (!this->sampled_)
+      return this->raw_.try_lock_shared_for(duration);
     const auto tp = std::chrono::steady_clock::now() + duration;
     return do_try_lock_sharedwait(tp, "recursive try_lock_shared_for");
   }
@@ -384,6 +485,8 @@ public:
   template<typename Clock, typename Duration>
   bool try_lock_shared_until(const std::chrono::time_point<Clock, Duration>& tp)
   {
+    if (!this->sampled_)
+      return this->raw_.try_lock_shared_until(tp);
     return do_try_lock_sharedwait(tp, "recursive try_lock_shared_until");
   }
 };
@@ -0,0 +1,208 @@
+/*
+ * cohort_mutex.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2019 yohhoy
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef YAMC_COHORT_MUTEX_HPP_
+#define YAMC_COHORT_MUTEX_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include "ticket_spin_mutex.hpp"
+#include "ttas_spin_mutex.hpp"
+#include "yamc_config.hpp"
+// NUMA node discovery
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+
+
+/// number of local locks (cohorts) in yamc::cohort::mutex
+#ifndef YAMC_COHORT_NODES
+#define YAMC_COHORT_NODES 4
+#endif
+
+/// default maximum number of consecutive handoffs within a cohort
+#ifndef YAMC_COHORT_BATCH_LIMIT
+#define YAMC_COHORT_BATCH_LIMIT 64
+#endif
+
+/// number of lock operations between refreshes of cached NUMA node of each thread
+#ifndef YAMC_COHORT_NODE_REFRESH
+#define YAMC_COHORT_NODE_REFRESH 64
+#endif
+
+
+namespace yamc {
+
+/*
+ * NUMA-aware cohort lock
+ *
+ * - yamc::cohort::basic_mutex<GlobalLock, LocalLock, BatchLimit>
+ * - yamc::cohort::mutex<GlobalLock, LocalLock>
+ * - yamc::cohort::current_node()
+ * - yamc::cohort::this_thread_node()
+ *
+ * Each NUMA node (cohort) has its own LocalLock in separate cache line. A thread acquires
+ * the local lock of its current node first, and then the GlobalLock unless it has been
+ * passed from the previous owner in the same cohort. unlock() passes global ownership to
+ * waiting thread in the same cohort up to BatchLimit times consecutively, so the lock and
+ * protected data stay in one node's cache instead of migrating across nodes on each handoff.
+ *
+ * GlobalLock shall be "thread-oblivious", which may be released by another thread than its
+ * acquirer (e.g. yamc::spin_ticket::mutex, yamc::spin_mcs::mutex, yamc::spin_ttas::mutex).
+ * Node index is this_thread_node() modulo YAMC_COHORT_NODES, it affects only performance.
+ * this_thread_node() caches current_node() per thread, and refreshes it only once per
+ * YAMC_COHORT_NODE_REFRESH calls since current_node() may be a system call.
+ * Local locks are aligned to cache line, also when the mutex is allocated by new-expression.
+ *
+ * D. Dice, V. J. Marathe, N. Shavit, "Lock Cohorting: A General Technique for Designing
+ * NUMA Locks", PPoPP 2012.
+ */
+namespace cohort {
+
+/// NUMA node number of the processor which runs current thread, or 0 if unknown
+inline unsigned current_node()
+{
+#if defined(__linux__)
+  unsigned cpu = 0, node = 0;
+#if defined(__GLIBC__) && defined(__USE_GNU) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 29))
+  // glibc 2.29 or later provides getcpu() wrapper on vDSO
+  if (::getcpu(&cpu, &node) != 0)
+    return 0;
+#else
+  if (::syscall(SYS_getcpu, &cpu, &node, nullptr) != 0)
+    return 0;
+#endif
+  return node;
+#elif defined(_WIN32)
+  ::PROCESSOR_NUMBER pn;
+  ::USHORT node = 0;
+  ::GetCurrentProcessorNumberEx(&pn);
+  if (!::GetNumaProcessorNodeEx(&pn, &node))
+    return 0;
+  return node;
+#else
+  return 0;
+#endif
+}
+
+/// cached NUMA node of current thread, which may be stale after migration to another node
+inline unsigned this_thread_node()
+{
+  static thread_local unsigned node = 0;
+  static thread_local unsigned count = 0;
+  if (count++ % YAMC_COHORT_NODE_REFRESH == 0)
+    node = current_node();
+  return node;
+}
+
+
+template <typename GlobalLock, typename LocalLock, unsigned BatchLimit>
+class basic_mutex : public yamc::detail::cacheline_aligned_new {
+  static_assert(0 < BatchLimit, "BatchLimit shall be positive");
+
+  struct alignas(YAMC_CACHELINE_SIZE) cohort_node {
+    LocalLock lock;
+    std::atomic<unsigned> nwaiter{0};  // number of threads waiting on local lock
+    // following members are guarded by local lock
+    bool global_owned = false;
+    unsigned nbatch = 0;
+  };
+
+  GlobalLock global_;
+  cohort_node* owner_ = nullptr;  // guarded by cohort lock itself
+  cohort_node nodes_[YAMC_COHORT_NODES];
+
+  cohort_node& this_node()
+  {
+    return nodes_[this_thread_node() % YAMC_COHORT_NODES];
+  }
+
+  void acquired(cohort_node& nd)
+  {
+    if (!nd.global_owned) {
+      global_.lock();
+      nd.global_owned = true;
+      nd.nbatch = 0;
+    }
+    owner_ = &nd;
+  }
+
+public:
+  basic_mutex() = default;
+  ~basic_mutex() = default;
+
+  basic_mutex(const basic_mutex&) = delete;
+  basic_mutex& operator=(const basic_mutex&) = delete;
+
+  void lock()
+  {
+    cohort_node& nd = this_node();
+    nd.nwaiter.fetch_add(1, std::memory_order_relaxed);
+    nd.lock.lock();
+    nd.nwaiter.fetch_sub(1, std::memory_order_relaxed);
+    acquired(nd);
+  }
+
+  bool try_lock()
+  {
+    cohort_node& nd = this_node();
+    if (!nd.lock.try_lock())
+      return false;
+    if (!nd.global_owned) {
+      if (!global_.try_lock()) {
+        nd.lock.unlock();
+        return false;
+      }
+      nd.global_owned = true;
+      nd.nbatch = 0;
+    }
+    owner_ = &nd;
+    return true;
+  }
+
+  void unlock()
+  {
+    // current thread may have migrated to another node, use recorded owner node
+    cohort_node& nd = *owner_;
+    if (BatchLimit <= ++nd.nbatch || nd.nwaiter.load(std::memory_order_relaxed) == 0) {
+      nd.global_owned = false;
+      global_.unlock();
+    }
+    // otherwise global ownership is passed to waiter in the same cohort
+    nd.lock.unlock();
+  }
+};
+
+template <typename GlobalLock = yamc::spin_ticket::mutex, typename LocalLock = yamc::spin_ttas::mutex>
+using mutex = basic_mutex<GlobalLock, LocalLock, YAMC_COHORT_BATCH_LIMIT>;
+
+} // namespace cohort
+} // namespace yamc
+
+#endif
@@ -0,0 +1,178 @@
+/*
+ * distributed_shared_mutex.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2019 yohhoy
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef YAMC_DISTRIBUTED_SHARED_MUTEX_HPP_
+#define YAMC_DISTRIBUTED_SHARED_MUTEX_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <condition_variable>
+#include <mutex>
+#include "yamc_config.hpp"
+#include "yamc_thread_hint.hpp"
+
+
+/// default number of reader slots of yamc::distributed::shared_mutex
+#ifndef YAMC_DISTRIBUTED_SLOTS
+#define YAMC_DISTRIBUTED_SLOTS 32
+#endif
+
+
+namespace yamc {
+
+/*
+ * distributed (big-reader) shared mutex
+ *
+ * - yamc::distributed::shared_mutex
+ * - yamc::distributed::basic_shared_mutex<NumSlots>
+ *
+ * Reader increments a reader counter in cache-line-padded slot which is selected by sequential
+ * per-thread hint, so that readers on different slots never touch the same cache line.
+ * Writer sets writer flag to revoke reader fast path, then waits until all slots are drained.
+ * Readers back off while writer flag is set, so writers take precedence (WriterPrefer).
+ * Reader side is cheap, but writer side costs O(NumSlots).
+ * Slots are aligned to cache line, also when the mutex itself is allocated by new-expression.
+ */
+namespace distributed {
+
+template <std::size_t NumSlots>
+class basic_shared_mutex : public yamc::detail::cacheline_aligned_new {
+  static_assert(0 < NumSlots, "NumSlots shall be positive");
+
+  struct alignas(YAMC_CACHELINE_SIZE) slot {
+    std::atomic<std::size_t> count;
+  };
+
+  slot slots_[NumSlots];
+  std::atomic<bool> writer_{false};  // modified under mtx_
+  std::condition_variable cv_;
+  std::mutex mtx_;
+
+  slot& current_slot()
+  {
+    return slots_[yamc::detail::this_thread_slot_hint() % NumSlots];
+  }
+
+  bool try_enter(slot& s)
+  {
+    // seq_cst RMW/load pairs with writer_ store/slot load in lock()
+    s.count.fetch_add(1, std::memory_order_seq_cst);
+    if (!writer_.load(std::memory_order_seq_cst))
+      return true;
+    leave(s);
+    return false;
+  }
+
+  void leave(slot& s)
+  {
+    if (s.count.fetch_sub(1, std::memory_order_seq_cst) == 1 && writer_.load(std::memory_order_seq_cst)) {
+      // writer may wait for draining slots
+      std::lock_guard<decltype(mtx_)> lk(mtx_);
+      cv_.notify_all();
+    }
+  }
+
+  bool drained() const
+  {
+    for (const auto& s : slots_) {
+      if (s.count.load(std::memory_order_seq_cst) != 0)
+        return false;
+    }
+    return true;
+  }
+
+public:
+  basic_shared_mutex()
+  {
+    for (auto& s : slots_) {
+      s.count.store(0, std::memory_order_relaxed);
+    }
+  }
+  ~basic_shared_mutex() = default;
+
+  basic_shared_mutex(const basic_shared_mutex&) = delete;
+  basic_shared_mutex& operator=(const basic_shared_mutex&) = delete;
+
+  void lock()
+  {
+    std::unique_lock<decltype(mtx_)> lk(mtx_);
+    while (writer_.load(std::memory_order_relaxed)) {
+      cv_.wait(lk);
+    }
+    writer_.store(true, std::memory_order_seq_cst);
+    while (!drained()) {
+      cv_.wait(lk);
+    }
+  }
+
+  bool try_lock()
+  {
+    std::lock_guard<decltype(mtx_)> lk(mtx_);
+    if (writer_.load(std::memory_order_relaxed))
+      return false;
+    writer_.store(true, std::memory_order_seq_cst);
+    if (drained())
+      return true;
+    // rollback, and wake up readers which back off
+    writer_.store(false, std::memory_order_seq_cst);
+    cv_.notify_all();
+    return false;
+  }
+
+  void unlock()
+  {
+    std::lock_guard<decltype(mtx_)> lk(mtx_);
+    writer_.store(false, std::memory_order_seq_cst);
+    cv_.notify_all();
+  }
+
+  void lock_shared()
+  {
+    slot& s = current_slot();
+    while (!try_enter(s)) {
+      std::unique_lock<decltype(mtx_)> lk(mtx_);
+      while (writer_.load(std::memory_order_relaxed)) {
+        cv_.wait(lk);
+      }
+    }
+  }
+
+  bool try_lock_shared()
+  {
+    return try_enter(current_slot());
+  }
+
+  void unlock_shared()
+  {
+    leave(current_slot());
+  }
+};
+
+using shared_mutex = basic_shared_mutex<YAMC_DISTRIBUTED_SLOTS>;
+
+} // namespace distributed
+} // namespace yamc
+
+#endif
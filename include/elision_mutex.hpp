@@ -0,0 +1,364 @@
+/*
+ * elision_mutex.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2019 yohhoy
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef YAMC_ELISION_MUTEX_HPP_
+#define YAMC_ELISION_MUTEX_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "alternate_shared_mutex.hpp"
+#include "ttas_spin_mutex.hpp"
+#include "yamc_backoff_spin.hpp"
+
+// Hardware Transactional Memory (enabled by compiler option, e.g. -mrtm or -march=armv9-a+tme)
+#if defined(__RTM__) && (defined(__GNUC__) || defined(__clang__))
+#include <cpuid.h>
+#include <immintrin.h>
+#define YAMC_ELISION_RTM 1
+#define YAMC_ELISION_SUPPORTED 1
+#elif defined(__ARM_FEATURE_TME)
+#include <arm_acle.h>
+#define YAMC_ELISION_TME 1
+#define YAMC_ELISION_SUPPORTED 1
+#else
+#define YAMC_ELISION_SUPPORTED 0
+#endif
+
+
+/// retry count of hardware transaction before fallback
+#ifndef YAMC_ELISION_RETRY_COUNT
+#define YAMC_ELISION_RETRY_COUNT 3
+#endif
+
+/// number of locking which skip elision after persistent transaction abort
+#ifndef YAMC_ELISION_SKIP_COUNT
+#define YAMC_ELISION_SKIP_COUNT 3
+#endif
+
+
+namespace yamc {
+
+/*
+ * hardware lock elision
+ *
+ * - yamc::elision::mutex<FallbackMutex>
+ * - yamc::elision::shared_mutex<FallbackSharedMutex>
+ *
+ * Critical section runs as hardware transaction (Intel RTM or Arm TME) without acquiring lock,
+ * only lock state flag of the fallback path is kept in transaction read set.
+ * Shared-lock is elided only while no fallback reader exists, so that unlock decides
+ * commit or fallback release from the mutex's own state regardless of unlock order.
+ * After YAMC_ELISION_RETRY_COUNT aborts, it acquires wrapped FallbackMutex with normal locking.
+ * Capacity overflow or other persistent abort disables elision for subsequent
+ * YAMC_ELISION_SKIP_COUNT lock operations (same as glibc adaptive elision).
+ * When transactional memory is not available, these types just forward to FallbackMutex.
+ */
+namespace elision {
+
+namespace detail {
+
+#if YAMC_ELISION_RTM
+using htm_status = unsigned;
+const htm_status htm_started = _XBEGIN_STARTED;
+
+inline bool rtm_cpuid()
+{
+  // CPUID.(EAX=7,ECX=0):EBX[bit 11] = RTM
+  unsigned a, b, c, d;
+  return __get_cpuid_count(7, 0, &a, &b, &c, &d) && (b & (1u << 11));
+}
+
+// CPUID is queried once at static initialization, not on lock path
+// (reads false until initialized, then elision is simply not used)
+template <typename = void>
+struct htm_support {
+  static const bool rtm;
+};
+
+template <typename T>
+const bool htm_support<T>::rtm = rtm_cpuid();
+
+inline bool htm_available() { return htm_support<>::rtm; }
+
+inline htm_status htm_begin() { return _xbegin(); }
+inline void htm_end() { _xend(); }
+inline void htm_abort_busy() { _xabort(0xff); }
+inline bool htm_test() { return _xtest() != 0; }
+
+inline bool htm_aborted_busy(htm_status s)
+{
+  return (s & _XABORT_EXPLICIT) && _XABORT_CODE(s) == 0xff;
+}
+
+inline bool htm_retryable(htm_status s)
+{
+  return (s & (_XABORT_RETRY | _XABORT_CONFLICT)) != 0;
+}
+
+#elif YAMC_ELISION_TME
+using htm_status = uint64_t;
+const htm_status htm_started = 0;
+
+inline bool htm_available() { return true; }
+inline htm_status htm_begin() { return __tstart(); }
+inline void htm_end() { __tcommit(); }
+inline void htm_abort_busy() { __tcancel(0xff); }
+inline bool htm_test() { return __ttest() != 0; }
+
+inline bool htm_aborted_busy(htm_status s)
+{
+  return (s & _TMFAILURE_CNCL) && (s & _TMFAILURE_REASON) == 0xff;
+}
+
+inline bool htm_retryable(htm_status s)
+{
+  return (s & _TMFAILURE_RTRY) != 0;
+}
+
+#endif
+
+#if YAMC_ELISION_SUPPORTED
+/// try to start hardware transaction, return true if critical section is elided
+template <typename Predicate>
+bool try_elide(std::atomic<int>& adapt, Predicate lockfree)
+{
+  if (htm_test()) {
+    // nested in outer transaction, flattened into it
+    // (nesting depth is balanced by htm_end() on unlock)
+    htm_begin();
+    if (!lockfree())
+      htm_abort_busy();
+    return true;
+  }
+  if (!htm_available())
+    return false;
+  const int skip = adapt.load(std::memory_order_relaxed);
+  if (0 < skip) {
+    adapt.store(skip - 1, std::memory_order_relaxed);
+    return false;
+  }
+  for (unsigned n = 0; n < YAMC_ELISION_RETRY_COUNT; n++) {
+    const htm_status status = htm_begin();
+    if (status == htm_started) {
+      // put fallback lock state into read set
+      if (lockfree())
+        return true;
+      htm_abort_busy();
+    }
+    if (htm_aborted_busy(status)) {
+      // fallback lock is held by other thread
+      while (!lockfree()) {
+        yamc::backoff::cpu_relax();
+      }
+    } else if (!htm_retryable(status)) {
+      // capacity overflow, system call, etc.
+      adapt.store(YAMC_ELISION_SKIP_COUNT, std::memory_order_relaxed);
+      return false;
+    }
+  }
+  return false;
+}
+
+inline void commit()
+{
+  htm_end();
+}
+#else
+template <typename Predicate>
+bool try_elide(std::atomic<int>&, Predicate)
+{
+  return false;
+}
+
+inline void commit() {}
+#endif
+
+} // namespace detail
+
+
+template <typename FallbackMutex = yamc::spin_ttas::mutex>
+class mutex {
+  std::atomic<bool> locked_{false};  // fallback lock is held
+  std::atomic<int> adapt_{0};
+  FallbackMutex mtx_;
+
+  bool is_lockfree() const
+  {
+    return !locked_.load(std::memory_order_acquire);
+  }
+
+  void mark_locked()
+  {
+    locked_.store(true, std::memory_order_relaxed);
+    // abort elided critical sections before entering it
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+
+public:
+  using fallback_mutex_type = FallbackMutex;
+
+  mutex() = default;
+  ~mutex() = default;
+
+  mutex(const mutex&) = delete;
+  mutex& operator=(const mutex&) = delete;
+
+  void lock()
+  {
+    if (detail::try_elide(adapt_, [this]{ return is_lockfree(); }))
+      return;
+    mtx_.lock();
+    mark_locked();
+  }
+
+  bool try_lock()
+  {
+    if (detail::try_elide(adapt_, [this]{ return is_lockfree(); }))
+      return true;
+    if (!mtx_.try_lock())
+      return false;
+    mark_locked();
+    return true;
+  }
+
+  void unlock()
+  {
+    // fallback lock flag is set iff this mutex was acquired on fallback path
+    if (!locked_.load(std::memory_order_relaxed)) {
+      detail::commit();
+      return;
+    }
+    locked_.store(false, std::memory_order_release);
+    mtx_.unlock();
+  }
+};
+
+
+template <typename FallbackSharedMutex = yamc::alternate::shared_mutex>
+class shared_mutex {
+  std::atomic<bool> locked_{false};      // fallback exclusive-lock is held
+  std::atomic<std::size_t> nreader_{0};  // number of fallback shared-lock holders
+  std::atomic<int> adapt_{0};
+  FallbackSharedMutex mtx_;
+
+  bool is_lockfree() const
+  {
+    return !locked_.load(std::memory_order_acquire) && nreader_.load(std::memory_order_acquire) == 0;
+  }
+
+  bool is_shared_elidable() const
+  {
+    // join fallback readers instead of waiting for them to leave
+    return nreader_.load(std::memory_order_relaxed) == 0;
+  }
+
+  void mark_locked()
+  {
+    locked_.store(true, std::memory_order_relaxed);
+    // abort elided critical sections before entering it
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+
+  void mark_shared_locked()
+  {
+    nreader_.fetch_add(1, std::memory_order_relaxed);
+    // abort elided exclusive critical sections before entering it
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+  }
+
+public:
+  using fallback_mutex_type = FallbackSharedMutex;
+
+  shared_mutex() = default;
+  ~shared_mutex() = default;
+
+  shared_mutex(const shared_mutex&) = delete;
+  shared_mutex& operator=(const shared_mutex&) = delete;
+
+  void lock()
+  {
+    if (detail::try_elide(adapt_, [this]{ return is_lockfree(); }))
+      return;
+    mtx_.lock();
+    mark_locked();
+  }
+
+  bool try_lock()
+  {
+    if (detail::try_elide(adapt_, [this]{ return is_lockfree(); }))
+      return true;
+    if (!mtx_.try_lock())
+      return false;
+    mark_locked();
+    return true;
+  }
+
+  void unlock()
+  {
+    // fallback lock flag is set iff this mutex was acquired on fallback path
+    if (!locked_.load(std::memory_order_relaxed)) {
+      detail::commit();
+      return;
+    }
+    locked_.store(false, std::memory_order_release);
+    mtx_.unlock();
+  }
+
+  void lock_shared()
+  {
+    if (is_shared_elidable() && detail::try_elide(adapt_, [this]{ return is_lockfree(); }))
+      return;
+    mtx_.lock_shared();
+    mark_shared_locked();
+  }
+
+  bool try_lock_shared()
+  {
+    if (is_shared_elidable() && detail::try_elide(adapt_, [this]{ return is_lockfree(); }))
+      return true;
+    if (!mtx_.try_lock_shared())
+      return false;
+    mark_shared_locked();
+    return true;
+  }
+
+  void unlock_shared()
+  {
+    // elided shared-lock requires no fallback reader, and fallback reader
+    // aborts elided one, so zero readers means this shared-lock was elided
+    if (nreader_.load(std::memory_order_relaxed) == 0) {
+      detail::commit();
+      return;
+    }
+    nreader_.fetch_sub(1, std::memory_order_release);
+    mtx_.unlock_shared();
+  }
+};
+
+} // namespace elision
+} // namespace yamc
+
+#endif
@@ -42,113 +42,12 @@ namespace yamc {
  * - yamc::fair::recursive_mutex
  * - yamc::fair::timed_mutex
  * - yamc::fair::recursive_timed_mutex
+ *
+ * Waiting threads are queued in FIFO order, and unlock() wakes up only the next waiter
+ * with its own condition variable (direct handoff).
  */
 namespace fair {
 
-class mutex {
-  std::size_t next_ = 0;
-  std::size_t curr_ = 0;
-  std::condition_variable cv_;
-  std::mutex mtx_;
-
-public:
-  mutex() = default;
-  ~mutex() = default;
-
-  mutex(const mutex&) = delete;
-  mutex& operator=(const mutex&) = delete;
-
-  void lock()
-  {
-    std::unique_lock<decltype(mtx_)> lk(mtx_);
-    const std::size_t request = next_++;
-    while (request != curr_) {
-      cv_.wait(lk);
-    }
-  }
-
-  bool try_lock()
-  {
-    std::lock_guard<decltype(mtx_)> lk(mtx_);
-    if (next_ != curr_)
-      return false;
-    ++next_;
-    return true;
-  }
-
-  void unlock()
-  {
-    std::lock_guard<decltype(mtx_)> lk(mtx_);
-    ++curr_;
-    cv_.notify_all();
-  }
-};
-
-
-class recursive_mutex {
-  std::size_t next_ = 0;
-  std::size_t curr_ = 0;
-  std::size_t ncount_ = 0;
-  std::thread::id owner_;
-  std::condition_variable cv_;
-  std::mutex mtx_;
-
-public:
-  recursive_mutex() = default;
-  ~recursive_mutex() = default;
-
-  recursive_mutex(const recursive_mutex&) = delete;
-  recursive_mutex& operator=(const recursive_mutex&) = delete;
-
-  void lock()
-  {
-    const auto tid = std::this_thread::get_id();
-    std::unique_lock<decltype(mtx_)> lk(mtx_);
-    if (owner_ == tid) {
-      assert(0 < ncount_);
-      ++ncount_;
-      return;
-    }
-    const std::size_t request = next_++;
-    while (request != curr_) {
-      cv_.wait(lk);
-    }
-    assert(ncount_ == 0 && owner_ == std::thread::id());
-    ncount_ = 1;
-    owner_ = tid;
-  }
-
-  bool try_lock()
-  {
-    const auto tid = std::this_thread::get_id();
-    std::lock_guard<decltype(mtx_)> lk(mtx_);
-    if (owner_ == tid) {
-      assert(0 < ncount_);
-      ++ncount_;
-      return true;
-    }
-    if (next_ != curr_)
-      return false;
-    ++next_;
-    assert(ncount_ == 0 && owner_ == std::thread::id());
-    ncount_ = 1;
-    owner_ = tid;
-    return true;
-  }
-
-  void unlock()
-  {
-    std::lock_guard<decltype(mtx_)> lk(mtx_);
-    assert(0 < ncount_ && owner_ == std::this_thread::get_id());
-    if (--ncount_ == 0) {
-      ++curr_;
-      owner_ = std::thread::id();
-      cv_.notify_all();
-    }
-  }
-};
-
-
 namespace detail {
 
 class timed_mutex_impl {
@@ -158,9 +57,13 @@ public:
     node* prev;
   };
 
+  // queue node of waiting thread, which is notified directly by unlock()
+  struct waiter : node {
+    std::condition_variable cv;
+  };
+
   node queue_;   // q.next = front(), q.prev = back()
   node locked_;  // placeholder node of 'locked' state
-  std::condition_variable cv_;
   std::mutex mtx_;
 
 private:
@@ -190,13 +93,23 @@ private:
 
   void wq_replace_front(node* p)
   {
-    // q.push_front() + q.push_front(p)
+    // q.pop_front() + q.push_front(p)
     node* front = queue_.next;
     assert(front != p);
-    *p = *front;
+    p->next = front->next;
+    p->prev = &queue_;
     queue_.next = front->next->prev = p;
   }
 
+  void wq_notify_front()
+  {
+    // all nodes except 'locked' placeholder are waiters
+    if (!wq_empty()) {
+      assert(queue_.next != &locked_);
+      static_cast<waiter*>(queue_.next)->cv.notify_one();
+    }
+  }
+
 public:
   timed_mutex_impl()
     : queue_{&queue_, &queue_} {}
@@ -210,10 +123,10 @@ public:
   void impl_lock(std::unique_lock<std::mutex>& lk)
   {
     if (!wq_empty()) {
-      node request;
+      waiter request;
       wq_push_back(&request);
       while (queue_.next != &request) {
-        cv_.wait(lk);
+        request.cv.wait(lk);
       }
       wq_replace_front(&locked_);
     } else {
@@ -234,17 +147,17 @@ public:
   {
     assert(queue_.next == &locked_);
     wq_pop_front();
-    cv_.notify_all();
+    wq_notify_front();
   }
 
   template<typename Clock, typename Duration>
   bool impl_try_lockwait(std::unique_lock<std::mutex>& lk, const std::chrono::time_point<Clock, Duration>& tp)
   {
     if (!wq_empty()) {
-      node request;
+      waiter request;
       wq_push_back(&request);
       while (queue_.next != &request) {
-        if (cv_.wait_until(lk, tp) == std::cv_status::timeout) {
+        if (request.cv.wait_until(lk, tp) == std::cv_status::timeout) {
           if (queue_.next == &request)  // re-check predicate
             break;
           wq_erase(&request);
@@ -262,6 +175,90 @@ public:
 } // namespace detail
 
 
+class mutex {
+  detail::timed_mutex_impl impl_;
+
+public:
+  mutex() = default;
+  ~mutex() = default;
+
+  mutex(const mutex&) = delete;
+  mutex& operator=(const mutex&) = delete;
+
+  void lock()
+  {
+    auto lk = impl_.internal_lock();
+    impl_.impl_lock(lk);
+  }
+
+  bool try_lock()
+  {
+    auto lk = impl_.internal_lock();
+    return impl_.impl_try_lock();
+  }
+
+  void unlock()
+  {
+    auto lk = impl_.internal_lock();
+    impl_.impl_unlock();
+  }
+};
+
+
+class recursive_mutex {
+  std::size_t ncount_ = 0;
+  std::thread::id owner_ = {};
+  detail::timed_mutex_impl impl_;
+
+public:
+  recursive_mutex() = default;
+  ~recursive_mutex() = default;
+
+  recursive_mutex(const recursive_mutex&) = delete;
+  recursive_mutex& operator=(const recursive_mutex&) = delete;
+
+  void lock()
+  {
+    const auto tid = std::this_thread::get_id();
+    auto lk = impl_.internal_lock();
+    if (owner_ == tid) {
+      assert(0 < ncount_);
+      ++ncount_;
+    } else {
+      impl_.impl_lock(lk);
+      ncount_ = 1;
+      owner_ = tid;
+    }
+  }
+
+  bool try_lock()
+  {
+    const auto tid = std::this_thread::get_id();
+    auto lk = impl_.internal_lock();
+    if (owner_ == tid) {
+      assert(0 < ncount_);
+      ++ncount_;
+      return true;
+    }
+    if (!impl_.impl_try_lock())
+      return false;
+    ncount_ = 1;
+    owner_ = tid;
+    return true;
+  }
+
+  void unlock()
+  {
+    auto lk = impl_.internal_lock();
+    assert(0 < ncount_ && owner_ == std::this_thread::get_id());
+    if (--ncount_ == 0) {
+      impl_.impl_unlock();
+      owner_ = std::thread::id();
+    }
+  }
+};
+
+
 class timed_mutex {
   detail::timed_mutex_impl impl_;
 
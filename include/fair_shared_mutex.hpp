@@ -78,6 +78,11 @@ struct PhaseFairness {
  *
  * - yamc::fair::basic_shared_mutex<RwLockFairness>
  * - yamc::fair::basic_shared_timed_mutex<RwLockFairness>
+ *
+ * Upgrade-lock is shared-lock with exclusive "upgrader" ownership, which is acquired
+ * before queuing shared-lock request. unlock_upgrade_and_lock() enqueues exclusive-lock
+ * node to block subsequent requests, and takes over 'locked' node when it becomes
+ * the only shared-lock owner.
  */
 namespace fair {
 
@@ -99,10 +104,18 @@ protected:
     node* prev;
   };
 
+  // queue node of waiting thread, which is notified directly when it becomes lockable
+  struct waiter : node {
+    std::condition_variable cv;
+    explicit waiter(std::size_t s) : node{s, nullptr, nullptr} {}
+  };
+
   node queue_;   // q.next = front(), q.prev = back()
   node locked_;  // placeholder node of 'locked' state
-  std::condition_variable cv_;
   std::mutex mtx_;
+  bool upgrader_ = false;          // upgrade-lock is owned (or requested)
+  waiter* upgrading_ = nullptr;    // request of unlock_upgrade_and_lock()
+  std::condition_variable ucv_;    // wait for upgrader ownership
 
 private:
 #if YAMC_DEBUG_TRACING
@@ -193,6 +206,26 @@ private:
     locked_.next = locked_.prev = nullptr;
   }
 
+  static void wq_notify(node* p)
+  {
+    static_cast<waiter*>(p)->cv.notify_one();
+  }
+
+  void wq_notify_lockable()
+  {
+    // wake up exclusive-lock node at front, or leading 'lockable' shared-lock nodes group
+    assert(queue_.next != &locked_);
+    node* p = queue_.next;
+    if (p != &queue_ && (p->status & node_status_mask) == 0) {
+      wq_notify(p);
+      return;
+    }
+    while (p != &queue_ && (p->status & node_status_mask) == 3) {
+      wq_notify(p);
+      p = p->next;
+    }
+  }
+
 protected:
   shared_mutex_base()
     : queue_{0, &queue_, &queue_} {}
@@ -202,11 +235,11 @@ protected:
   {
     YAMC_DEBUG_DUMPQ(">>lock");
     if (!wq_empty()) {
-      node request = {0, 0, 0};  // exclusive-lock
+      waiter request{0};  // exclusive-lock
       wq_push_back(&request);
       YAMC_DEBUG_DUMPQ("  lock/wait", &request, +1);
       while (queue_.next != &request) {
-        cv_.wait(lk);
+        request.cv.wait(lk);
       }
       YAMC_DEBUG_DUMPQ("  lock/enter", &request, -1);
       wq_erase(&request);
@@ -266,8 +299,8 @@ protected:
           p = p->next;
         }
       }
+      wq_notify_lockable();
     }
-    cv_.notify_all();
     YAMC_DEBUG_DUMPQ("<<unlock");
   }
 
@@ -276,11 +309,11 @@ protected:
   {
     YAMC_DEBUG_DUMPQ(">>try_lockwait");
     if (!wq_empty()) {
-      node request = {0, 0, 0};  // exclusive-lock
+      waiter request{0};  // exclusive-lock
       wq_push_back(&request);
       YAMC_DEBUG_DUMPQ("  try_lockwait/wait", &request, +1);
       while (queue_.next != &request) {
-        if (cv_.wait_until(lk, tp) == std::cv_status::timeout) {
+        if (request.cv.wait_until(lk, tp) == std::cv_status::timeout) {
           if (queue_.next == &request)  // re-check predicate
             break;
           if ((request.prev->status & node_status_mask) == 3) {
@@ -291,9 +324,9 @@ protected:
             node* p = request.next;
             while (p != &queue_ && (p->status & node_status_mask) == 1) {
               p->status |= 2;
+              wq_notify(p);
               p = p->next;
             }
-            cv_.notify_all();
           }
           YAMC_DEBUG_DUMPQ("<<try_lockwait/timeout", &request, -1);
           wq_erase(&request);
@@ -312,11 +345,11 @@ protected:
   {
     YAMC_DEBUG_DUMPQ(">>lock_shared");
     if (!wq_shared_lockable()) {
-      node request = {1, 0, 0};  // shared-lock
+      waiter request{1};  // shared-lock
       wq_push_back(&request);
       YAMC_DEBUG_DUMPQ("  lock_shared/wait", &request, +1);
       while (request.status != 3) {
-        cv_.wait(lk);
+        request.cv.wait(lk);
       }
       YAMC_DEBUG_DUMPQ("  lock_shared/enter", &request, -1);
       wq_erase(&request);
@@ -346,21 +379,79 @@ protected:
     if (locked_.status < node_nthread_inc) {
       // all current shared-locks was unlocked
       wq_pop_locknode();
-      cv_.notify_all();
+      wq_notify_lockable();
+    } else if (upgrading_ && locked_.status < 2 * node_nthread_inc) {
+      // upgrader is the only shared-lock owner
+      wq_notify(upgrading_);
     }
     YAMC_DEBUG_DUMPQ("<<unlock_shared");
   }
 
+  void impl_lock_upgrade(std::unique_lock<std::mutex>& lk)
+  {
+    while (upgrader_) {
+      ucv_.wait(lk);
+    }
+    upgrader_ = true;
+    impl_lock_shared(lk);
+  }
+
+  bool impl_try_lock_upgrade()
+  {
+    if (upgrader_ || !impl_try_lock_shared())
+      return false;
+    upgrader_ = true;
+    return true;
+  }
+
+  void impl_unlock_upgrade()
+  {
+    assert(upgrader_);
+    impl_unlock_shared();
+    upgrader_ = false;
+    ucv_.notify_one();
+  }
+
+  void impl_unlock_upgrade_and_lock(std::unique_lock<std::mutex>& lk)
+  {
+    YAMC_DEBUG_DUMPQ(">>unlock_upgrade_and_lock", &locked_, -1);
+    assert(upgrader_ && queue_.next == &locked_ && (locked_.status & node_status_mask) == 3);
+    if (locked_.status >= 2 * node_nthread_inc) {
+      waiter request{0};  // exclusive-lock, block subsequent shared-lock requests
+      wq_push_back(&request);
+      upgrading_ = &request;
+      YAMC_DEBUG_DUMPQ("  unlock_upgrade_and_lock/wait", &request, +1);
+      while (locked_.status >= 2 * node_nthread_inc) {
+        request.cv.wait(lk);
+      }
+      YAMC_DEBUG_DUMPQ("  unlock_upgrade_and_lock/enter", &request, -1);
+      upgrading_ = nullptr;
+      wq_erase(&request);
+    }
+    // take over 'locked' node as exclusive-lock
+    locked_.status = 2 + node_nthread_inc;
+    upgrader_ = false;
+    ucv_.notify_one();
+    YAMC_DEBUG_DUMPQ("<<unlock_upgrade_and_lock", &locked_, +1);
+  }
+
+  void impl_unlock_upgrade_and_lock_shared()
+  {
+    assert(upgrader_);
+    upgrader_ = false;
+    ucv_.notify_one();
+  }
+
   template<typename Clock, typename Duration>
   bool impl_try_lockwait_shared(std::unique_lock<std::mutex>& lk, const std::chrono::time_point<Clock, Duration>& tp)
   {
     YAMC_DEBUG_DUMPQ(">>try_lockwait_shared");
     if (!wq_shared_lockable()) {
-      node request = {1, 0, 0};  // shared-lock
+      waiter request{1};  // shared-lock
       wq_push_back(&request);
       YAMC_DEBUG_DUMPQ("  try_lockwait_shared/wait", &request, +1);
       while (request.status != 3) {
-        if (cv_.wait_until(lk, tp) == std::cv_status::timeout) {
+        if (request.cv.wait_until(lk, tp) == std::cv_status::timeout) {
           if (request.status == 3)  // re-check predicate
             break;
           YAMC_DEBUG_DUMPQ("<<try_lockwait_shared/timeout", &request, -1);
@@ -427,6 +518,36 @@ public:
     std::lock_guard<decltype(mtx_)> lk(mtx_);
     base::impl_unlock_shared();
   }
+
+  void lock_upgrade()
+  {
+    std::unique_lock<decltype(mtx_)> lk(mtx_);
+    base::impl_lock_upgrade(lk);
+  }
+
+  bool try_lock_upgrade()
+  {
+    std::lock_guard<decltype(mtx_)> lk(mtx_);
+    return base::impl_try_lock_upgrade();
+  }
+
+  void unlock_upgrade()
+  {
+    std::lock_guard<decltype(mtx_)> lk(mtx_);
+    base::impl_unlock_upgrade();
+  }
+
+  void unlock_upgrade_and_lock()
+  {
+    std::unique_lock<decltype(mtx_)> lk(mtx_);
+    base::impl_unlock_upgrade_and_lock(lk);
+  }
+
+  void unlock_upgrade_and_lock_shared()
+  {
+    std::lock_guard<decltype(mtx_)> lk(mtx_);
+    base::impl_unlock_upgrade_and_lock_shared();
+  }
 };
 
 using shared_mutex = basic_shared_mutex<YAMC_RWLOCK_FAIRNESS_DEFAULT>;
@@ -495,6 +616,36 @@ public:
     base::impl_unlock_shared();
   }
 
+  void lock_upgrade()
+  {
+    std::unique_lock<decltype(mtx_)> lk(mtx_);
+    base::impl_lock_upgrade(lk);
+  }
+
+  bool try_lock_upgrade()
+  {
+    std::lock_guard<decltype(mtx_)> lk(mtx_);
+    return base::impl_try_lock_upgrade();
+  }
+
+  void unlock_upgrade()
+  {
+    std::lock_guard<decltype(mtx_)> lk(mtx_);
+    base::impl_unlock_upgrade();
+  }
+
+  void unlock_upgrade_and_lock()
+  {
+    std::unique_lock<decltype(mtx_)> lk(mtx_);
+    base::impl_unlock_upgrade_and_lock(lk);
+  }
+
+  void unlock_upgrade_and_lock_shared()
+  {
+    std::lock_guard<decltype(mtx_)> lk(mtx_);
+    base::impl_unlock_upgrade_and_lock_shared();
+  }
+
   template<typename Rep, typename Period>
   bool try_lock_shared_for(const std::chrono::duration<Rep, Period>& duration)
   {
@@ -0,0 +1,179 @@
+/*
+ * futex_mutex.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2019 yohhoy
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef YAMC_FUTEX_MUTEX_HPP_
+#define YAMC_FUTEX_MUTEX_HPP_
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include "yamc_atomic_wait.hpp"
+#include "yamc_backoff_spin.hpp"
+
+
+/// maximum spin count of yamc::futex::adaptive_mutex
+#ifndef YAMC_ADAPTIVE_SPIN_MAXCOUNT
+#define YAMC_ADAPTIVE_SPIN_MAXCOUNT 100
+#endif
+
+
+namespace yamc {
+
+/*
+ * mutex which waits on its lock word directly
+ *
+ * - yamc::futex::mutex
+ * - yamc::futex::adaptive_mutex
+ *
+ * The lock word has three states: 0=unlocked, 1=locked, 2=locked with (possible) waiters.
+ * Uncontended lock()/unlock() need no system call, and waiting thread is parked with
+ *   - futex(2) on Linux
+ *   - WaitOnAddress/WakeByAddressSingle on Windows
+ *   - __ulock_wait/__ulock_wake on macOS
+ * If none of them is available (YAMC_FUTEX_SUPPORTED=0), waiting thread just yields.
+ *
+ * adaptive_mutex spins for a while before parking like PTHREAD_MUTEX_ADAPTIVE_NP of glibc.
+ * Its spin count (up to YAMC_ADAPTIVE_SPIN_MAXCOUNT) follows moving average of
+ * recent spin counts which were needed to acquire lock.
+ *
+ * U. Drepper, "Futexes Are Tricky", 2011.
+ */
+namespace futex {
+
+namespace detail {
+
+/// block current thread while (word == expected)
+inline void wait(std::atomic<std::uint32_t>& word, std::uint32_t expected)
+{
+  yamc::detail::futex_wait(&word, expected);
+  // spurious wakeup may happen, caller should re-check word value
+}
+
+/// wake up one thread blocked on word
+inline void wake_one(std::atomic<std::uint32_t>& word)
+{
+  yamc::detail::futex_wake_one(&word);
+}
+
+
+/// acquire 3-state lock word, c denotes the last observed value
+inline void lock_contended(std::atomic<std::uint32_t>& word, std::uint32_t c)
+{
+  // mark contended, then park until lock is released
+  if (c != 2)
+    c = word.exchange(2, std::memory_order_acquire);
+  while (c != 0) {
+    wait(word, 2);
+    c = word.exchange(2, std::memory_order_acquire);
+  }
+}
+
+} // namespace detail
+
+
+class mutex {
+  std::atomic<std::uint32_t> state_{0};
+
+public:
+  constexpr mutex() noexcept = default;
+  ~mutex() = default;
+
+  mutex(const mutex&) = delete;
+  mutex& operator=(const mutex&) = delete;
+
+  void lock()
+  {
+    std::uint32_t c = 0;
+    if (state_.compare_exchange_strong(c, 1, std::memory_order_acquire, std::memory_order_relaxed))
+      return;
+    detail::lock_contended(state_, c);
+  }
+
+  bool try_lock()
+  {
+    std::uint32_t c = 0;
+    return state_.compare_exchange_strong(c, 1, std::memory_order_acquire, std::memory_order_relaxed);
+  }
+
+  void unlock()
+  {
+    if (state_.exchange(0, std::memory_order_release) == 2)
+      detail::wake_one(state_);
+  }
+};
+
+
+
+class adaptive_mutex {
+  std::atomic<std::uint32_t> state_{0};
+  std::atomic<int> spins_{0};
+
+public:
+  constexpr adaptive_mutex() noexcept = default;
+  ~adaptive_mutex() = default;
+
+  adaptive_mutex(const adaptive_mutex&) = delete;
+  adaptive_mutex& operator=(const adaptive_mutex&) = delete;
+
+  void lock()
+  {
+    std::uint32_t c = 0;
+    if (state_.compare_exchange_strong(c, 1, std::memory_order_acquire, std::memory_order_relaxed))
+      return;
+    const int spins = spins_.load(std::memory_order_relaxed);
+    const int maxcnt = (std::min)(static_cast<int>(YAMC_ADAPTIVE_SPIN_MAXCOUNT), spins * 2 + 10);
+    int cnt = 0;
+    for (;;) {
+      if (maxcnt <= cnt++) {
+        detail::lock_contended(state_, c);
+        break;
+      }
+      yamc::backoff::cpu_relax();
+      c = state_.load(std::memory_order_relaxed);
+      if (c == 0 && state_.compare_exchange_weak(c, 1, std::memory_order_acquire, std::memory_order_relaxed))
+        break;
+    }
+    // update moving average of spin count (under lock)
+    spins_.store(spins + (cnt - spins) / 8, std::memory_order_relaxed);
+  }
+
+  bool try_lock()
+  {
+    std::uint32_t c = 0;
+    return state_.compare_exchange_strong(c, 1, std::memory_order_acquire, std::memory_order_relaxed);
+  }
+
+  void unlock()
+  {
+    if (state_.exchange(0, std::memory_order_release) == 2)
+      detail::wake_one(state_);
+  }
+};
+
+} // namespace futex
+} // namespace yamc
+
+#endif
@@ -45,6 +45,9 @@ namespace yamc {
  * - yamc::gcd::binary_semaphore
  *
  * This implementation use dispatch semaphore of GCD runtime.
+ * Dispatch semaphore has no multi-permit wait operation, so multi-permit acquire(n) and
+ * try_acquire_*(n, ...) are not provided; permit-by-permit emulation can't keep large
+ * request from starvation by single-permit acquirers. Use yamc::counting_semaphore.
  * https://developer.apple.com/documentation/dispatch/dispatchsemaphore
  */
 namespace gcd {
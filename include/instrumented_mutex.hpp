@@ -0,0 +1,551 @@
+/*
+ * instrumented_mutex.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2019 yohhoy
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef YAMC_INSTRUMENTED_MUTEX_HPP_
+#define YAMC_INSTRUMENTED_MUTEX_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+#include "yamc_config.hpp"
+#include "yamc_thread_hint.hpp"
+
+
+/// number of per-thread counter shards of each instrumented mutex
+#ifndef YAMC_INSTRUMENT_SHARDS
+#define YAMC_INSTRUMENT_SHARDS 16
+#endif
+
+/// number of log2-bucketed histogram bins
+#ifndef YAMC_INSTRUMENT_BUCKETS
+#define YAMC_INSTRUMENT_BUCKETS 32
+#endif
+
+/// wait time (in ticks) from which an acquisition is counted as contended
+#ifndef YAMC_INSTRUMENT_CONTENDED_TICKS
+#define YAMC_INSTRUMENT_CONTENDED_TICKS 4096
+#endif
+
+/// number of shared-locks per thread whose hold time is tracked at once
+#ifndef YAMC_INSTRUMENT_SHARED_HOLDS
+#define YAMC_INSTRUMENT_SHARED_HOLDS 8
+#endif
+
+
+namespace yamc {
+
+/*
+ * contention profiling for mutex
+ *
+ * - yamc::instrumented<Mutex>
+ * - yamc::instrument::stats
+ * - yamc::instrument::registry
+ *
+ * instrumented<Mutex> wraps any mutex/shared mutex type, and records acquisition count,
+ * contended acquisition count, histograms of wait time, exclusive-lock hold time and
+ * shared-lock hold time. Lock operation is timed directly without extra try_lock, and
+ * the acquisition is counted as contended when it waits YAMC_INSTRUMENT_CONTENDED_TICKS
+ * or more. Hold time of recursive lock is measured from outermost lock to its unlock,
+ * shared-lock hold time is tracked for up to YAMC_INSTRUMENT_SHARED_HOLDS locks per thread.
+ * Time is measured in ticks of instrument::tick(); TSC on x86, virtual counter on AArch64,
+ * or std::chrono::steady_clock in nanoseconds. Histogram bin k counts [2^(k-1), 2^k) ticks.
+ * Counters are sharded by thread and updated with relaxed atomic operations, each shard is
+ * allocated on first use by some thread so that idle mutex stays small.
+ * Every instrumented mutex is listed in registry, which can dump all stats as text or JSON.
+ */
+namespace instrument {
+
+inline std::uint64_t tick()
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  return __rdtsc();
+#elif defined(__x86_64__) || defined(__i386__)
+  return __rdtsc();
+#elif defined(__aarch64__)
+  std::uint64_t v;
+  asm volatile("mrs %0, cntvct_el0" : "=r"(v));
+  return v;
+#else
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+inline const char* tick_unit()
+{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+  return "tsc";
+#elif defined(__x86_64__) || defined(__i386__)
+  return "tsc";
+#elif defined(__aarch64__)
+  return "cntvct";
+#else
+  return "ns";
+#endif
+}
+
+struct summary {
+  std::string name;
+  std::uint64_t acquisitions;
+  std::uint64_t contended;
+  std::uint64_t wait_hist[YAMC_INSTRUMENT_BUCKETS];
+  std::uint64_t hold_hist[YAMC_INSTRUMENT_BUCKETS];
+  std::uint64_t shared_hold_hist[YAMC_INSTRUMENT_BUCKETS];
+};
+
+
+class stats;
+
+class registry {
+  struct table_ref {
+    std::unique_lock<std::mutex> lk;
+    std::vector<const stats*>& entries;
+  };
+
+  static table_ref global_table()
+  {
+    static std::mutex global_guard;
+    static std::vector<const stats*> global_entries;
+    return { std::unique_lock<std::mutex>(global_guard), global_entries };
+  }
+
+  static void write_json_string(std::ostream& os, const std::string& s)
+  {
+    os << '"';
+    for (char c : s) {
+      if (c == '"' || c == '\\')
+        os << '\\' << c;
+      else if (static_cast<unsigned char>(c) < 0x20)
+        os << ' ';
+      else
+        os << c;
+    }
+    os << '"';
+  }
+
+  static void write_hist_text(std::ostream& os, const char* label, const std::uint64_t (&hist)[YAMC_INSTRUMENT_BUCKETS])
+  {
+    os << "  " << label << ":";
+    for (std::size_t k = 0; k < YAMC_INSTRUMENT_BUCKETS; k++) {
+      if (hist[k])
+        os << ' ' << k << ':' << hist[k];
+    }
+    os << '\n';
+  }
+
+  static void write_hist_json(std::ostream& os, const std::uint64_t (&hist)[YAMC_INSTRUMENT_BUCKETS])
+  {
+    os << '[';
+    for (std::size_t k = 0; k < YAMC_INSTRUMENT_BUCKETS; k++) {
+      os << (k ? "," : "") << hist[k];
+    }
+    os << ']';
+  }
+
+  friend class stats;
+  static void add(const stats* p)
+  {
+    auto&& table = global_table();
+    table.entries.push_back(p);
+  }
+
+  static void remove(const stats* p)
+  {
+    auto&& table = global_table();
+    for (auto itr = table.entries.begin(); itr != table.entries.end(); ++itr) {
+      if (*itr == p) {
+        table.entries.erase(itr);
+        break;
+      }
+    }
+  }
+
+public:
+  /// snapshot of all instrumented mutexes
+  static std::vector<summary> collect();
+
+  static void dump_text(std::ostream& os)
+  {
+    os << "# yamc::instrumented unit=" << tick_unit() << " bin=log2\n";
+    for (const auto& s : collect()) {
+      os << (s.name.empty() ? "(unnamed)" : s.name.c_str())
+         << " acquisitions=" << s.acquisitions << " contended=" << s.contended << '\n';
+      write_hist_text(os, "wait", s.wait_hist);
+      write_hist_text(os, "hold", s.hold_hist);
+      write_hist_text(os, "shared_hold", s.shared_hold_hist);
+    }
+    os.flush();
+  }
+
+  static void dump_json(std::ostream& os)
+  {
+    os << "{\"unit\":\"" << tick_unit() << "\",\"mutexes\":[";
+    int i = 0;
+    for (const auto& s : collect()) {
+      os << (i++ ? "," : "") << "{\"name\":";
+      write_json_string(os, s.name);
+      os << ",\"acquisitions\":" << s.acquisitions << ",\"contended\":" << s.contended << ",\"wait_hist\":";
+      write_hist_json(os, s.wait_hist);
+      os << ",\"hold_hist\":";
+      write_hist_json(os, s.hold_hist);
+      os << ",\"shared_hold_hist\":";
+      write_hist_json(os, s.shared_hold_hist);
+      os << '}';
+    }
+    os << "]}" << std::endl;
+  }
+};
+
+
+class stats {
+  // (each shard is separate heap object of several cache lines)
+  struct alignas(YAMC_CACHELINE_SIZE) shard : yamc::detail::cacheline_aligned_new {
+    std::atomic<std::uint64_t> acquisitions;
+    std::atomic<std::uint64_t> contended;
+    std::atomic<std::uint64_t> wait_hist[YAMC_INSTRUMENT_BUCKETS];
+    std::atomic<std::uint64_t> hold_hist[YAMC_INSTRUMENT_BUCKETS];
+    std::atomic<std::uint64_t> shared_hold_hist[YAMC_INSTRUMENT_BUCKETS];
+  };
+
+  std::string name_;
+  std::atomic<shard*> shards_[YAMC_INSTRUMENT_SHARDS];
+
+  static std::size_t bucket(std::uint64_t v)
+  {
+    // 0 -> 0, [2^(k-1), 2^k) -> k
+    std::size_t k = 0;
+#if defined(__GNUC__) || defined(__clang__)
+    k = v ? 64 - __builtin_clzll(v) : 0;
+#else
+    while (v) {
+      ++k;
+      v >>= 1;
+    }
+#endif
+    return (k < YAMC_INSTRUMENT_BUCKETS) ? k : YAMC_INSTRUMENT_BUCKETS - 1;
+  }
+
+  static void clear(shard& s)
+  {
+    s.acquisitions.store(0, std::memory_order_relaxed);
+    s.contended.store(0, std::memory_order_relaxed);
+    for (auto& e : s.wait_hist) { e.store(0, std::memory_order_relaxed); }
+    for (auto& e : s.hold_hist) { e.store(0, std::memory_order_relaxed); }
+    for (auto& e : s.shared_hold_hist) { e.store(0, std::memory_order_relaxed); }
+  }
+
+  shard& current_shard()
+  {
+    const std::size_t idx = yamc::detail::this_thread_slot_hint() % YAMC_INSTRUMENT_SHARDS;
+    shard* p = shards_[idx].load(std::memory_order_acquire);
+    if (p == nullptr) {
+      // first use of this shard
+      shard* q = new shard;
+      clear(*q);
+      if (shards_[idx].compare_exchange_strong(p, q, std::memory_order_acq_rel, std::memory_order_acquire)) {
+        p = q;
+      } else {
+        delete q;
+      }
+    }
+    return *p;
+  }
+
+public:
+  explicit stats(const char* name = nullptr)
+    : name_(name ? name : "")
+  {
+    for (auto& p : shards_) {
+      p.store(nullptr, std::memory_order_relaxed);
+    }
+    registry::add(this);
+  }
+
+  ~stats()
+  {
+    registry::remove(this);
+    for (auto& p : shards_) {
+      delete p.load(std::memory_order_relaxed);
+    }
+  }
+
+  stats(const stats&) = delete;
+  stats& operator=(const stats&) = delete;
+
+  void acquired(std::uint64_t wait, bool contended)
+  {
+    shard& s = current_shard();
+    s.acquisitions.fetch_add(1, std::memory_order_relaxed);
+    if (contended)
+      s.contended.fetch_add(1, std::memory_order_relaxed);
+    s.wait_hist[bucket(wait)].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void released(std::uint64_t hold)
+  {
+    current_shard().hold_hist[bucket(hold)].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void shared_released(std::uint64_t hold)
+  {
+    current_shard().shared_hold_hist[bucket(hold)].fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void reset()
+  {
+    for (auto& p : shards_) {
+      if (shard* s = p.load(std::memory_order_acquire))
+        clear(*s);
+    }
+  }
+
+  summary snapshot() const
+  {
+    summary r = { name_, 0, 0, {}, {}, {} };
+    for (auto& p : shards_) {
+      const shard* s = p.load(std::memory_order_acquire);
+      if (s == nullptr)
+        continue;
+      r.acquisitions += s->acquisitions.load(std::memory_order_relaxed);
+      r.contended += s->contended.load(std::memory_order_relaxed);
+      for (std::size_t k = 0; k < YAMC_INSTRUMENT_BUCKETS; k++) {
+        r.wait_hist[k] += s->wait_hist[k].load(std::memory_order_relaxed);
+        r.hold_hist[k] += s->hold_hist[k].load(std::memory_order_relaxed);
+        r.shared_hold_hist[k] += s->shared_hold_hist[k].load(std::memory_order_relaxed);
+      }
+    }
+    return r;
+  }
+};
+
+
+inline std::vector<summary> registry::collect()
+{
+  auto&& table = global_table();
+  std::vector<summary> result;
+  result.reserve(table.entries.size());
+  for (const stats* p : table.entries) {
+    result.push_back(p->snapshot());
+  }
+  return result;
+}
+
+
+// shared-lock hold start of current thread
+class shared_holds {
+  struct entry {
+    const void* mtx;
+    std::uint64_t start;
+  };
+
+  static entry* table()
+  {
+    static thread_local entry tbl[YAMC_INSTRUMENT_SHARED_HOLDS] = {};
+    return tbl;
+  }
+
+public:
+  static void push(const void* mtx, std::uint64_t start)
+  {
+    entry* tbl = table();
+    for (std::size_t i = 0; i < YAMC_INSTRUMENT_SHARED_HOLDS; i++) {
+      if (tbl[i].mtx == nullptr) {
+        tbl[i].mtx = mtx;
+        tbl[i].start = start;
+        return;
+      }
+    }
+    // too many shared-locks, hold time is not tracked
+  }
+
+  /// return false if not tracked
+  static bool pop(const void* mtx, std::uint64_t& start)
+  {
+    entry* tbl = table();
+    for (std::size_t i = YAMC_INSTRUMENT_SHARED_HOLDS; 0 < i--; ) {
+      if (tbl[i].mtx == mtx) {
+        tbl[i].mtx = nullptr;
+        start = tbl[i].start;
+        return true;
+      }
+    }
+    return false;
+  }
+};
+
+} // namespace instrument
+
+
+template <typename Mutex>
+class instrumented {
+  Mutex mtx_;
+  std::uint64_t hold_start_ = 0;  // modified by lock owner
+  std::size_t depth_ = 0;         // recursion depth, modified by lock owner
+  instrument::stats stats_;
+
+  static std::uint64_t waited(std::uint64_t t0, std::uint64_t t1, bool& contended)
+  {
+    const std::uint64_t wait = t1 - t0;
+    contended = (YAMC_INSTRUMENT_CONTENDED_TICKS <= wait);
+    return wait;
+  }
+
+  void acquired(std::uint64_t t0)
+  {
+    const std::uint64_t t1 = instrument::tick();
+    bool contended;
+    const std::uint64_t wait = waited(t0, t1, contended);
+    stats_.acquired(wait, contended);
+    if (depth_++ == 0)
+      hold_start_ = t1;
+  }
+
+  void shared_acquired(std::uint64_t t0)
+  {
+    const std::uint64_t t1 = instrument::tick();
+    bool contended;
+    const std::uint64_t wait = waited(t0, t1, contended);
+    stats_.acquired(wait, contended);
+    instrument::shared_holds::push(this, t1);
+  }
+
+public:
+  using mutex_type = Mutex;
+
+  explicit instrumented(const char* name = nullptr)
+    : stats_(name) {}
+  ~instrumented() = default;
+
+  instrumented(const instrumented&) = delete;
+  instrumented& operator=(const instrumented&) = delete;
+
+  void lock()
+  {
+    const std::uint64_t t0 = instrument::tick();
+    mtx_.lock();
+    acquired(t0);
+  }
+
+  bool try_lock()
+  {
+    const std::uint64_t t0 = instrument::tick();
+    if (!mtx_.try_lock())
+      return false;
+    acquired(t0);
+    return true;
+  }
+
+  void unlock()
+  {
+    if (--depth_ == 0)
+      stats_.released(instrument::tick() - hold_start_);
+    mtx_.unlock();
+  }
+
+  template<typename Rep, typename Period>
+  bool try_lock_for(const std::chrono::duration<Rep, Period>& duration)
+  {
+    const std::uint64_t t0 = instrument::tick();
+    if (!mtx_.try_lock_for(duration))
+      return false;
+    acquired(t0);
+    return true;
+  }
+
+  template<typename Clock, typename Duration>
+  bool try_lock_until(const std::chrono::time_point<Clock, Duration>& tp)
+  {
+    const std::uint64_t t0 = instrument::tick();
+    if (!mtx_.try_lock_until(tp))
+      return false;
+    acquired(t0);
+    return true;
+  }
+
+  void lock_shared()
+  {
+    const std::uint64_t t0 = instrument::tick();
+    mtx_.lock_shared();
+    shared_acquired(t0);
+  }
+
+  bool try_lock_shared()
+  {
+    const std::uint64_t t0 = instrument::tick();
+    if (!mtx_.try_lock_shared())
+      return false;
+    shared_acquired(t0);
+    return true;
+  }
+
+  void unlock_shared()
+  {
+    std::uint64_t start;
+    if (instrument::shared_holds::pop(this, start))
+      stats_.shared_released(instrument::tick() - start);
+    mtx_.unlock_shared();
+  }
+
+  template<typename Rep, typename Period>
+  bool try_lock_shared_for(const std::chrono::duration<Rep, Period>& duration)
+  {
+    return try_lock_shared_until(std::chrono::steady_clock::now() + duration);
+  }
+
+  template<typename Clock, typename Duration>
+  bool try_lock_shared_until(const std::chrono::time_point<Clock, Duration>& tp)
+  {
+    const std::uint64_t t0 = instrument::tick();
+    if (!mtx_.try_lock_shared_until(tp))
+      return false;
+    shared_acquired(t0);
+    return true;
+  }
+
+  /// statistics of this mutex
+  instrument::summary stats() const
+  {
+    return stats_.snapshot();
+  }
+
+  void reset_stats()
+  {
+    stats_.reset();
+  }
+};
+
+} // namespace yamc
+
+#endif
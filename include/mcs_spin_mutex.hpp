@@ -0,0 +1,143 @@
+/*
+ * mcs_spin_mutex.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2019 yohhoy
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef YAMC_MCS_SPIN_MUTEX_HPP_
+#define YAMC_MCS_SPIN_MUTEX_HPP_
+
+#include <atomic>
+#include "yamc_backoff_spin.hpp"
+
+
+namespace yamc {
+
+/*
+ * MCS queue spinlock implementation
+ *
+ * - yamc::spin_mcs::mutex
+ * - yamc::spin_mcs::basic_mutex<BackoffPolicy>
+ *
+ * Each waiting thread spins on its own queue node, and the lock is handed off in FIFO order.
+ * This implementation use "K42" variant of MCS lock, the queue node of waiting thread is
+ * allocated on its stack and lock owner need no node, so that it has the standard
+ * lock()/try_lock()/unlock() interface which satisfy Lockable requirements.
+ *
+ * J. M. Mellor-Crummey, M. L. Scott,
+ * "Algorithms for Scalable Synchronization on Shared-Memory Multiprocessors",
+ * ACM Transactions on Computer Systems, 1991.
+ */
+namespace spin_mcs {
+
+template <typename BackoffPolicy>
+class basic_mutex {
+  struct node {
+    std::atomic<node*> tail;  // waiting flag (queue node) / tail of queue (mutex)
+    std::atomic<node*> next;
+  };
+
+  // q.tail := {nullptr=unlocked, &q=locked without waiter, otherwise=last waiter}
+  // q.next := first waiter
+  node q_{{nullptr}, {nullptr}};
+
+  node* waiting()
+  {
+    // unique non-null address as 'waiting' flag of queue node
+    return &q_;
+  }
+
+public:
+  constexpr basic_mutex() noexcept = default;
+  ~basic_mutex() = default;
+
+  basic_mutex(const basic_mutex&) = delete;
+  basic_mutex& operator=(const basic_mutex&) = delete;
+
+  void lock()
+  {
+    for (;;) {
+      node* prev = q_.tail.load(std::memory_order_relaxed);
+      if (prev == nullptr) {
+        // lock appears free
+        if (q_.tail.compare_exchange_weak(prev, &q_, std::memory_order_acquire, std::memory_order_relaxed))
+          return;
+      } else {
+        node n{{waiting()}, {nullptr}};
+        if (q_.tail.compare_exchange_weak(prev, &n, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+          // enqueue myself, then spin on my own node
+          prev->next.store(&n, std::memory_order_release);
+          typename BackoffPolicy::state state;
+          while (n.tail.load(std::memory_order_acquire) != nullptr) {
+            BackoffPolicy::wait(state);
+          }
+          // acquired lock, move the successor link from my node to mutex
+          node* succ = n.next.load(std::memory_order_acquire);
+          if (succ == nullptr) {
+            q_.next.store(nullptr, std::memory_order_relaxed);
+            node* expected = &n;
+            if (!q_.tail.compare_exchange_strong(expected, &q_, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+              // other thread is enqueuing after my node
+              while ((succ = n.next.load(std::memory_order_acquire)) == nullptr) {
+                BackoffPolicy::wait(state);
+              }
+              q_.next.store(succ, std::memory_order_relaxed);
+            }
+          } else {
+            q_.next.store(succ, std::memory_order_relaxed);
+          }
+          return;
+        }
+      }
+    }
+  }
+
+  bool try_lock()
+  {
+    node* expected = nullptr;
+    return q_.tail.compare_exchange_strong(expected, &q_, std::memory_order_acquire, std::memory_order_relaxed);
+  }
+
+  void unlock()
+  {
+    node* succ = q_.next.load(std::memory_order_acquire);
+    if (succ == nullptr) {
+      node* expected = &q_;
+      if (q_.tail.compare_exchange_strong(expected, nullptr, std::memory_order_release, std::memory_order_relaxed))
+        return;
+      // wait for a new waiter to link its node
+      typename BackoffPolicy::state state;
+      while ((succ = q_.next.load(std::memory_order_acquire)) == nullptr) {
+        BackoffPolicy::wait(state);
+      }
+    }
+    // handoff lock to the first waiter
+    succ->tail.store(nullptr, std::memory_order_release);
+  }
+};
+
+using mutex = basic_mutex<YAMC_BACKOFF_SPIN_DEFAULT>;
+
+} // namespace spin_mcs
+} // namespace yamc
+
+#endif
@@ -27,6 +27,7 @@
 #define YAMC_NAIVE_SPIN_MUTEX_HPP_
 
 #include <atomic>
+#include <chrono>
 #include "yamc_backoff_spin.hpp"
 
 
@@ -36,29 +37,49 @@ namespace yamc {
  * naive Test-And-Swap(TAS) spinlock implementation (with memory_order_seq_cst)
  *
  * - yamc::spin::mutex
+ * - yamc::spin::timed_mutex
  * - yamc::spin::basic_mutex<BackoffPolicy>
+ * - yamc::spin::basic_timed_mutex<BackoffPolicy>
+ *
+ * basic_timed_mutex spins on basic_mutex and reads clock at adaptive interval while spinning
+ * (see yamc::backoff::deadline).
  */
 namespace spin {
 
+template <typename BackoffPolicy>
+class basic_timed_mutex;
+
 template <typename BackoffPolicy>
 class basic_mutex {
   std::atomic<int> state_{0};
 
-public:
-  basic_mutex() = default;
-  ~basic_mutex() = default;
+  friend class basic_timed_mutex<BackoffPolicy>;
 
-  basic_mutex(const basic_mutex&) = delete;
-  basic_mutex& operator=(const basic_mutex&) = delete;
-
-  void lock()
+  template <typename Deadline>
+  bool acquire(Deadline& dl)
   {
     typename BackoffPolicy::state state;
     int expected = 0;
     while (!state_.compare_exchange_weak(expected, 1)) {
+      if (dl.expired())
+        return false;
       BackoffPolicy::wait(state);
       expected = 0;
     }
+    return true;
+  }
+
+public:
+  constexpr basic_mutex() noexcept = default;
+  ~basic_mutex() = default;
+
+  basic_mutex(const basic_mutex&) = delete;
+  basic_mutex& operator=(const basic_mutex&) = delete;
+
+  void lock()
+  {
+    backoff::detail::no_deadline dl;
+    acquire(dl);
   }
 
   bool try_lock()
@@ -73,7 +94,50 @@ public:
   }
 };
 
+
+template <typename BackoffPolicy>
+class basic_timed_mutex {
+  basic_mutex<BackoffPolicy> mtx_;
+
+public:
+  constexpr basic_timed_mutex() noexcept = default;
+  ~basic_timed_mutex() = default;
+
+  basic_timed_mutex(const basic_timed_mutex&) = delete;
+  basic_timed_mutex& operator=(const basic_timed_mutex&) = delete;
+
+  void lock()
+  {
+    mtx_.lock();
+  }
+
+  bool try_lock()
+  {
+    return mtx_.try_lock();
+  }
+
+  void unlock()
+  {
+    mtx_.unlock();
+  }
+
+  template<typename Rep, typename Period>
+  bool try_lock_for(const std::chrono::duration<Rep, Period>& duration)
+  {
+    const auto tp = std::chrono::steady_clock::now() + duration;
+    return try_lock_until(tp);
+  }
+
+  template<typename Clock, typename Duration>
+  bool try_lock_until(const std::chrono::time_point<Clock, Duration>& tp)
+  {
+    backoff::deadline<Clock, Duration> dl(tp);
+    return mtx_.acquire(dl);
+  }
+};
+
 using mutex = basic_mutex<YAMC_BACKOFF_SPIN_DEFAULT>;
+using timed_mutex = basic_timed_mutex<YAMC_BACKOFF_SPIN_DEFAULT>;
 
 } // namespace spin
 
@@ -91,7 +155,7 @@ class basic_mutex {
   std::atomic<int> state_{0};
 
 public:
-  basic_mutex() = default;
+  constexpr basic_mutex() noexcept = default;
   ~basic_mutex() = default;
 
   basic_mutex(const basic_mutex&) = delete;
@@ -0,0 +1,276 @@
+/*
+ * parking_mutex.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2019 yohhoy
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef YAMC_PARKING_MUTEX_HPP_
+#define YAMC_PARKING_MUTEX_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include "yamc_parking_lot.hpp"
+
+
+/// spin count before parking thread
+#ifndef YAMC_PARKING_SPIN_COUNT
+#define YAMC_PARKING_SPIN_COUNT 40
+#endif
+
+
+namespace yamc {
+
+/*
+ * compact mutex on global parking lot
+ *
+ * - yamc::parking::basic_mutex<FairnessPolicy>
+ * - yamc::parking::basic_timed_mutex<FairnessPolicy>
+ * - yamc::parking::mutex
+ * - yamc::parking::timed_mutex
+ * - yamc::parking::fair_mutex
+ * - yamc::parking::fair_timed_mutex
+ *
+ * Each mutex object has only 1-byte lock word (held bit and parked bit), waiting threads
+ * are parked on yamc::parking_lot with the address of mutex object.
+ *
+ * FairnessPolicy decides whether unlock() hands off the lock directly to unparked thread:
+ * - yamc::parking::EventualFairness: barging lock, but hands off occasionally on "be fair"
+ *   hint of parking lot to prevent starvation (default)
+ * - yamc::parking::StrictFairness: always hands off, FIFO locking order like yamc::fair::mutex
+ */
+namespace parking {
+
+struct EventualFairness {
+  static bool handoff(const parking_lot::unpark_result& r)
+  {
+    return r.be_fair;
+  }
+};
+
+struct StrictFairness {
+  static bool handoff(const parking_lot::unpark_result&)
+  {
+    return true;
+  }
+};
+
+
+namespace detail {
+
+// unpark token of direct handoff
+const std::intptr_t handoff_token = 1;
+
+struct no_timeout {
+  bool expired() const
+  {
+    return false;
+  }
+  template <typename Validate>
+  parking_lot::park_result park(const void* addr, std::intptr_t token, Validate validate) const
+  {
+    return parking_lot::park(addr, token, validate);
+  }
+};
+
+template <typename Clock, typename Duration>
+struct timeout_at {
+  const std::chrono::time_point<Clock, Duration>& tp;
+  bool expired() const
+  {
+    return tp <= Clock::now();
+  }
+  template <typename Validate>
+  parking_lot::park_result park(const void* addr, std::intptr_t token, Validate validate) const
+  {
+    return parking_lot::park_until(addr, token, validate, tp);
+  }
+};
+
+
+template <typename FairnessPolicy>
+class mutex_impl {
+  static const std::uint8_t held_bit = 1;
+  static const std::uint8_t parked_bit = 2;
+
+  std::atomic<std::uint8_t> state_{0};
+
+  template <typename Timeout>
+  bool lock_slow(const Timeout& tmo)
+  {
+    unsigned spin = 0;
+    for (;;) {
+      std::uint8_t s = state_.load(std::memory_order_relaxed);
+      if (!(s & held_bit)) {
+        if (state_.compare_exchange_weak(s, s | held_bit, std::memory_order_acquire, std::memory_order_relaxed))
+          return true;
+        continue;
+      }
+      if (tmo.expired())
+        return false;
+      if (!(s & parked_bit)) {
+        if (spin < YAMC_PARKING_SPIN_COUNT) {
+          ++spin;
+          std::this_thread::yield();
+          continue;
+        }
+        if (!state_.compare_exchange_weak(s, s | parked_bit, std::memory_order_relaxed))
+          continue;
+      }
+      const auto r = tmo.park(this, 0, [this]{
+        return state_.load(std::memory_order_relaxed) == (held_bit | parked_bit);
+      });
+      if (r.unparked && r.token == handoff_token)
+        return true;  // lock is handed off by unlock()
+    }
+  }
+
+  void unlock_slow()
+  {
+    parking_lot::unpark_one(this, [this](const parking_lot::unpark_result& r) {
+      // nobody modifies state_ during held and parked
+      if (r.unparked && FairnessPolicy::handoff(r)) {
+        state_.store(held_bit | (r.have_more ? parked_bit : 0), std::memory_order_relaxed);
+        return handoff_token;
+      }
+      state_.store(r.have_more ? parked_bit : 0, std::memory_order_release);
+      return std::intptr_t(0);
+    });
+  }
+
+public:
+  void lock()
+  {
+    std::uint8_t expected = 0;
+    if (!state_.compare_exchange_weak(expected, held_bit, std::memory_order_acquire, std::memory_order_relaxed))
+      lock_slow(no_timeout{});
+  }
+
+  bool try_lock()
+  {
+    std::uint8_t s = state_.load(std::memory_order_relaxed);
+    while (!(s & held_bit)) {
+      if (state_.compare_exchange_weak(s, s | held_bit, std::memory_order_acquire, std::memory_order_relaxed))
+        return true;
+    }
+    return false;
+  }
+
+  template <typename Clock, typename Duration>
+  bool try_lock_until(const std::chrono::time_point<Clock, Duration>& tp)
+  {
+    std::uint8_t expected = 0;
+    if (state_.compare_exchange_strong(expected, held_bit, std::memory_order_acquire, std::memory_order_relaxed))
+      return true;
+    return lock_slow(timeout_at<Clock, Duration>{tp});
+  }
+
+  void unlock()
+  {
+    std::uint8_t expected = held_bit;
+    if (!state_.compare_exchange_strong(expected, 0, std::memory_order_release, std::memory_order_relaxed))
+      unlock_slow();
+  }
+};
+
+} // namespace detail
+
+
+template <typename FairnessPolicy>
+class basic_mutex {
+  detail::mutex_impl<FairnessPolicy> impl_;
+
+public:
+  constexpr basic_mutex() noexcept = default;
+  ~basic_mutex() = default;
+
+  basic_mutex(const basic_mutex&) = delete;
+  basic_mutex& operator=(const basic_mutex&) = delete;
+
+  void lock()
+  {
+    impl_.lock();
+  }
+
+  bool try_lock()
+  {
+    return impl_.try_lock();
+  }
+
+  void unlock()
+  {
+    impl_.unlock();
+  }
+};
+
+
+template <typename FairnessPolicy>
+class basic_timed_mutex {
+  detail::mutex_impl<FairnessPolicy> impl_;
+
+public:
+  constexpr basic_timed_mutex() noexcept = default;
+  ~basic_timed_mutex() = default;
+
+  basic_timed_mutex(const basic_timed_mutex&) = delete;
+  basic_timed_mutex& operator=(const basic_timed_mutex&) = delete;
+
+  void lock()
+  {
+    impl_.lock();
+  }
+
+  bool try_lock()
+  {
+    return impl_.try_lock();
+  }
+
+  void unlock()
+  {
+    impl_.unlock();
+  }
+
+  template<typename Rep, typename Period>
+  bool try_lock_for(const std::chrono::duration<Rep, Period>& duration)
+  {
+    const auto tp = std::chrono::steady_clock::now() + duration;
+    return impl_.try_lock_until(tp);
+  }
+
+  template<typename Clock, typename Duration>
+  bool try_lock_until(const std::chrono::time_point<Clock, Duration>& tp)
+  {
+    return impl_.try_lock_until(tp);
+  }
+};
+
+
+using mutex = basic_mutex<EventualFairness>;
+using timed_mutex = basic_timed_mutex<EventualFairness>;
+using fair_mutex = basic_mutex<StrictFairness>;
+using fair_timed_mutex = basic_timed_mutex<StrictFairness>;
+
+} // namespace parking
+} // namespace yamc
+
+#endif
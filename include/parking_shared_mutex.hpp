@@ -0,0 +1,327 @@
+/*
+ * parking_shared_mutex.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2019 yohhoy
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef YAMC_PARKING_SHARED_MUTEX_HPP_
+#define YAMC_PARKING_SHARED_MUTEX_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include "fair_shared_mutex.hpp"  // yamc::rwlock::TaskFairness/PhaseFairness
+#include "parking_mutex.hpp"
+
+
+namespace yamc {
+
+/*
+ * compact fairness shared mutex on global parking lot
+ *
+ * - yamc::parking::basic_shared_mutex<RwLockFairness>
+ * - yamc::parking::basic_shared_timed_mutex<RwLockFairness>
+ * - yamc::parking::shared_mutex
+ * - yamc::parking::shared_timed_mutex
+ *
+ * Each mutex object has only 4-byte lock word (writer bit, parked bit and reader count).
+ * Once a thread is parked, new requests are also parked and unlock() hands off the lock
+ * directly to parked threads in FIFO order like yamc::fair::basic_shared_mutex.
+ *
+ * RwLockFairness:
+ * - yamc::rwlock::TaskFairness: unlock() wakes up the front writer, or directly subsequent readers
+ * - yamc::rwlock::PhaseFairness: unlock() wakes up the front writer, or all parked readers
+ */
+namespace parking {
+
+namespace detail {
+
+template <typename RwLockFairness>
+class shared_mutex_impl {
+  static const std::uint32_t writer_bit = 1;
+  static const std::uint32_t parked_bit = 2;
+  static const std::uint32_t reader_unit = 4;
+
+  // park token
+  static const std::intptr_t writer_token = 1;
+  static const std::intptr_t reader_token = 2;
+
+  std::atomic<std::uint32_t> state_{0};
+
+  template <typename Timeout, typename Acquirable, typename Acquired>
+  bool lock_slow(const Timeout& tmo, std::intptr_t token, Acquirable acquirable, Acquired acquired)
+  {
+    unsigned spin = 0;
+    for (;;) {
+      std::uint32_t s = state_.load(std::memory_order_relaxed);
+      if (acquirable(s)) {
+        if (state_.compare_exchange_weak(s, acquired(s), std::memory_order_acquire, std::memory_order_relaxed))
+          return true;
+        continue;
+      }
+      if (tmo.expired())
+        return false;
+      if (!(s & parked_bit)) {
+        if (spin < YAMC_PARKING_SPIN_COUNT) {
+          ++spin;
+          std::this_thread::yield();
+          continue;
+        }
+        if (!state_.compare_exchange_weak(s, s | parked_bit, std::memory_order_relaxed))
+          continue;
+      }
+      // parked bit is cleared only by unlock_slow() of the lock holder
+      const auto r = tmo.park(this, token, [this]{
+        return (state_.load(std::memory_order_relaxed) & parked_bit) != 0;
+      });
+      if (r.unparked && r.token == handoff_token)
+        return true;  // lock is handed off by unlock_slow()
+    }
+  }
+
+  template <typename Timeout>
+  bool lock_slow(const Timeout& tmo)
+  {
+    return lock_slow(tmo, writer_token,
+      [](std::uint32_t s) { return s == 0; },
+      [](std::uint32_t) { return writer_bit; });
+  }
+
+  template <typename Timeout>
+  bool lock_shared_slow(const Timeout& tmo)
+  {
+    return lock_slow(tmo, reader_token,
+      [](std::uint32_t s) { return (s & (writer_bit | parked_bit)) == 0; },
+      [](std::uint32_t s) { return s + reader_unit; });
+  }
+
+  void unlock_slow()
+  {
+    // wake up the front writer, or readers group
+    //   TaskFairness: directly subsequent readers
+    //   PhaseFairness: all readers in queue
+    bool writer = false;
+    std::uint32_t nreader = 0;
+    auto filter = [&](std::intptr_t token) {
+      if (writer)
+        return parking_lot::filter_op::stop;
+      if (token == writer_token) {
+        if (nreader == 0) {
+          writer = true;
+          return parking_lot::filter_op::unpark;
+        }
+        return RwLockFairness::phased ? parking_lot::filter_op::skip : parking_lot::filter_op::stop;
+      }
+      ++nreader;
+      return parking_lot::filter_op::unpark;
+    };
+    parking_lot::unpark_filter(this, filter, [&](const parking_lot::unpark_result& r) {
+      // nobody modifies state_ while parked bit is set and no one holds the lock
+      std::uint32_t s = writer ? writer_bit : nreader * reader_unit;
+      if (r.have_more)
+        s |= parked_bit;
+      state_.store(s, std::memory_order_release);
+      return handoff_token;
+    });
+  }
+
+public:
+  void lock()
+  {
+    std::uint32_t expected = 0;
+    if (!state_.compare_exchange_weak(expected, writer_bit, std::memory_order_acquire, std::memory_order_relaxed))
+      lock_slow(no_timeout{});
+  }
+
+  bool try_lock()
+  {
+    std::uint32_t expected = 0;
+    return state_.compare_exchange_strong(expected, writer_bit, std::memory_order_acquire, std::memory_order_relaxed);
+  }
+
+  template <typename Clock, typename Duration>
+  bool try_lock_until(const std::chrono::time_point<Clock, Duration>& tp)
+  {
+    return try_lock() || lock_slow(timeout_at<Clock, Duration>{tp});
+  }
+
+  void unlock()
+  {
+    std::uint32_t expected = writer_bit;
+    if (!state_.compare_exchange_strong(expected, 0, std::memory_order_release, std::memory_order_relaxed))
+      unlock_slow();
+  }
+
+  void lock_shared()
+  {
+    if (!try_lock_shared())
+      lock_shared_slow(no_timeout{});
+  }
+
+  bool try_lock_shared()
+  {
+    std::uint32_t s = state_.load(std::memory_order_relaxed);
+    while (!(s & (writer_bit | parked_bit))) {
+      if (state_.compare_exchange_weak(s, s + reader_unit, std::memory_order_acquire, std::memory_order_relaxed))
+        return true;
+    }
+    return false;
+  }
+
+  template <typename Clock, typename Duration>
+  bool try_lock_shared_until(const std::chrono::time_point<Clock, Duration>& tp)
+  {
+    return try_lock_shared() || lock_shared_slow(timeout_at<Clock, Duration>{tp});
+  }
+
+  void unlock_shared()
+  {
+    // acq_rel: last reader passes all reader's release to next lock holder
+    const std::uint32_t s = state_.fetch_sub(reader_unit, std::memory_order_acq_rel) - reader_unit;
+    if (s == parked_bit)
+      unlock_slow();
+  }
+};
+
+} // namespace detail
+
+
+template <typename RwLockFairness>
+class basic_shared_mutex {
+  detail::shared_mutex_impl<RwLockFairness> impl_;
+
+public:
+  constexpr basic_shared_mutex() noexcept = default;
+  ~basic_shared_mutex() = default;
+
+  basic_shared_mutex(const basic_shared_mutex&) = delete;
+  basic_shared_mutex& operator=(const basic_shared_mutex&) = delete;
+
+  void lock()
+  {
+    impl_.lock();
+  }
+
+  bool try_lock()
+  {
+    return impl_.try_lock();
+  }
+
+  void unlock()
+  {
+    impl_.unlock();
+  }
+
+  void lock_shared()
+  {
+    impl_.lock_shared();
+  }
+
+  bool try_lock_shared()
+  {
+    return impl_.try_lock_shared();
+  }
+
+  void unlock_shared()
+  {
+    impl_.unlock_shared();
+  }
+};
+
+
+template <typename RwLockFairness>
+class basic_shared_timed_mutex {
+  detail::shared_mutex_impl<RwLockFairness> impl_;
+
+public:
+  constexpr basic_shared_timed_mutex() noexcept = default;
+  ~basic_shared_timed_mutex() = default;
+
+  basic_shared_timed_mutex(const basic_shared_timed_mutex&) = delete;
+  basic_shared_timed_mutex& operator=(const basic_shared_timed_mutex&) = delete;
+
+  void lock()
+  {
+    impl_.lock();
+  }
+
+  bool try_lock()
+  {
+    return impl_.try_lock();
+  }
+
+  void unlock()
+  {
+    impl_.unlock();
+  }
+
+  template<typename Rep, typename Period>
+  bool try_lock_for(const std::chrono::duration<Rep, Period>& duration)
+  {
+    const auto tp = std::chrono::steady_clock::now() + duration;
+    return impl_.try_lock_until(tp);
+  }
+
+  template<typename Clock, typename Duration>
+  bool try_lock_until(const std::chrono::time_point<Clock, Duration>& tp)
+  {
+    return impl_.try_lock_until(tp);
+  }
+
+  void lock_shared()
+  {
+    impl_.lock_shared();
+  }
+
+  bool try_lock_shared()
+  {
+    return impl_.try_lock_shared();
+  }
+
+  void unlock_shared()
+  {
+    impl_.unlock_shared();
+  }
+
+  template<typename Rep, typename Period>
+  bool try_lock_shared_for(const std::chrono::duration<Rep, Period>& duration)
+  {
+    const auto tp = std::chrono::steady_clock::now() + duration;
+    return impl_.try_lock_shared_until(tp);
+  }
+
+  template<typename Clock, typename Duration>
+  bool try_lock_shared_until(const std::chrono::time_point<Clock, Duration>& tp)
+  {
+    return impl_.try_lock_shared_until(tp);
+  }
+};
+
+
+using shared_mutex = basic_shared_mutex<YAMC_RWLOCK_FAIRNESS_DEFAULT>;
+using shared_timed_mutex = basic_shared_timed_mutex<YAMC_RWLOCK_FAIRNESS_DEFAULT>;
+
+} // namespace parking
+} // namespace yamc
+
+#endif
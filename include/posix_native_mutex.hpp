@@ -26,7 +26,10 @@
 #ifndef POSIX_NATIVE_MUTEX_HPP_
 #define POSIX_NATIVE_MUTEX_HPP_
 
+#include <cerrno>
 #include <chrono>
+#include <system_error>
+#include <type_traits>
 // POSIX(pthreads) mutex
 #include <pthread.h>
 #include <time.h>
@@ -42,6 +45,34 @@
 #define YAMC_POSIX_SPINLOCK_SUPPORTED  1
 #endif
 
+// glibc 2.30 or later provides timed waiting functions with clock selection
+// (pthread_mutex_clocklock, pthread_rwlock_clock{rd,wr}lock, sem_clockwait)
+#if !defined(YAMC_POSIX_CLOCKWAIT_SUPPORTED)
+#if defined(__GLIBC__) && defined(__USE_GNU) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 30))
+#define YAMC_POSIX_CLOCKWAIT_SUPPORTED 1
+#else
+#define YAMC_POSIX_CLOCKWAIT_SUPPORTED 0
+#endif
+#endif
+
+// POSIX.1-2008 robust mutex (pthread_mutexattr_setrobust, pthread_mutex_consistent)
+#if !defined(YAMC_POSIX_ROBUST_SUPPORTED)
+#if defined(__APPLE__)
+#define YAMC_POSIX_ROBUST_SUPPORTED 0
+#else
+#define YAMC_POSIX_ROBUST_SUPPORTED 1
+#endif
+#endif
+
+// glibc non-portable extensions (PTHREAD_MUTEX_ADAPTIVE_NP, pthread_rwlockattr_setkind_np)
+#if !defined(YAMC_POSIX_NP_SUPPORTED)
+#if defined(__GLIBC__) && defined(__USE_GNU)
+#define YAMC_POSIX_NP_SUPPORTED 1
+#else
+#define YAMC_POSIX_NP_SUPPORTED 0
+#endif
+#endif
+
 
 namespace yamc {
 
@@ -52,9 +83,17 @@ namespace yamc {
  * - yamc::posix::native_recursive_mutex
  * - yamc::posix::rwlock
  * - yamc::posix::spinlock [conditional]
+ * - yamc::posix::basic_native_mutex<Attrs...>
+ * - yamc::posix::basic_native_recursive_mutex<Attrs...>
+ * - yamc::posix::basic_rwlock<Attrs...>
  *
+ * basic_* variants initialize the native object with attributes yamc::posix::attr::*,
+ * they may throw std::system_error from constructor and lock() when the platform
+ * rejects the attributes (e.g. priority ceiling lower than the calling thread).
  * Some platform doesn't support locking operation with timeout.
  * Some platform doesn't provide spinlock object (pthread_spinlock_t).
+ * When YAMC_POSIX_CLOCKWAIT_SUPPORTED, relative timeout and steady_clock deadline
+ * wait on CLOCK_MONOTONIC directly, otherwise they wait on CLOCK_REALTIME (system_clock).
  * https://pubs.opengroup.org/onlinepubs/9699919799/basedefs/pthread.h.html
  * https://pubs.opengroup.org/onlinepubs/9699919799/functions/pthread_mutex_timedlock.html
  * https://pubs.opengroup.org/onlinepubs/9699919799/functions/pthread_rwlock_timedrdlock.html
@@ -81,6 +120,19 @@ class native_mutex {
     abs_timeout.tv_nsec = (long)(duration_cast<nanoseconds>(tp.time_since_epoch()).count() % 1000000000);
     return (::pthread_mutex_timedlock(&mtx_, &abs_timeout) == 0);
   }
+
+#if YAMC_POSIX_CLOCKWAIT_SUPPORTED
+  template<typename Duration>
+  bool do_try_lockwait(const std::chrono::time_point<std::chrono::steady_clock, Duration>& tp)
+  {
+    using namespace std::chrono;
+    const auto ns = duration_cast<nanoseconds>(tp.time_since_epoch()).count();
+    struct ::timespec abs_timeout;
+    abs_timeout.tv_sec = (::time_t)(ns / 1000000000);
+    abs_timeout.tv_nsec = (long)(ns % 1000000000);
+    return (::pthread_mutex_clocklock(&mtx_, CLOCK_MONOTONIC, &abs_timeout) == 0);
+  }
+#endif
 #endif
 
 public:
@@ -113,16 +165,25 @@ public:
  template<class Rep, class Period>
   bool try_lock_for(const std::chrono::duration<Rep, Period>& rel_time)
   {
+#if YAMC_POSIX_CLOCKWAIT_SUPPORTED
+    const auto tp = std::chrono::steady_clock::now() + rel_time;
+#else
     // C++ Standard says '_for'-suffixed timeout function shall use steady clock,
     // but we use std::chrono::system_clock which may or may not be steady.
     const auto tp = std::chrono::system_clock::now() + rel_time;
+#endif
     return do_try_lockwait(tp);
   }
 
   template<class Clock, class Duration>
   bool try_lock_until(const std::chrono::time_point<Clock, Duration>& abs_time)
   {
+#if YAMC_POSIX_CLOCKWAIT_SUPPORTED
+    static_assert(std::is_same<Clock, std::chrono::system_clock>::value || std::is_same<Clock, std::chrono::steady_clock>::value,
+                  "support only system_clock and steady_clock");
+#else
     static_assert(std::is_same<Clock, std::chrono::system_clock>::value, "support only system_clock");
+#endif
     return do_try_lockwait(abs_time);
   }
 #endif
@@ -156,6 +217,19 @@ class native_recursive_mutex {
     abs_timeout.tv_nsec = (long)(duration_cast<nanoseconds>(tp.time_since_epoch()).count() % 1000000000);
     return (::pthread_mutex_timedlock(&mtx_, &abs_timeout) == 0);
   }
+
+#if YAMC_POSIX_CLOCKWAIT_SUPPORTED
+  template<typename Duration>
+  bool do_try_lockwait(const std::chrono::time_point<std::chrono::steady_clock, Duration>& tp)
+  {
+    using namespace std::chrono;
+    const auto ns = duration_cast<nanoseconds>(tp.time_since_epoch()).count();
+    struct ::timespec abs_timeout;
+    abs_timeout.tv_sec = (::time_t)(ns / 1000000000);
+    abs_timeout.tv_nsec = (long)(ns % 1000000000);
+    return (::pthread_mutex_clocklock(&mtx_, CLOCK_MONOTONIC, &abs_timeout) == 0);
+  }
+#endif
 #endif
 
 public:
@@ -197,16 +271,25 @@ public:
   template<class Rep, class Period>
   bool try_lock_for(const std::chrono::duration<Rep, Period>& rel_time)
   {
+#if YAMC_POSIX_CLOCKWAIT_SUPPORTED
+    const auto tp = std::chrono::steady_clock::now() + rel_time;
+#else
     // C++ Standard says '_for'-suffixed timeout function shall use steady clock,
     // but we use std::chrono::system_clock which may or may not be steady.
     const auto tp = std::chrono::system_clock::now() + rel_time;
+#endif
     return do_try_lockwait(tp);
   }
 
   template<class Clock, class Duration>
   bool try_lock_until(const std::chrono::time_point<Clock, Duration>& abs_time)
   {
+#if YAMC_POSIX_CLOCKWAIT_SUPPORTED
+    static_assert(std::is_same<Clock, std::chrono::system_clock>::value || std::is_same<Clock, std::chrono::steady_clock>::value,
+                  "support only system_clock and steady_clock");
+#else
     static_assert(std::is_same<Clock, std::chrono::system_clock>::value, "support only system_clock");
+#endif
     return do_try_lockwait(abs_time);
   }
 #endif // YAMC_POSIX_TIMEOUT_SUPPORTED
@@ -247,6 +330,30 @@ class rwlock {
     abs_timeout.tv_nsec = (long)(duration_cast<nanoseconds>(tp.time_since_epoch()).count() % 1000000000);
     return (::pthread_rwlock_timedrdlock(&rwlock_, &abs_timeout) == 0);
   }
+
+#if YAMC_POSIX_CLOCKWAIT_SUPPORTED
+  template<typename Duration>
+  bool do_try_lockwait(const std::chrono::time_point<std::chrono::steady_clock, Duration>& tp)
+  {
+    using namespace std::chrono;
+    const auto ns = duration_cast<nanoseconds>(tp.time_since_epoch()).count();
+    struct ::timespec abs_timeout;
+    abs_timeout.tv_sec = (::time_t)(ns / 1000000000);
+    abs_timeout.tv_nsec = (long)(ns % 1000000000);
+    return (::pthread_rwlock_clockwrlock(&rwlock_, CLOCK_MONOTONIC, &abs_timeout) == 0);
+  }
+
+  template<typename Duration>
+  bool do_try_lock_sharedwait(const std::chrono::time_point<std::chrono::steady_clock, Duration>& tp)
+  {
+    using namespace std::chrono;
+    const auto ns = duration_cast<nanoseconds>(tp.time_since_epoch()).count();
+    struct ::timespec abs_timeout;
+    abs_timeout.tv_sec = (::time_t)(ns / 1000000000);
+    abs_timeout.tv_nsec = (long)(ns % 1000000000);
+    return (::pthread_rwlock_clockrdlock(&rwlock_, CLOCK_MONOTONIC, &abs_timeout) == 0);
+  }
+#endif
 #endif
 
 public:
@@ -293,32 +400,50 @@ public:
   template<typename Rep, typename Period>
   bool try_lock_for(const std::chrono::duration<Rep, Period>& rel_time)
   {
+#if YAMC_POSIX_CLOCKWAIT_SUPPORTED
+    const auto tp = std::chrono::steady_clock::now() + rel_time;
+#else
     // C++ Standard says '_for'-suffixed timeout function shall use steady clock,
     // but we use std::chrono::system_clock which may or may not be steady.
     const auto tp = std::chrono::system_clock::now() + rel_time;
+#endif
     return do_try_lockwait(tp);
   }
 
   template<typename Clock, typename Duration>
   bool try_lock_until(const std::chrono::time_point<Clock, Duration>& abs_time)
   {
+#if YAMC_POSIX_CLOCKWAIT_SUPPORTED
+    static_assert(std::is_same<Clock, std::chrono::system_clock>::value || std::is_same<Clock, std::chrono::steady_clock>::value,
+                  "support only system_clock and steady_clock");
+#else
     static_assert(std::is_same<Clock, std::chrono::system_clock>::value, "support only system_clock");
+#endif
     return do_try_lockwait(abs_time);
   }
 
   template<typename Rep, typename Period>
   bool try_lock_shared_for(const std::chrono::duration<Rep, Period>& rel_time)
   {
+#if YAMC_POSIX_CLOCKWAIT_SUPPORTED
+    const auto tp = std::chrono::steady_clock::now() + rel_time;
+#else
     // C++ Standard says '_for'-suffixed timeout function shall use steady clock,
     // but we use std::chrono::system_clock which may or may not be steady.
     const auto tp = std::chrono::system_clock::now() + rel_time;
+#endif
     return do_try_lock_sharedwait(tp);
   }
 
   template<typename Clock, typename Duration>
   bool try_lock_shared_until(const std::chrono::time_point<Clock, Duration>& abs_time)
   {
+#if YAMC_POSIX_CLOCKWAIT_SUPPORTED
+    static_assert(std::is_same<Clock, std::chrono::system_clock>::value || std::is_same<Clock, std::chrono::steady_clock>::value,
+                  "support only system_clock and steady_clock");
+#else
     static_assert(std::is_same<Clock, std::chrono::system_clock>::value, "support only system_clock");
+#endif
     return do_try_lock_sharedwait(abs_time);
   }
 #endif // YAMC_POSIX_TIMEOUT_SUPPORTED
@@ -373,6 +498,409 @@ public:
 #endif // YAMC_POSIX_SPINLOCK_SUPPORTED
 
 
+namespace detail {
+
+struct mutex_type_attr {};
+
+template <typename... Attrs>
+struct mutex_type_count : std::integral_constant<int, 0> {};
+
+template <typename A0, typename... Attrs>
+struct mutex_type_count<A0, Attrs...>
+  : std::integral_constant<int, std::is_base_of<mutex_type_attr, A0>::value + mutex_type_count<Attrs...>::value> {};
+
+template <typename AttrObj>
+inline int apply_attrs(AttrObj*)
+{
+  return 0;
+}
+
+template <typename AttrObj, typename A0, typename... Attrs>
+int apply_attrs(AttrObj* attr)
+{
+  const int r = A0::apply(attr);
+  return (r != 0) ? r : apply_attrs<AttrObj, Attrs...>(attr);
+}
+
+inline struct ::timespec to_timespec(const std::chrono::system_clock::time_point& tp)
+{
+  using namespace std::chrono;
+  struct ::timespec ts;
+  ts.tv_sec = system_clock::to_time_t(tp);
+  ts.tv_nsec = (long)(duration_cast<nanoseconds>(tp.time_since_epoch()).count() % 1000000000);
+  return ts;
+}
+
+template<typename Duration>
+struct ::timespec to_timespec(const std::chrono::time_point<std::chrono::steady_clock, Duration>& tp)
+{
+  using namespace std::chrono;
+  const auto ns = duration_cast<nanoseconds>(tp.time_since_epoch()).count();
+  struct ::timespec ts;
+  ts.tv_sec = (::time_t)(ns / 1000000000);
+  ts.tv_nsec = (long)(ns % 1000000000);
+  return ts;
+}
+
+} // namespace detail
+
+
+/*
+ * attributes of basic_native_mutex<Attrs...> and basic_rwlock<Attrs...>
+ *
+ * - prio_inherit: PTHREAD_PRIO_INHERIT protocol
+ * - prio_protect<Ceiling>: PTHREAD_PRIO_PROTECT protocol with priority ceiling
+ * - robust: PTHREAD_MUTEX_ROBUST [conditional]
+ * - recursive: PTHREAD_MUTEX_RECURSIVE type
+ * - adaptive: PTHREAD_MUTEX_ADAPTIVE_NP type [conditional]
+ * - prefer_writer: PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP kind for rwlock [conditional]
+ *
+ * When previous owner of robust mutex died while holding the lock, the next lock
+ * operation acquires it and owner_dead() returns true. The new owner shall repair
+ * protected state and call consistent() before unlock(), otherwise the mutex becomes
+ * permanently unusable and subsequent lock() throws std::system_error(ENOTRECOVERABLE).
+ */
+namespace attr {
+
+struct prio_inherit {
+  static int apply(::pthread_mutexattr_t* attr)
+  {
+    return ::pthread_mutexattr_setprotocol(attr, PTHREAD_PRIO_INHERIT);
+  }
+};
+
+template <int Ceiling>
+struct prio_protect {
+  static int apply(::pthread_mutexattr_t* attr)
+  {
+    const int r = ::pthread_mutexattr_setprotocol(attr, PTHREAD_PRIO_PROTECT);
+    return (r != 0) ? r : ::pthread_mutexattr_setprioceiling(attr, Ceiling);
+  }
+};
+
+#if YAMC_POSIX_ROBUST_SUPPORTED
+struct robust {
+  static int apply(::pthread_mutexattr_t* attr)
+  {
+    return ::pthread_mutexattr_setrobust(attr, PTHREAD_MUTEX_ROBUST);
+  }
+};
+#endif
+
+struct recursive : detail::mutex_type_attr {
+  static int apply(::pthread_mutexattr_t* attr)
+  {
+    return ::pthread_mutexattr_settype(attr, PTHREAD_MUTEX_RECURSIVE);
+  }
+};
+
+#if YAMC_POSIX_NP_SUPPORTED
+struct adaptive : detail::mutex_type_attr {
+  static int apply(::pthread_mutexattr_t* attr)
+  {
+    return ::pthread_mutexattr_settype(attr, PTHREAD_MUTEX_ADAPTIVE_NP);
+  }
+};
+
+struct prefer_writer {
+  static int apply(::pthread_rwlockattr_t* attr)
+  {
+    return ::pthread_rwlockattr_setkind_np(attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP);
+  }
+};
+#endif
+
+} // namespace attr
+
+
+template <typename... Attrs>
+class basic_native_mutex {
+  static_assert(detail::mutex_type_count<Attrs...>::value <= 1, "conflicting mutex type attributes");
+
+  ::pthread_mutex_t mtx_;
+  bool owner_dead_ = false;  // accessed only by lock owner
+
+  bool acquired(int r)
+  {
+#if YAMC_POSIX_ROBUST_SUPPORTED
+    if (r == EOWNERDEAD) {
+      // previous owner died while holding the lock, leave it inconsistent until consistent()
+      owner_dead_ = true;
+      return true;
+    }
+#endif
+    return (r == 0);
+  }
+
+#if YAMC_POSIX_TIMEOUT_SUPPORTED
+  bool timed_acquired(int r, const char* what)
+  {
+    if (r == ETIMEDOUT)
+      return false;
+    if (!acquired(r))
+      throw std::system_error(r, std::system_category(), what);
+    return true;
+  }
+
+  bool do_try_lockwait(const std::chrono::system_clock::time_point& tp)
+  {
+    const struct ::timespec abs_timeout = detail::to_timespec(tp);
+    return timed_acquired(::pthread_mutex_timedlock(&mtx_, &abs_timeout), "pthread_mutex_timedlock");
+  }
+
+#if YAMC_POSIX_CLOCKWAIT_SUPPORTED
+  template<typename Duration>
+  bool do_try_lockwait(const std::chrono::time_point<std::chrono::steady_clock, Duration>& tp)
+  {
+    const struct ::timespec abs_timeout = detail::to_timespec(tp);
+    const int r = ::pthread_mutex_clocklock(&mtx_, CLOCK_MONOTONIC, &abs_timeout);
+    if (r == EINVAL) {
+      // some glibc/kernel reject CLOCK_MONOTONIC for PTHREAD_PRIO_INHERIT mutex,
+      // other causes of EINVAL (e.g. priority ceiling) are reported by timedlock
+      using namespace std::chrono;
+      return do_try_lockwait(time_point_cast<system_clock::duration>(system_clock::now() + (tp - steady_clock::now())));
+    }
+    return timed_acquired(r, "pthread_mutex_clocklock");
+  }
+#endif
+#endif
+
+public:
+  basic_native_mutex()
+  {
+    ::pthread_mutexattr_t attr;
+    ::pthread_mutexattr_init(&attr);
+    int r = detail::apply_attrs< ::pthread_mutexattr_t, Attrs...>(&attr);
+    if (r == 0)
+      r = ::pthread_mutex_init(&mtx_, &attr);
+    ::pthread_mutexattr_destroy(&attr);
+    if (r != 0)
+      throw std::system_error(r, std::system_category(), "pthread_mutex_init");
+  }
+
+  ~basic_native_mutex()
+  {
+    ::pthread_mutex_destroy(&mtx_);
+  }
+
+  basic_native_mutex(const basic_native_mutex&) = delete;
+  basic_native_mutex& operator=(const basic_native_mutex&) = delete;
+
+  void lock()
+  {
+    const int r = ::pthread_mutex_lock(&mtx_);
+    if (!acquired(r))
+      throw std::system_error(r, std::system_category(), "pthread_mutex_lock");
+  }
+
+  bool try_lock()
+  {
+    return acquired(::pthread_mutex_trylock(&mtx_));
+  }
+
+  void unlock()
+  {
+    ::pthread_mutex_unlock(&mtx_);
+  }
+
+#if YAMC_POSIX_ROBUST_SUPPORTED
+  /// true if previous owner died while holding the lock (call by current owner)
+  bool owner_dead() const noexcept
+  {
+    return owner_dead_;
+  }
+
+  /// mark state protected by robust mutex consistent (call by current owner)
+  void consistent()
+  {
+    const int r = ::pthread_mutex_consistent(&mtx_);
+    if (r != 0)
+      throw std::system_error(r, std::system_category(), "pthread_mutex_consistent");
+    owner_dead_ = false;
+  }
+#endif
+
+#if YAMC_POSIX_TIMEOUT_SUPPORTED
+  template<class Rep, class Period>
+  bool try_lock_for(const std::chrono::duration<Rep, Period>& rel_time)
+  {
+#if YAMC_POSIX_CLOCKWAIT_SUPPORTED
+    const auto tp = std::chrono::steady_clock::now() + rel_time;
+#else
+    const auto tp = std::chrono::system_clock::now() + rel_time;
+#endif
+    return do_try_lockwait(tp);
+  }
+
+  template<class Clock, class Duration>
+  bool try_lock_until(const std::chrono::time_point<Clock, Duration>& abs_time)
+  {
+#if YAMC_POSIX_CLOCKWAIT_SUPPORTED
+    static_assert(std::is_same<Clock, std::chrono::system_clock>::value || std::is_same<Clock, std::chrono::steady_clock>::value,
+                  "support only system_clock and steady_clock");
+#else
+    static_assert(std::is_same<Clock, std::chrono::system_clock>::value, "support only system_clock");
+#endif
+    return do_try_lockwait(abs_time);
+  }
+#endif // YAMC_POSIX_TIMEOUT_SUPPORTED
+
+  using native_handle_type = ::pthread_mutex_t*;
+  native_handle_type native_handle()
+  {
+    return &mtx_;
+  }
+};
+
+template <typename... Attrs>
+using basic_native_recursive_mutex = basic_native_mutex<attr::recursive, Attrs...>;
+
+
+template <typename... Attrs>
+class basic_rwlock {
+  ::pthread_rwlock_t rwlock_;
+
+#if YAMC_POSIX_TIMEOUT_SUPPORTED
+  bool do_try_lockwait(const std::chrono::system_clock::time_point& tp)
+  {
+    const struct ::timespec abs_timeout = detail::to_timespec(tp);
+    return (::pthread_rwlock_timedwrlock(&rwlock_, &abs_timeout) == 0);
+  }
+
+  bool do_try_lock_sharedwait(const std::chrono::system_clock::time_point& tp)
+  {
+    const struct ::timespec abs_timeout = detail::to_timespec(tp);
+    return (::pthread_rwlock_timedrdlock(&rwlock_, &abs_timeout) == 0);
+  }
+
+#if YAMC_POSIX_CLOCKWAIT_SUPPORTED
+  template<typename Duration>
+  bool do_try_lockwait(const std::chrono::time_point<std::chrono::steady_clock, Duration>& tp)
+  {
+    const struct ::timespec abs_timeout = detail::to_timespec(tp);
+    return (::pthread_rwlock_clockwrlock(&rwlock_, CLOCK_MONOTONIC, &abs_timeout) == 0);
+  }
+
+  template<typename Duration>
+  bool do_try_lock_sharedwait(const std::chrono::time_point<std::chrono::steady_clock, Duration>& tp)
+  {
+    const struct ::timespec abs_timeout = detail::to_timespec(tp);
+    return (::pthread_rwlock_clockrdlock(&rwlock_, CLOCK_MONOTONIC, &abs_timeout) == 0);
+  }
+#endif
+#endif
+
+public:
+  basic_rwlock()
+  {
+    ::pthread_rwlockattr_t attr;
+    ::pthread_rwlockattr_init(&attr);
+    int r = detail::apply_attrs< ::pthread_rwlockattr_t, Attrs...>(&attr);
+    if (r == 0)
+      r = ::pthread_rwlock_init(&rwlock_, &attr);
+    ::pthread_rwlockattr_destroy(&attr);
+    if (r != 0)
+      throw std::system_error(r, std::system_category(), "pthread_rwlock_init");
+  }
+
+  ~basic_rwlock()
+  {
+    ::pthread_rwlock_destroy(&rwlock_);
+  }
+
+  basic_rwlock(const basic_rwlock&) = delete;
+  basic_rwlock& operator=(const basic_rwlock&) = delete;
+
+  void lock()
+  {
+    const int r = ::pthread_rwlock_wrlock(&rwlock_);
+    if (r != 0)
+      throw std::system_error(r, std::system_category(), "pthread_rwlock_wrlock");
+  }
+
+  bool try_lock()
+  {
+    return (::pthread_rwlock_trywrlock(&rwlock_) == 0);
+  }
+
+  void unlock()
+  {
+    ::pthread_rwlock_unlock(&rwlock_);
+  }
+
+  void lock_shared()
+  {
+    const int r = ::pthread_rwlock_rdlock(&rwlock_);
+    if (r != 0)
+      throw std::system_error(r, std::system_category(), "pthread_rwlock_rdlock");
+  }
+
+  bool try_lock_shared()
+  {
+    return (::pthread_rwlock_tryrdlock(&rwlock_) == 0);
+  }
+
+  void unlock_shared()
+  {
+    ::pthread_rwlock_unlock(&rwlock_);
+  }
+
+#if YAMC_POSIX_TIMEOUT_SUPPORTED
+  template<typename Rep, typename Period>
+  bool try_lock_for(const std::chrono::duration<Rep, Period>& rel_time)
+  {
+#if YAMC_POSIX_CLOCKWAIT_SUPPORTED
+    const auto tp = std::chrono::steady_clock::now() + rel_time;
+#else
+    const auto tp = std::chrono::system_clock::now() + rel_time;
+#endif
+    return do_try_lockwait(tp);
+  }
+
+  template<typename Clock, typename Duration>
+  bool try_lock_until(const std::chrono::time_point<Clock, Duration>& abs_time)
+  {
+#if YAMC_POSIX_CLOCKWAIT_SUPPORTED
+    static_assert(std::is_same<Clock, std::chrono::system_clock>::value || std::is_same<Clock, std::chrono::steady_clock>::value,
+                  "support only system_clock and steady_clock");
+#else
+    static_assert(std::is_same<Clock, std::chrono::system_clock>::value, "support only system_clock");
+#endif
+    return do_try_lockwait(abs_time);
+  }
+
+  template<typename Rep, typename Period>
+  bool try_lock_shared_for(const std::chrono::duration<Rep, Period>& rel_time)
+  {
+#if YAMC_POSIX_CLOCKWAIT_SUPPORTED
+    const auto tp = std::chrono::steady_clock::now() + rel_time;
+#else
+    const auto tp = std::chrono::system_clock::now() + rel_time;
+#endif
+    return do_try_lock_sharedwait(tp);
+  }
+
+  template<typename Clock, typename Duration>
+  bool try_lock_shared_until(const std::chrono::time_point<Clock, Duration>& abs_time)
+  {
+#if YAMC_POSIX_CLOCKWAIT_SUPPORTED
+    static_assert(std::is_same<Clock, std::chrono::system_clock>::value || std::is_same<Clock, std::chrono::steady_clock>::value,
+                  "support only system_clock and steady_clock");
+#else
+    static_assert(std::is_same<Clock, std::chrono::system_clock>::value, "support only system_clock");
+#endif
+    return do_try_lock_sharedwait(abs_time);
+  }
+#endif // YAMC_POSIX_TIMEOUT_SUPPORTED
+
+  using native_handle_type = ::pthread_rwlock_t*;
+  native_handle_type native_handle()
+  {
+    return &rwlock_;
+  }
+};
+
+
 using mutex = native_mutex;
 using recursive_mutex = native_recursive_mutex;
 using timed_mutex = native_mutex;
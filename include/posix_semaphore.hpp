@@ -37,6 +37,16 @@
 #include <time.h>    // timespec struct
 
 
+// glibc 2.30 or later provides sem_clockwait()
+#if !defined(YAMC_POSIX_CLOCKWAIT_SUPPORTED)
+#if defined(__GLIBC__) && defined(__USE_GNU) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 30))
+#define YAMC_POSIX_CLOCKWAIT_SUPPORTED 1
+#else
+#define YAMC_POSIX_CLOCKWAIT_SUPPORTED 0
+#endif
+#endif
+
+
 namespace yamc {
 
 /*
@@ -46,6 +56,11 @@ namespace yamc {
  * - yamc::posix::binary_semaphore
  *
  * This implementation use POSIX unnamed semaphore.
+ * When YAMC_POSIX_CLOCKWAIT_SUPPORTED, relative timeout and non-system_clock deadline
+ * wait on CLOCK_MONOTONIC by sem_clockwait(), otherwise on CLOCK_REALTIME by sem_timedwait().
+ * POSIX semaphore has no multi-permit wait operation, so multi-permit acquire(n) and
+ * try_acquire_*(n, ...) are not provided; permit-by-permit emulation can't keep large
+ * request from starvation by single-permit acquirers. Use yamc::counting_semaphore.
  * https://pubs.opengroup.org/onlinepubs/9699919799/basedefs/semaphore.h.html
  */
 namespace posix {
@@ -68,6 +83,24 @@ to_system_timepoint(const std::chrono::time_point<std::chrono::system_clock, Dur
   return tp;
 }
 
+#if YAMC_POSIX_CLOCKWAIT_SUPPORTED
+template<typename Clock, typename Duration>
+inline
+std::chrono::time_point<std::chrono::steady_clock, Duration>
+to_steady_timepoint(const std::chrono::time_point<Clock, Duration>& tp)
+{
+  return std::chrono::steady_clock::now() + (tp - Clock::now());
+}
+
+template<typename Duration>
+inline
+std::chrono::time_point<std::chrono::steady_clock, Duration>
+to_steady_timepoint(const std::chrono::time_point<std::chrono::steady_clock, Duration>& tp)
+{
+  return tp;
+}
+#endif
+
 } // namespace detail
 
 
@@ -97,6 +130,27 @@ class counting_semaphore {
     return false;
   }
 
+#if YAMC_POSIX_CLOCKWAIT_SUPPORTED
+  template<typename Duration>
+  bool do_try_acquirewait(const std::chrono::time_point<std::chrono::steady_clock, Duration>& tp)
+  {
+    using namespace std::chrono;
+    // convert C++ steady_clock to POSIX struct timespec on CLOCK_MONOTONIC
+    const auto ns = duration_cast<nanoseconds>(tp.time_since_epoch()).count();
+    struct ::timespec abs_timeout;
+    abs_timeout.tv_sec = (::time_t)(ns / 1000000000);
+    abs_timeout.tv_nsec = (long)(ns % 1000000000);
+
+    errno = 0;
+    if (::sem_clockwait(&sem_, CLOCK_MONOTONIC, &abs_timeout) == 0) {
+      return true;
+    } else if (errno != ETIMEDOUT) {
+      throw_errno("sem_clockwait");
+    }
+    return false;
+  }
+#endif
+
 public:
   static constexpr std::ptrdiff_t max() noexcept
   {
@@ -146,16 +200,31 @@ public:
   template<class Rep, class Period>
   bool try_acquire_for(const std::chrono::duration<Rep, Period>& rel_time)
   {
+#if YAMC_POSIX_CLOCKWAIT_SUPPORTED
+    const auto tp = std::chrono::steady_clock::now() + rel_time;
+#else
     // C++ Standard says '_for'-suffixed timeout function shall use steady clock,
     // but we use system_clock to convert from time_point to legacy time_t.
     const auto tp = std::chrono::system_clock::now() + rel_time;
+#endif
     return do_try_acquirewait(tp);
   }
 
   template<class Clock, class Duration>
   bool try_acquire_until(const std::chrono::time_point<Clock, Duration>& abs_time)
   {
+#if YAMC_POSIX_CLOCKWAIT_SUPPORTED
+    return do_try_acquirewait(detail::to_steady_timepoint(abs_time));
+#else
     return do_try_acquirewait(detail::to_system_timepoint(abs_time));
+#endif
+  }
+
+  template<class Duration>
+  bool try_acquire_until(const std::chrono::time_point<std::chrono::system_clock, Duration>& abs_time)
+  {
+    // system_clock deadline waits on CLOCK_REALTIME
+    return do_try_acquirewait(abs_time);
   }
 };
 
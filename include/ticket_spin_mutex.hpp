@@ -0,0 +1,94 @@
+/*
+ * ticket_spin_mutex.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2019 yohhoy
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef YAMC_TICKET_SPIN_MUTEX_HPP_
+#define YAMC_TICKET_SPIN_MUTEX_HPP_
+
+#include <atomic>
+#include "yamc_backoff_spin.hpp"
+
+
+namespace yamc {
+
+/*
+ * ticket spinlock implementation
+ *
+ * - yamc::spin_ticket::mutex
+ * - yamc::spin_ticket::basic_mutex<BackoffPolicy>
+ *
+ * Lock is acquired in FIFO order of ticket number. Waiting thread calls
+ * BackoffPolicy::wait (my_ticket - now_serving) times between each polling,
+ * so that backoff time is proportional to the number of preceding waiters.
+ *
+ * J. M. Mellor-Crummey, M. L. Scott,
+ * "Algorithms for Scalable Synchronization on Shared-Memory Multiprocessors",
+ * ACM Transactions on Computer Systems, 1991.
+ */
+namespace spin_ticket {
+
+template <typename BackoffPolicy>
+class basic_mutex {
+  std::atomic<unsigned int> next_{0};
+  std::atomic<unsigned int> serving_{0};
+
+public:
+  constexpr basic_mutex() noexcept = default;
+  ~basic_mutex() = default;
+
+  basic_mutex(const basic_mutex&) = delete;
+  basic_mutex& operator=(const basic_mutex&) = delete;
+
+  void lock()
+  {
+    typename BackoffPolicy::state state;
+    const unsigned int ticket = next_.fetch_add(1, std::memory_order_relaxed);
+    unsigned int serving;
+    while ((serving = serving_.load(std::memory_order_acquire)) != ticket) {
+      for (unsigned int n = ticket - serving; 0 < n; --n) {
+        BackoffPolicy::wait(state);
+      }
+    }
+  }
+
+  bool try_lock()
+  {
+    unsigned int ticket = serving_.load(std::memory_order_acquire);
+    return next_.compare_exchange_strong(ticket, ticket + 1, std::memory_order_acquire, std::memory_order_relaxed);
+  }
+
+  void unlock()
+  {
+    // only lock owner modifies serving_
+    const unsigned int serving = serving_.load(std::memory_order_relaxed);
+    serving_.store(serving + 1, std::memory_order_release);
+  }
+};
+
+using mutex = basic_mutex<yamc::backoff::proportional<>>;
+
+} // namespace spin_ticket
+} // namespace yamc
+
+#endif
@@ -0,0 +1,147 @@
+/*
+ * ticket_spin_shared_mutex.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2019 yohhoy
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef YAMC_TICKET_SPIN_SHARED_MUTEX_HPP_
+#define YAMC_TICKET_SPIN_SHARED_MUTEX_HPP_
+
+#include <atomic>
+#include <cstdint>
+#include "yamc_backoff_spin.hpp"
+
+
+namespace yamc {
+
+/*
+ * phase-fair ticket reader-writer spinlock (PF-T)
+ *
+ * - yamc::spin_ticket::shared_mutex
+ * - yamc::spin_ticket::basic_shared_mutex<BackoffPolicy>
+ *
+ * Writers are served in FIFO order of ticket number. Writer announces its presence and
+ * phase id in low bits of reader entry counter, then waits for preceding readers to exit.
+ * Readers which arrive while a writer is present wait until the phase id changes, so
+ * reader phases and writer phases alternate (yamc::rwlock::PhaseFairness) at spinlock cost.
+ * Each lock operation is one atomic RMW on reader side.
+ *
+ * B. B. Brandenburg, J. H. Anderson,
+ * "Spin-Based Reader-Writer Synchronization for Multiprocessor Real-Time Systems",
+ * Real-Time Systems, 2010.
+ */
+namespace spin_ticket {
+
+template <typename BackoffPolicy>
+class basic_shared_mutex {
+  static const std::uint32_t reader_unit = 0x100;
+  static const std::uint32_t writer_bits = 0x3;
+  static const std::uint32_t present_bit = 0x2;
+  static const std::uint32_t phase_bit   = 0x1;
+
+  // rin_ := {reader count * reader_unit | writer present bit | phase id}
+  std::atomic<std::uint32_t> rin_{0};
+  std::atomic<std::uint32_t> rout_{0};
+  std::atomic<std::uint32_t> win_{0};
+  std::atomic<std::uint32_t> wout_{0};
+
+  void wait_readers(std::uint32_t rticket)
+  {
+    typename BackoffPolicy::state state;
+    while (rout_.load(std::memory_order_acquire) != rticket) {
+      BackoffPolicy::wait(state);
+    }
+  }
+
+public:
+  constexpr basic_shared_mutex() noexcept = default;
+  ~basic_shared_mutex() = default;
+
+  basic_shared_mutex(const basic_shared_mutex&) = delete;
+  basic_shared_mutex& operator=(const basic_shared_mutex&) = delete;
+
+  void lock()
+  {
+    typename BackoffPolicy::state state;
+    const std::uint32_t ticket = win_.fetch_add(1, std::memory_order_relaxed);
+    while (wout_.load(std::memory_order_acquire) != ticket) {
+      BackoffPolicy::wait(state);
+    }
+    // block subsequent readers, and wait for preceding readers
+    const std::uint32_t w = present_bit | (ticket & phase_bit);
+    const std::uint32_t rticket = rin_.fetch_add(w, std::memory_order_acquire);
+    wait_readers(rticket);
+  }
+
+  bool try_lock()
+  {
+    std::uint32_t ticket = wout_.load(std::memory_order_relaxed);
+    if (!win_.compare_exchange_strong(ticket, ticket + 1, std::memory_order_acquire, std::memory_order_relaxed))
+      return false;
+    std::uint32_t r = rin_.load(std::memory_order_relaxed);
+    if (rout_.load(std::memory_order_acquire) == r
+        && rin_.compare_exchange_strong(r, r | present_bit | (ticket & phase_bit), std::memory_order_acquire, std::memory_order_relaxed))
+      return true;
+    // give up writer ticket
+    wout_.store(ticket + 1, std::memory_order_release);
+    return false;
+  }
+
+  void unlock()
+  {
+    // only lock owner modifies writer bits and wout_
+    rin_.fetch_and(~writer_bits, std::memory_order_release);
+    wout_.store(wout_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  }
+
+  void lock_shared()
+  {
+    typename BackoffPolicy::state state;
+    const std::uint32_t w = rin_.fetch_add(reader_unit, std::memory_order_acquire) & writer_bits;
+    // wait until the present writer leaves (phase id changes or writer bits are cleared)
+    while (w != 0 && w == (rin_.load(std::memory_order_acquire) & writer_bits)) {
+      BackoffPolicy::wait(state);
+    }
+  }
+
+  bool try_lock_shared()
+  {
+    std::uint32_t r = rin_.load(std::memory_order_relaxed);
+    while (!(r & writer_bits)) {
+      if (rin_.compare_exchange_weak(r, r + reader_unit, std::memory_order_acquire, std::memory_order_relaxed))
+        return true;
+    }
+    return false;
+  }
+
+  void unlock_shared()
+  {
+    rout_.fetch_add(reader_unit, std::memory_order_release);
+  }
+};
+
+using shared_mutex = basic_shared_mutex<YAMC_BACKOFF_SPIN_DEFAULT>;
+
+} // namespace spin_ticket
+} // namespace yamc
+
+#endif
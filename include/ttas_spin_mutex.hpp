@@ -27,6 +27,9 @@
 #define YAMC_TTAS_SPIN_MUTEX_HPP_
 
 #include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
 #include "yamc_backoff_spin.hpp"
 
 
@@ -37,30 +40,56 @@ namespace yamc {
  *
  * - yamc::spin_ttas::mutex
  * - yamc::spin_ttas::basic_mutex<BackoffPolicy>
+ * - yamc::spin_ttas::timed_mutex
+ * - yamc::spin_ttas::basic_timed_mutex<BackoffPolicy>
+ * - yamc::spin_ttas::recursive_mutex
+ * - yamc::spin_ttas::basic_recursive_mutex<BackoffPolicy>
+ *
+ * basic_timed_mutex spins on basic_mutex and reads clock at adaptive interval while spinning
+ * (see yamc::backoff::deadline).
+ *
+ * basic_recursive_mutex identifies the owner thread by address of thread-local token
+ * instead of std::this_thread::get_id(), re-entry costs only a relaxed load and
+ * non-atomic increment of recursion depth.
  */
 namespace spin_ttas {
 
+template <typename BackoffPolicy>
+class basic_timed_mutex;
+
 template <typename BackoffPolicy>
 class basic_mutex {
   std::atomic<int> state_{0};
 
-public:
-  basic_mutex() = default;
-  ~basic_mutex() = default;
-
-  basic_mutex(const basic_mutex&) = delete;
-  basic_mutex& operator=(const basic_mutex&) = delete;
+  friend class basic_timed_mutex<BackoffPolicy>;
 
-  void lock()
+  template <typename Deadline>
+  bool acquire(Deadline& dl)
   {
     typename BackoffPolicy::state state;
     int expected;
     do {
       while (state_.load(std::memory_order_relaxed) != 0) {
+        if (dl.expired())
+          return false;
         BackoffPolicy::wait(state);
       }
       expected = 0;
     } while (!state_.compare_exchange_weak(expected, 1, std::memory_order_acquire));
+    return true;
+  }
+
+public:
+  constexpr basic_mutex() noexcept = default;
+  ~basic_mutex() = default;
+
+  basic_mutex(const basic_mutex&) = delete;
+  basic_mutex& operator=(const basic_mutex&) = delete;
+
+  void lock()
+  {
+    backoff::detail::no_deadline dl;
+    acquire(dl);
   }
 
   bool try_lock()
@@ -75,7 +104,115 @@ public:
   }
 };
 
+
+template <typename BackoffPolicy>
+class basic_timed_mutex {
+  basic_mutex<BackoffPolicy> mtx_;
+
+public:
+  constexpr basic_timed_mutex() noexcept = default;
+  ~basic_timed_mutex() = default;
+
+  basic_timed_mutex(const basic_timed_mutex&) = delete;
+  basic_timed_mutex& operator=(const basic_timed_mutex&) = delete;
+
+  void lock()
+  {
+    mtx_.lock();
+  }
+
+  bool try_lock()
+  {
+    return mtx_.try_lock();
+  }
+
+  void unlock()
+  {
+    mtx_.unlock();
+  }
+
+  template<typename Rep, typename Period>
+  bool try_lock_for(const std::chrono::duration<Rep, Period>& duration)
+  {
+    const auto tp = std::chrono::steady_clock::now() + duration;
+    return try_lock_until(tp);
+  }
+
+  template<typename Clock, typename Duration>
+  bool try_lock_until(const std::chrono::time_point<Clock, Duration>& tp)
+  {
+    backoff::deadline<Clock, Duration> dl(tp);
+    return mtx_.acquire(dl);
+  }
+};
+
+
+namespace detail {
+
+// unique token of the current thread
+inline const void* this_thread_token()
+{
+  static thread_local char token;
+  return &token;
+}
+
+} // namespace detail
+
+
+template <typename BackoffPolicy>
+class basic_recursive_mutex {
+  std::atomic<const void*> owner_{nullptr};
+  std::size_t ncount_ = 0;
+  basic_mutex<BackoffPolicy> mtx_;
+
+public:
+  constexpr basic_recursive_mutex() noexcept = default;
+  ~basic_recursive_mutex() = default;
+
+  basic_recursive_mutex(const basic_recursive_mutex&) = delete;
+  basic_recursive_mutex& operator=(const basic_recursive_mutex&) = delete;
+
+  void lock()
+  {
+    // only the current thread stores its own token into owner_
+    const void* token = detail::this_thread_token();
+    if (owner_.load(std::memory_order_relaxed) == token) {
+      ++ncount_;
+    } else {
+      mtx_.lock();
+      owner_.store(token, std::memory_order_relaxed);
+      ncount_ = 1;
+    }
+  }
+
+  bool try_lock()
+  {
+    const void* token = detail::this_thread_token();
+    if (owner_.load(std::memory_order_relaxed) == token) {
+      ++ncount_;
+    } else {
+      if (!mtx_.try_lock())
+        return false;
+      owner_.store(token, std::memory_order_relaxed);
+      ncount_ = 1;
+    }
+    return true;
+  }
+
+  void unlock()
+  {
+    assert(0 < ncount_ && owner_ == detail::this_thread_token());
+    if (--ncount_ == 0) {
+      owner_.store(nullptr, std::memory_order_relaxed);
+      mtx_.unlock();
+    }
+  }
+};
+
+
 using mutex = basic_mutex<YAMC_BACKOFF_SPIN_DEFAULT>;
+using timed_mutex = basic_timed_mutex<YAMC_BACKOFF_SPIN_DEFAULT>;
+using recursive_mutex = basic_recursive_mutex<YAMC_BACKOFF_SPIN_DEFAULT>;
 
 } // namespace spin_ttas
 } // namespace yamc
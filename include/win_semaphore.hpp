@@ -47,6 +47,9 @@
  * - yamc::win::binary_semaphore
  *
  * This implementation use native Win32 semaphore.
+ * Win32 semaphore has no multi-permit wait operation, so multi-permit acquire(n) and
+ * try_acquire_*(n, ...) are not provided; permit-by-permit emulation can't keep large
+ * request from starvation by single-permit acquirers. Use yamc::counting_semaphore.
  * https://docs.microsoft.com/windows/win32/sync/semaphore-objects
  */
 namespace yamc {
@@ -0,0 +1,528 @@
+/*
+ * yamc_async.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2019 yohhoy
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef YAMC_ASYNC_HPP_
+#define YAMC_ASYNC_HPP_
+
+// C++20 coroutines support
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#if __has_include(<coroutine>)
+#define YAMC_ASYNC_SUPPORTED 1
+#endif
+#endif
+#if !defined(YAMC_ASYNC_SUPPORTED)
+#define YAMC_ASYNC_SUPPORTED 0
+#endif
+
+#if YAMC_ASYNC_SUPPORTED
+#include <atomic>
+#include <cassert>
+#include <coroutine>
+#include <cstddef>
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+#include "fair_shared_mutex.hpp"  // yamc::rwlock::TaskFairness/PhaseFairness
+#include "ttas_spin_mutex.hpp"
+
+
+namespace yamc {
+
+/*
+ * coroutine-aware mutex and semaphore (C++20 or later)
+ *
+ * - yamc::async_mutex
+ * - yamc::basic_async_shared_mutex<RwLockFairness>
+ * - yamc::async_shared_mutex
+ * - yamc::async_semaphore
+ *
+ * lock_async() returns awaitable object which suspends the calling coroutine instead of
+ * blocking the thread. Suspended coroutines are queued in FIFO order and the lock is handed
+ * off directly to the front waiter on unlock() (like yamc::fair::*). The waiter is resumed
+ * inline on the unlocking thread, or through Executor passed to lock_async(ex), which is
+ * a callable object invoked as ex(std::coroutine_handle<>) and shall resume it eventually.
+ *
+ * async_mutex keeps waiters in lock-free list. async_shared_mutex and async_semaphore guard
+ * their queue by a short spinlock, no coroutine is resumed while holding the spinlock.
+ *
+ * RwLockFairness:
+ * - yamc::rwlock::TaskFairness: unlock() resumes the front writer, or directly subsequent readers
+ * - yamc::rwlock::PhaseFairness: unlock() resumes the front writer, or all queued readers
+ *
+ * When C++20 coroutines are not available, YAMC_ASYNC_SUPPORTED is 0 and this header
+ * provides nothing.
+ */
+
+namespace detail {
+
+// queue node of suspended coroutine, placed in awaitable object on coroutine frame
+struct async_waiter {
+  async_waiter* next = nullptr;
+  std::coroutine_handle<> handle;
+  void (*schedule)(async_waiter*) = nullptr;
+  bool shared = false;  // shared-lock request of async_shared_mutex
+};
+
+struct inline_executor {
+  void operator()(std::coroutine_handle<> h) const
+  {
+    h.resume();
+  }
+};
+
+template <typename Executor>
+struct async_waiter_for : async_waiter {
+  Executor ex;
+
+  explicit async_waiter_for(Executor e) : ex(std::move(e))
+  {
+    schedule = [](async_waiter* w) {
+      // waiter node gets invalid when resumed coroutine proceeds
+      auto self = static_cast<async_waiter_for*>(w);
+      Executor exec = self->ex;
+      exec(self->handle);
+    };
+  }
+};
+
+// resume list of waiters
+inline void async_resume_all(async_waiter* w)
+{
+  while (w) {
+    async_waiter* next = w->next;
+    w->schedule(w);
+    w = next;
+  }
+}
+
+// FIFO queue of waiters
+class async_waiter_queue {
+  async_waiter* head_ = nullptr;
+  async_waiter* tail_ = nullptr;
+
+public:
+  bool empty() const { return head_ == nullptr; }
+  async_waiter* front() const { return head_; }
+
+  void push_back(async_waiter* w)
+  {
+    w->next = nullptr;
+    if (tail_)
+      tail_->next = w;
+    else
+      head_ = w;
+    tail_ = w;
+  }
+
+  void erase(async_waiter* w, async_waiter* prev)
+  {
+    (prev ? prev->next : head_) = w->next;
+    if (tail_ == w)
+      tail_ = prev;
+    w->next = nullptr;
+  }
+};
+
+} // namespace detail
+
+
+class async_mutex {
+  // state_ := {this=unlocked, nullptr=locked without new waiter, otherwise=LIFO list of new waiters}
+  std::atomic<void*> state_{this};
+  detail::async_waiter* waiters_ = nullptr;  // FIFO list, only accessed by lock owner
+
+  // return false if lock is acquired without suspension
+  bool enqueue(detail::async_waiter* w)
+  {
+    void* s = state_.load(std::memory_order_acquire);
+    for (;;) {
+      if (s == this) {
+        if (state_.compare_exchange_weak(s, nullptr, std::memory_order_acquire, std::memory_order_acquire))
+          return false;
+      } else {
+        w->next = static_cast<detail::async_waiter*>(s);
+        if (state_.compare_exchange_weak(s, w, std::memory_order_release, std::memory_order_acquire))
+          return true;
+      }
+    }
+  }
+
+  template <typename Executor>
+  class lock_awaiter : detail::async_waiter_for<Executor> {
+  protected:
+    async_mutex& mtx_;
+
+  public:
+    lock_awaiter(async_mutex& mtx, Executor ex)
+      : detail::async_waiter_for<Executor>(std::move(ex)), mtx_(mtx) {}
+
+    bool await_ready() { return mtx_.try_lock(); }
+    bool await_suspend(std::coroutine_handle<> h)
+    {
+      this->handle = h;
+      return mtx_.enqueue(this);
+    }
+    void await_resume() {}
+  };
+
+  template <typename Executor>
+  class scoped_lock_awaiter : public lock_awaiter<Executor> {
+  public:
+    using lock_awaiter<Executor>::lock_awaiter;
+
+    std::unique_lock<async_mutex> await_resume()
+    {
+      return std::unique_lock<async_mutex>(this->mtx_, std::adopt_lock);
+    }
+  };
+
+public:
+  async_mutex() = default;
+  ~async_mutex()
+  {
+    assert(state_.load(std::memory_order_relaxed) == this && waiters_ == nullptr);
+  }
+
+  async_mutex(const async_mutex&) = delete;
+  async_mutex& operator=(const async_mutex&) = delete;
+
+  template <typename Executor = detail::inline_executor>
+  lock_awaiter<Executor> lock_async(Executor ex = {})
+  {
+    return {*this, std::move(ex)};
+  }
+
+  /// co_await returns std::unique_lock<async_mutex> which owns the lock
+  template <typename Executor = detail::inline_executor>
+  scoped_lock_awaiter<Executor> scoped_lock_async(Executor ex = {})
+  {
+    return {*this, std::move(ex)};
+  }
+
+  bool try_lock()
+  {
+    void* s = this;
+    return state_.compare_exchange_strong(s, nullptr, std::memory_order_acquire, std::memory_order_relaxed);
+  }
+
+  void unlock()
+  {
+    assert(state_.load(std::memory_order_relaxed) != this);
+    detail::async_waiter* w = waiters_;
+    if (w == nullptr) {
+      void* s = nullptr;
+      if (state_.compare_exchange_strong(s, this, std::memory_order_release, std::memory_order_relaxed))
+        return;
+      // take new waiters, reverse LIFO list into FIFO order
+      s = state_.exchange(nullptr, std::memory_order_acquire);
+      for (auto p = static_cast<detail::async_waiter*>(s); p; ) {
+        detail::async_waiter* next = p->next;
+        p->next = w;
+        w = p;
+        p = next;
+      }
+    }
+    // handoff lock to the front waiter
+    waiters_ = w->next;
+    w->schedule(w);
+  }
+};
+
+
+template <typename RwLockFairness>
+class basic_async_shared_mutex {
+  yamc::spin_ttas::mutex guard_;
+  std::ptrdiff_t state_ = 0;  // {-1=locked, 0=unlocked, N>0=shared-locked by N owners}
+  detail::async_waiter_queue queue_;
+
+  bool acquirable(bool shared) const
+  {
+    return queue_.empty() && (shared ? 0 <= state_ : state_ == 0);
+  }
+
+  // return false if lock is acquired without suspension
+  bool enqueue(detail::async_waiter* w)
+  {
+    std::lock_guard<decltype(guard_)> lk(guard_);
+    if (acquirable(w->shared)) {
+      state_ = w->shared ? state_ + 1 : -1;
+      return false;
+    }
+    queue_.push_back(w);
+    return true;
+  }
+
+  // grant lock to queued waiters, return list of them
+  detail::async_waiter* dispatch()
+  {
+    detail::async_waiter* w = queue_.front();
+    if (w == nullptr)
+      return nullptr;
+    if (!w->shared) {
+      if (state_ != 0)
+        return nullptr;
+      queue_.erase(w, nullptr);
+      state_ = -1;
+      return w;
+    }
+    if (state_ < 0)
+      return nullptr;
+    // shared-lock phase
+    //   TaskFairness: directly subsequent readers
+    //   PhaseFairness: all readers in queue
+    detail::async_waiter* granted = nullptr;
+    detail::async_waiter** link = &granted;
+    detail::async_waiter* prev = nullptr;
+    while (w) {
+      detail::async_waiter* next = w->next;
+      if (w->shared) {
+        queue_.erase(w, prev);
+        *link = w;
+        link = &w->next;
+        ++state_;
+      } else if (RwLockFairness::phased) {
+        prev = w;
+      } else {
+        break;
+      }
+      w = next;
+    }
+    return granted;
+  }
+
+  template <typename Executor, bool Shared>
+  class lock_awaiter : detail::async_waiter_for<Executor> {
+  protected:
+    basic_async_shared_mutex& mtx_;
+
+  public:
+    lock_awaiter(basic_async_shared_mutex& mtx, Executor ex)
+      : detail::async_waiter_for<Executor>(std::move(ex)), mtx_(mtx)
+    {
+      this->shared = Shared;
+    }
+
+    bool await_ready() { return Shared ? mtx_.try_lock_shared() : mtx_.try_lock(); }
+    bool await_suspend(std::coroutine_handle<> h)
+    {
+      this->handle = h;
+      return mtx_.enqueue(this);
+    }
+    void await_resume() {}
+  };
+
+  template <typename Executor>
+  class scoped_lock_awaiter : public lock_awaiter<Executor, false> {
+  public:
+    using lock_awaiter<Executor, false>::lock_awaiter;
+
+    std::unique_lock<basic_async_shared_mutex> await_resume()
+    {
+      return std::unique_lock<basic_async_shared_mutex>(this->mtx_, std::adopt_lock);
+    }
+  };
+
+  template <typename Executor>
+  class scoped_lock_shared_awaiter : public lock_awaiter<Executor, true> {
+  public:
+    using lock_awaiter<Executor, true>::lock_awaiter;
+
+    std::shared_lock<basic_async_shared_mutex> await_resume()
+    {
+      return std::shared_lock<basic_async_shared_mutex>(this->mtx_, std::adopt_lock);
+    }
+  };
+
+public:
+  basic_async_shared_mutex() = default;
+  ~basic_async_shared_mutex()
+  {
+    assert(state_ == 0 && queue_.empty());
+  }
+
+  basic_async_shared_mutex(const basic_async_shared_mutex&) = delete;
+  basic_async_shared_mutex& operator=(const basic_async_shared_mutex&) = delete;
+
+  template <typename Executor = detail::inline_executor>
+  lock_awaiter<Executor, false> lock_async(Executor ex = {})
+  {
+    return {*this, std::move(ex)};
+  }
+
+  /// co_await returns std::unique_lock<> which owns the lock
+  template <typename Executor = detail::inline_executor>
+  scoped_lock_awaiter<Executor> scoped_lock_async(Executor ex = {})
+  {
+    return {*this, std::move(ex)};
+  }
+
+  bool try_lock()
+  {
+    std::lock_guard<decltype(guard_)> lk(guard_);
+    if (!acquirable(false))
+      return false;
+    state_ = -1;
+    return true;
+  }
+
+  void unlock()
+  {
+    detail::async_waiter* w;
+    {
+      std::lock_guard<decltype(guard_)> lk(guard_);
+      assert(state_ == -1);
+      state_ = 0;
+      w = dispatch();
+    }
+    detail::async_resume_all(w);
+  }
+
+  template <typename Executor = detail::inline_executor>
+  lock_awaiter<Executor, true> lock_shared_async(Executor ex = {})
+  {
+    return {*this, std::move(ex)};
+  }
+
+  /// co_await returns std::shared_lock<> which owns the shared lock
+  template <typename Executor = detail::inline_executor>
+  scoped_lock_shared_awaiter<Executor> scoped_lock_shared_async(Executor ex = {})
+  {
+    return {*this, std::move(ex)};
+  }
+
+  bool try_lock_shared()
+  {
+    std::lock_guard<decltype(guard_)> lk(guard_);
+    if (!acquirable(true))
+      return false;
+    ++state_;
+    return true;
+  }
+
+  void unlock_shared()
+  {
+    detail::async_waiter* w = nullptr;
+    {
+      std::lock_guard<decltype(guard_)> lk(guard_);
+      assert(0 < state_);
+      if (--state_ == 0)
+        w = dispatch();
+    }
+    detail::async_resume_all(w);
+  }
+};
+
+using async_shared_mutex = basic_async_shared_mutex<YAMC_RWLOCK_FAIRNESS_DEFAULT>;
+
+
+class async_semaphore {
+  yamc::spin_ttas::mutex guard_;
+  std::ptrdiff_t counter_;
+  detail::async_waiter_queue queue_;
+
+  // return false if a permit is acquired without suspension
+  bool enqueue(detail::async_waiter* w)
+  {
+    std::lock_guard<decltype(guard_)> lk(guard_);
+    if (queue_.empty() && 0 < counter_) {
+      --counter_;
+      return false;
+    }
+    queue_.push_back(w);
+    return true;
+  }
+
+  template <typename Executor>
+  class acquire_awaiter : detail::async_waiter_for<Executor> {
+    async_semaphore& sem_;
+
+  public:
+    acquire_awaiter(async_semaphore& sem, Executor ex)
+      : detail::async_waiter_for<Executor>(std::move(ex)), sem_(sem) {}
+
+    bool await_ready() { return sem_.try_acquire(); }
+    bool await_suspend(std::coroutine_handle<> h)
+    {
+      this->handle = h;
+      return sem_.enqueue(this);
+    }
+    void await_resume() {}
+  };
+
+public:
+  explicit async_semaphore(std::ptrdiff_t desired)
+    : counter_(desired)
+  {
+    assert(0 <= desired);
+  }
+  ~async_semaphore()
+  {
+    assert(queue_.empty());
+  }
+
+  async_semaphore(const async_semaphore&) = delete;
+  async_semaphore& operator=(const async_semaphore&) = delete;
+
+  template <typename Executor = detail::inline_executor>
+  acquire_awaiter<Executor> acquire_async(Executor ex = {})
+  {
+    return {*this, std::move(ex)};
+  }
+
+  bool try_acquire()
+  {
+    std::lock_guard<decltype(guard_)> lk(guard_);
+    if (!queue_.empty() || counter_ <= 0)
+      return false;
+    --counter_;
+    return true;
+  }
+
+  void release(std::ptrdiff_t update = 1)
+  {
+    assert(0 <= update);
+    detail::async_waiter* granted = nullptr;
+    detail::async_waiter** link = &granted;
+    {
+      std::lock_guard<decltype(guard_)> lk(guard_);
+      counter_ += update;
+      // handoff permits to waiters in FIFO order
+      while (0 < counter_ && !queue_.empty()) {
+        detail::async_waiter* w = queue_.front();
+        queue_.erase(w, nullptr);
+        *link = w;
+        link = &w->next;
+        --counter_;
+      }
+    }
+    detail::async_resume_all(granted);
+  }
+};
+
+} // namespace yamc
+
+#endif // YAMC_ASYNC_SUPPORTED
+
+#endif
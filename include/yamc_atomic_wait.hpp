@@ -0,0 +1,338 @@
+/*
+ * yamc_atomic_wait.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2019 yohhoy
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef YAMC_ATOMIC_WAIT_HPP_
+#define YAMC_ATOMIC_WAIT_HPP_
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include "yamc_config.hpp"
+
+#if defined(__linux__)
+// Linux futex
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#define YAMC_FUTEX_LINUX 1
+#elif defined(_WIN32)
+// Windows WaitOnAddress (Windows 8 or later)
+#include <windows.h>
+#pragma comment(lib, "Synchronization.lib")
+#define YAMC_FUTEX_WIN 1
+#elif defined(__APPLE__)
+// macOS ulock (undocumented system call used by libc++)
+extern "C" int __ulock_wait(std::uint32_t operation, void* addr, std::uint64_t value, std::uint32_t timeout);
+extern "C" int __ulock_wake(std::uint32_t operation, void* addr, std::uint64_t wake_value);
+#define YAMC_FUTEX_APPLE 1
+#endif
+
+
+/// Enable futex-like system calls for address-based waiting
+#ifndef YAMC_FUTEX_SUPPORTED
+#if defined(YAMC_FUTEX_LINUX) || defined(YAMC_FUTEX_WIN) || defined(YAMC_FUTEX_APPLE)
+#define YAMC_FUTEX_SUPPORTED 1
+#else
+#define YAMC_FUTEX_SUPPORTED 0
+#endif
+#endif
+
+/// number of entries in hashed wait table
+#ifndef YAMC_ATOMIC_WAIT_TABLE_SIZE
+#define YAMC_ATOMIC_WAIT_TABLE_SIZE 16
+#endif
+
+
+namespace yamc {
+
+/*
+ * address-based wait/notify (equivalent to C++20 std::atomic<T>::wait/notify_*)
+ *
+ * - yamc::atomic_wait(a, old)
+ * - yamc::atomic_wait_until(a, old, abs_time)
+ * - yamc::atomic_notify_one(a)
+ * - yamc::atomic_notify_all(a)
+ *
+ * 4-byte atomic object is waited on directly with futex(2) on Linux, WaitOnAddress on Windows
+ * and __ulock_wait on macOS. Other size of object waits on the version word of wait table
+ * entry selected by its address hash, and notification bumps the version word.
+ * Each table entry counts waiting threads, so notification without waiter doesn't issue
+ * any system call. If no native facility is available (YAMC_FUTEX_SUPPORTED=0), table entry
+ * provides mutex and condition variable as wait queue.
+ *
+ * The caller shall notify after modification of the atomic object, and T shall be
+ * trivially copyable and equality comparable.
+ */
+namespace detail {
+
+/// block current thread while (*addr == expected), spurious wakeup may happen
+inline void futex_wait(const void* addr, std::uint32_t expected)
+{
+  void* p = const_cast<void*>(addr);
+#if defined(YAMC_FUTEX_LINUX)
+  ::syscall(SYS_futex, p, FUTEX_WAIT_PRIVATE, expected, nullptr, nullptr, 0);
+#elif defined(YAMC_FUTEX_WIN)
+  ::WaitOnAddress(p, &expected, sizeof(expected), INFINITE);
+#elif defined(YAMC_FUTEX_APPLE)
+  const std::uint32_t UL_COMPARE_AND_WAIT = 1, ULF_NO_ERRNO = 0x01000000;
+  ::__ulock_wait(UL_COMPARE_AND_WAIT | ULF_NO_ERRNO, p, expected, 0);
+#else
+  (void)p; (void)expected;
+  std::this_thread::yield();
+#endif
+}
+
+/// block current thread while (*addr == expected) at most rel_time
+inline void futex_wait_for(const void* addr, std::uint32_t expected, std::chrono::nanoseconds rel_time)
+{
+  void* p = const_cast<void*>(addr);
+  if (rel_time <= std::chrono::nanoseconds::zero())
+    return;
+#if defined(YAMC_FUTEX_LINUX)
+  struct timespec ts;
+  ts.tv_sec = static_cast<time_t>(rel_time.count() / 1000000000);
+  ts.tv_nsec = static_cast<long>(rel_time.count() % 1000000000);
+  ::syscall(SYS_futex, p, FUTEX_WAIT_PRIVATE, expected, &ts, nullptr, 0);
+#elif defined(YAMC_FUTEX_WIN)
+  const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(rel_time + std::chrono::nanoseconds(999999)).count();
+  ::WaitOnAddress(p, &expected, sizeof(expected), static_cast<DWORD>((ms < INFINITE) ? ms : INFINITE - 1));
+#elif defined(YAMC_FUTEX_APPLE)
+  const std::uint32_t UL_COMPARE_AND_WAIT = 1, ULF_NO_ERRNO = 0x01000000;
+  const auto us = std::chrono::duration_cast<std::chrono::microseconds>(rel_time + std::chrono::nanoseconds(999)).count();
+  ::__ulock_wait(UL_COMPARE_AND_WAIT | ULF_NO_ERRNO, p, expected, static_cast<std::uint32_t>((us < UINT32_MAX) ? us : UINT32_MAX));
+#else
+  (void)p; (void)expected;
+  std::this_thread::yield();
+#endif
+}
+
+/// wake up one thread blocked on addr
+inline void futex_wake_one(const void* addr)
+{
+  void* p = const_cast<void*>(addr);
+#if defined(YAMC_FUTEX_LINUX)
+  ::syscall(SYS_futex, p, FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+#elif defined(YAMC_FUTEX_WIN)
+  ::WakeByAddressSingle(p);
+#elif defined(YAMC_FUTEX_APPLE)
+  const std::uint32_t UL_COMPARE_AND_WAIT = 1, ULF_NO_ERRNO = 0x01000000;
+  ::__ulock_wake(UL_COMPARE_AND_WAIT | ULF_NO_ERRNO, p, 0);
+#else
+  (void)p;
+#endif
+}
+
+/// wake up all threads blocked on addr
+inline void futex_wake_all(const void* addr)
+{
+  void* p = const_cast<void*>(addr);
+#if defined(YAMC_FUTEX_LINUX)
+  ::syscall(SYS_futex, p, FUTEX_WAKE_PRIVATE, INT32_MAX, nullptr, nullptr, 0);
+#elif defined(YAMC_FUTEX_WIN)
+  ::WakeByAddressAll(p);
+#elif defined(YAMC_FUTEX_APPLE)
+  const std::uint32_t UL_COMPARE_AND_WAIT = 1, ULF_NO_ERRNO = 0x01000000, ULF_WAKE_ALL = 0x00000100;
+  ::__ulock_wake(UL_COMPARE_AND_WAIT | ULF_NO_ERRNO | ULF_WAKE_ALL, p, 0);
+#else
+  (void)p;
+#endif
+}
+
+
+struct alignas(YAMC_CACHELINE_SIZE) wait_entry {
+  std::atomic<std::uint32_t> waiters{0};
+  std::atomic<std::uint32_t> version{0};
+#if !YAMC_FUTEX_SUPPORTED
+  std::condition_variable cv;
+  std::mutex mtx;
+#endif
+};
+
+inline wait_entry& wait_table(const void* addr)
+{
+  static wait_entry table[YAMC_ATOMIC_WAIT_TABLE_SIZE];
+  std::uintptr_t h = reinterpret_cast<std::uintptr_t>(addr);
+  h ^= (h >> 6) ^ (h >> 12);
+  return table[h % YAMC_ATOMIC_WAIT_TABLE_SIZE];
+}
+
+template <typename T>
+bool equal_value(const std::atomic<T>& a, const T& old, std::memory_order order)
+{
+  return a.load(order) == old;
+}
+
+struct no_timeout {
+  void wait(const void* addr, std::uint32_t expected) const
+  {
+    futex_wait(addr, expected);
+  }
+  void wait(std::condition_variable& cv, std::unique_lock<std::mutex>& lk) const
+  {
+    cv.wait(lk);
+  }
+};
+
+template <typename Clock, typename Duration>
+struct timeout_at {
+  const std::chrono::time_point<Clock, Duration>& tp;
+  void wait(const void* addr, std::uint32_t expected) const
+  {
+    futex_wait_for(addr, expected, std::chrono::duration_cast<std::chrono::nanoseconds>(tp - Clock::now()));
+  }
+  void wait(std::condition_variable& cv, std::unique_lock<std::mutex>& lk) const
+  {
+    cv.wait_until(lk, tp);
+  }
+};
+
+#if YAMC_FUTEX_SUPPORTED
+// wait on the atomic object itself
+template <typename T, typename Timeout>
+void wait_native(std::true_type, wait_entry&, const std::atomic<T>& a, const T& old, const Timeout& tmo)
+{
+  static_assert(sizeof(std::atomic<T>) == 4, "std::atomic<T> shall have same size as T");
+  std::uint32_t expected;
+  std::memcpy(&expected, &old, sizeof(expected));
+  if (equal_value(a, old, std::memory_order_seq_cst))
+    tmo.wait(&a, expected);
+}
+
+// wait on version word of table entry
+template <typename T, typename Timeout>
+void wait_native(std::false_type, wait_entry& e, const std::atomic<T>& a, const T& old, const Timeout& tmo)
+{
+  const std::uint32_t ver = e.version.load(std::memory_order_acquire);
+  if (equal_value(a, old, std::memory_order_seq_cst))
+    tmo.wait(&e.version, ver);
+}
+
+template <typename T>
+void notify_native(std::true_type, wait_entry&, std::atomic<T>& a, bool all)
+{
+  if (all)
+    futex_wake_all(&a);
+  else
+    futex_wake_one(&a);
+}
+
+template <typename T>
+void notify_native(std::false_type, wait_entry& e, std::atomic<T>&, bool)
+{
+  // version word is shared with other objects, wake up all
+  e.version.fetch_add(1, std::memory_order_release);
+  futex_wake_all(&e.version);
+}
+#endif
+
+template <typename T>
+using is_native_size = std::integral_constant<bool, sizeof(T) == 4>;
+
+/// single blocking step, return when a may be changed (or timeout)
+template <typename T, typename Timeout>
+void wait_step(wait_entry& e, const std::atomic<T>& a, const T& old, const Timeout& tmo)
+{
+  // seq_cst RMW pairs with fence in notify(), see also waiters
+  e.waiters.fetch_add(1, std::memory_order_seq_cst);
+#if YAMC_FUTEX_SUPPORTED
+  wait_native(is_native_size<T>{}, e, a, old, tmo);
+#else
+  {
+    std::unique_lock<std::mutex> lk(e.mtx);
+    if (equal_value(a, old, std::memory_order_seq_cst))
+      tmo.wait(e.cv, lk);
+  }
+#endif
+  e.waiters.fetch_sub(1, std::memory_order_relaxed);
+}
+
+template <typename T>
+void notify(std::atomic<T>& a, bool all)
+{
+  wait_entry& e = wait_table(&a);
+  // pairs with waiters increment in wait_step()
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (e.waiters.load(std::memory_order_relaxed) == 0) {
+    // nobody is waiting
+    return;
+  }
+#if YAMC_FUTEX_SUPPORTED
+  notify_native(is_native_size<T>{}, e, a, all);
+#else
+  (void)all;
+  { std::lock_guard<std::mutex> lk(e.mtx); }
+  e.cv.notify_all();
+#endif
+}
+
+} // namespace detail
+
+
+/// block current thread while (a == old)
+template <typename T>
+void atomic_wait(const std::atomic<T>& a, T old, std::memory_order order = std::memory_order_seq_cst)
+{
+  detail::wait_entry& e = detail::wait_table(&a);
+  while (detail::equal_value(a, old, order)) {
+    detail::wait_step(e, a, old, detail::no_timeout{});
+  }
+}
+
+/// block current thread while (a == old) until abs_time, return false on timeout
+template <typename T, typename Clock, typename Duration>
+bool atomic_wait_until(const std::atomic<T>& a, T old, const std::chrono::time_point<Clock, Duration>& abs_time,
+                       std::memory_order order = std::memory_order_seq_cst)
+{
+  detail::wait_entry& e = detail::wait_table(&a);
+  while (detail::equal_value(a, old, order)) {
+    if (abs_time <= Clock::now())
+      return !detail::equal_value(a, old, order);
+    detail::wait_step(e, a, old, detail::timeout_at<Clock, Duration>{abs_time});
+  }
+  return true;
+}
+
+template <typename T>
+void atomic_notify_one(std::atomic<T>& a)
+{
+  detail::notify(a, false);
+}
+
+template <typename T>
+void atomic_notify_all(std::atomic<T>& a)
+{
+  detail::notify(a, true);
+}
+
+} // namespace yamc
+
+#endif
@@ -26,7 +26,15 @@
 #ifndef YAMC_BACKOFF_SPIN_HPP_
 #define YAMC_BACKOFF_SPIN_HPP_
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <thread>
+#include "yamc_thread_hint.hpp"
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 
 
 /// default backoff spin policy
@@ -41,17 +49,126 @@
 #endif
 
 
+/// spin count for yamc::backoff::proportional<>
+#ifndef YAMC_BACKOFF_PROPORTIONAL_SPINCOUNT
+#define YAMC_BACKOFF_PROPORTIONAL_SPINCOUNT 100
+#endif
+
+/// yield interval for yamc::backoff::proportional<>
+#ifndef YAMC_BACKOFF_PROPORTIONAL_YIELDCOUNT
+#define YAMC_BACKOFF_PROPORTIONAL_YIELDCOUNT 16
+#endif
+
+
+/// minimum/maximum count for yamc::backoff::truncated_exponential<>
+#ifndef YAMC_BACKOFF_TRUNCATED_MINCOUNT
+#define YAMC_BACKOFF_TRUNCATED_MINCOUNT 4
+#endif
+#ifndef YAMC_BACKOFF_TRUNCATED_MAXCOUNT
+#define YAMC_BACKOFF_TRUNCATED_MAXCOUNT 1024
+#endif
+
+
+/// maximum count for yamc::backoff::bounded_random<>
+#ifndef YAMC_BACKOFF_RANDOM_MAXCOUNT
+#define YAMC_BACKOFF_RANDOM_MAXCOUNT 64
+#endif
+
+
+/// maximum interval of clock reading in timed spinlock
+#ifndef YAMC_BACKOFF_DEADLINE_CHECKCOUNT
+#define YAMC_BACKOFF_DEADLINE_CHECKCOUNT 64
+#endif
+
+/// maximum time [usec] between clock readings to widen the interval in timed spinlock
+#ifndef YAMC_BACKOFF_DEADLINE_CHECKTIME
+#define YAMC_BACKOFF_DEADLINE_CHECKTIME 10
+#endif
+
+
 namespace yamc {
 
 /*
  * backoff algorithm for spinlock basic_mutex<BackoffPolicy>
  *
  * - yamc::backoff::exponential<InitCount>
+ * - yamc::backoff::proportional<SpinCount, YieldCount>
+ * - yamc::backoff::truncated_exponential<MinCount, MaxCount>
+ * - yamc::backoff::bounded_random<MaxCount>
  * - yamc::backoff::yield
  * - yamc::backoff::busy
+ *
+ * timed spinlock basic_timed_mutex<BackoffPolicy> checks deadline with
+ * yamc::backoff::deadline<Clock, Duration, CheckCount>.
  */
 namespace backoff {
 
+/// spin-wait hint for processor (x86 PAUSE / ARM YIELD instruction)
+inline void cpu_relax()
+{
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+  ::_mm_pause();
+#elif defined(_MSC_VER) && (defined(_M_ARM) || defined(_M_ARM64))
+  ::__yield();
+#elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+  __builtin_ia32_pause();
+#elif defined(__GNUC__) && (defined(__aarch64__) || defined(__arm__))
+  __asm__ __volatile__("yield");
+#else
+  // compiler barrier at least
+  std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+
+namespace detail {
+
+/// xorshift32 pseudo random number generator
+///
+/// Address of backoff state alone repeats on each lock() call, and often matches between
+/// threads with the same stack layout. So seed also mixes per-thread sequence, which starts
+/// from scrambled thread hint and advances on each construction.
+///
+class xorshift32 {
+  std::uint32_t x_;
+
+  // splitmix64 finalizer
+  static std::uint64_t mix(std::uint64_t v)
+  {
+    v = (v ^ (v >> 30)) * 0xBF58476D1CE4E5B9ull;
+    v = (v ^ (v >> 27)) * 0x94D049BB133111EBull;
+    return v ^ (v >> 31);
+  }
+
+public:
+  explicit xorshift32(const void* seed)
+  {
+    static thread_local std::uint64_t seq = mix(yamc::detail::this_thread_slot_hint());
+    seq += 0x9E3779B97F4A7C15ull;
+    const std::uint64_t v = mix(seq ^ static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(seed)));
+    x_ = static_cast<std::uint32_t>(v >> 32) | 1u;
+  }
+
+  std::uint32_t operator()()
+  {
+    x_ ^= x_ << 13;
+    x_ ^= x_ >> 17;
+    x_ ^= x_ << 5;
+    return x_;
+  }
+};
+
+/// deadline which never expires, for untimed lock()
+struct no_deadline {
+  bool expired() const
+  {
+    return false;
+  }
+};
+
+} // namespace detail
+
+
 /// exponential backoff spin policy
 template <
   unsigned int InitCount = YAMC_BACKOFF_EXPONENTIAL_INITCOUNT
@@ -75,6 +192,88 @@ struct exponential {
 };
 
 
+/// proportional backoff spin policy
+///
+/// wait() spins constant SpinCount times on each call, and yield thread once
+/// every YieldCount calls. Queue-based spinlock such as yamc::spin_ticket::basic_mutex<>
+/// calls wait() in proportion to the number of preceding waiters.
+///
+template <
+  unsigned int SpinCount = YAMC_BACKOFF_PROPORTIONAL_SPINCOUNT,
+  unsigned int YieldCount = YAMC_BACKOFF_PROPORTIONAL_YIELDCOUNT
+>
+struct proportional {
+  struct state {
+    unsigned int counter = YieldCount;
+  };
+
+  static void wait(state& s)
+  {
+    for (unsigned int i = 0; i < SpinCount; ++i) {
+      cpu_relax();
+    }
+    if (--s.counter == 0) {
+      std::this_thread::yield();
+      s.counter = YieldCount;
+    }
+  }
+};
+
+
+/// truncated exponential backoff spin policy with (full) jitter
+///
+/// wait() spins random count in [0, limit), the limit is doubled from MinCount until MaxCount.
+/// After reaching MaxCount, yield thread at each wait.
+///
+template <
+  unsigned int MinCount = YAMC_BACKOFF_TRUNCATED_MINCOUNT,
+  unsigned int MaxCount = YAMC_BACKOFF_TRUNCATED_MAXCOUNT
+>
+struct truncated_exponential {
+  static_assert(0 < MinCount && MinCount <= MaxCount, "invalid MinCount/MaxCount");
+
+  struct state {
+    unsigned int limit = MinCount;
+    detail::xorshift32 rng{this};
+  };
+
+  static void wait(state& s)
+  {
+    for (unsigned int n = s.rng() % s.limit; 0 < n; --n) {
+      cpu_relax();
+    }
+    if (s.limit < MaxCount) {
+      s.limit = (std::min)(s.limit * 2, MaxCount);
+    } else {
+      std::this_thread::yield();
+    }
+  }
+};
+
+
+/// bounded random backoff spin policy
+///
+/// wait() spins random count in [1, MaxCount].
+///
+template <
+  unsigned int MaxCount = YAMC_BACKOFF_RANDOM_MAXCOUNT
+>
+struct bounded_random {
+  static_assert(0 < MaxCount, "invalid MaxCount");
+
+  struct state {
+    detail::xorshift32 rng{this};
+  };
+
+  static void wait(state& s)
+  {
+    for (unsigned int n = s.rng() % MaxCount + 1; 0 < n; --n) {
+      cpu_relax();
+    }
+  }
+};
+
+
 /// simple yield thread policy
 struct yield {
   struct state {};
@@ -96,6 +295,51 @@ struct busy {
   static void wait(state&) {}
 };
 
+
+/// deadline checker for timed spinlock
+///
+/// expired() reads Clock on the first call, then the interval of clock reading adapts
+/// to the cost of backoff wait between calls: it doubles up to CheckCount calls while
+/// successive readings are less than YAMC_BACKOFF_DEADLINE_CHECKTIME apart, and drops
+/// back to every call otherwise (e.g. the policy yields thread). So that busy-waiting loop
+/// doesn't pay clock reading cost on each iteration, and the deadline is overrun only by
+/// about YAMC_BACKOFF_DEADLINE_CHECKTIME plus one backoff wait.
+///
+template <
+  typename Clock,
+  typename Duration,
+  unsigned int CheckCount = YAMC_BACKOFF_DEADLINE_CHECKCOUNT
+>
+class deadline {
+  static_assert(0 < CheckCount, "invalid CheckCount");
+
+  const std::chrono::time_point<Clock, Duration>& tp_;
+  typename Clock::time_point last_{};
+  unsigned int interval_ = 1;
+  unsigned int counter_ = 0;
+
+public:
+  explicit deadline(const std::chrono::time_point<Clock, Duration>& tp)
+    : tp_(tp) {}
+
+  bool expired()
+  {
+    if (++counter_ < interval_)
+      return false;
+    counter_ = 0;
+    const auto now = Clock::now();
+    if (tp_ <= now)
+      return true;
+    if (now - last_ < std::chrono::microseconds(YAMC_BACKOFF_DEADLINE_CHECKTIME)) {
+      interval_ = (std::min)(interval_ * 2, CheckCount);
+    } else {
+      interval_ = 1;
+    }
+    last_ = now;
+    return false;
+  }
+};
+
 } // namespace backoff
 } // namespace yamc
 
@@ -26,17 +26,23 @@
 #ifndef YAMC_BARRIER_HPP_
 #define YAMC_BARRIER_HPP_
 
+#include <atomic>
 #include <cassert>
 #include <cstddef>
-#include <condition_variable>
 #include <limits>
-#include <mutex>
+#include <utility>
+#include "yamc_wait_policy.hpp"
 
 
 /*
  * Barriers in C++20 Standard Library
  *
- * - yamc::barrier<CompletionFunction>
+ * - yamc::barrier<CompletionFunction, WaitPolicy>
+ *
+ * Arrival is a single atomic operation on counter, the last arrival runs the completion
+ * function and moves to next phase. No internal lock is held while running the completion
+ * function, the phase word is advanced after it returns. Waiting threads wait on the phase
+ * word by WaitPolicy (default yamc::wait_policy::park).
  */
 namespace yamc {
 
@@ -57,24 +63,24 @@ struct barrier_arrival_token {
 } // namespace detail
 
 
-template <class CompletionFunction = detail::default_barrier_completion>
+template <
+  class CompletionFunction = detail::default_barrier_completion,
+  class WaitPolicy = yamc::wait_policy::park
+>
 class barrier {
-  std::ptrdiff_t init_count_;
-  std::ptrdiff_t counter_;
-  unsigned phase_ = 0;
+  std::ptrdiff_t init_count_;  // modified only in phase completion step
+  std::atomic<std::ptrdiff_t> counter_;
+  std::atomic<std::ptrdiff_t> ndrop_{0};
+  std::atomic<unsigned> phase_{0};
   CompletionFunction completion_;
-  mutable std::condition_variable cv_;
-  mutable std::mutex mtx_;
 
-  void phase_completion_step(bool drop)
+  void phase_completion_step(unsigned phase)
   {
     completion_();
-    if (drop) {
-      --init_count_;
-    }
-    counter_ = init_count_;
-    ++phase_;
-    cv_.notify_all();
+    init_count_ -= ndrop_.exchange(0, std::memory_order_relaxed);
+    counter_.store(init_count_, std::memory_order_relaxed);
+    phase_.store(phase + 1, std::memory_order_release);
+    WaitPolicy::notify_all(phase_);
   }
 
 public:
@@ -103,51 +109,33 @@ public:
 #endif
   arrival_token arrive(std::ptrdiff_t update = 1)
   {
-    std::lock_guard<decltype(mtx_)> lk(mtx_);
-    assert(0 < update && update <= counter_);
-    arrival_token token{phase_};
-    counter_ -= update;
-    if (counter_ == 0) {
-      phase_completion_step(false);
+    const unsigned phase = phase_.load(std::memory_order_acquire);
+    const std::ptrdiff_t old = counter_.fetch_sub(update, std::memory_order_acq_rel);
+    assert(0 < update && update <= old);
+    if (old == update) {
+      phase_completion_step(phase);
     }
-    return token;
+    return arrival_token{phase};
   }
 
   void wait(arrival_token&& arrival) const
   {
-    std::unique_lock<decltype(mtx_)> lk(mtx_);
-    while (phase_ <= arrival.phase_) {
-      cv_.wait(lk);
+    while (phase_.load(std::memory_order_acquire) == arrival.phase_) {
+      WaitPolicy::wait(phase_, arrival.phase_, std::memory_order_acquire);
     }
   }
 
   void arrive_and_wait()
   {
     // equivalent to wait(arrive())
-    std::unique_lock<decltype(mtx_)> lk(mtx_);
-    assert(0 < counter_);
-    auto arrival_phase = phase_;
-    counter_ -= 1;
-    if (counter_ == 0) {
-      phase_completion_step(false);
-    }
-    while (phase_ <= arrival_phase) {
-      cv_.wait(lk);
-    }
+    wait(arrive());
   }
 
   void arrive_and_drop()
   {
-    std::unique_lock<decltype(mtx_)> lk(mtx_);
-    assert(0 < counter_);
-    auto arrival_phase = phase_;
-    counter_ -= 1;
-    if (counter_ == 0) {
-      phase_completion_step(true);
-    }
-    while (phase_ <= arrival_phase) {
-      cv_.wait(lk);
-    }
+    // decrement expected count from next phase
+    ndrop_.fetch_add(1, std::memory_order_relaxed);
+    wait(arrive());
   }
 };
 
@@ -0,0 +1,148 @@
+/*
+ * yamc_checked_sampling.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2019 yohhoy
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef YAMC_CHECKED_SAMPLING_HPP_
+#define YAMC_CHECKED_SAMPLING_HPP_
+
+#include <atomic>
+
+
+/// enable sampled validation of checked mutexes (0=every object validates requirements)
+#ifndef YAMC_CHECKED_SAMPLING
+#define YAMC_CHECKED_SAMPLING 0
+#endif
+
+/// default sampling rate of checked mutex objects (0=none, 1=all, N=one in every N objects)
+#ifndef YAMC_CHECKED_SAMPLING_RATE
+#define YAMC_CHECKED_SAMPLING_RATE 1
+#endif
+
+
+namespace yamc {
+
+/*
+ * sampling policy of checked mutexes
+ *
+ * Each checked mutex object decides at construction whether it is "sampled" or not.
+ * Sampled object validates all requirements as usual, unsampled object bypasses every
+ * operation to the native primitive without ownership tracking nor deadlock detection.
+ * One in every N objects is sampled, N is YAMC_CHECKED_SAMPLING_RATE by default and
+ * can be changed by sampling::set_rate() on run-time. Constructor with bool argument
+ * explicitly chooses sampled (true) or unsampled (false) object regardless of the rate.
+ *
+ * Sampling is enabled by YAMC_CHECKED_SAMPLING=1, then each object carries sampled flag
+ * and native primitive for forwarding (checked::mutex reuses its inner std::mutex).
+ * Otherwise every object is sampled, and checked mutexes have neither extra storage nor
+ * branch on sampled flag.
+ */
+namespace checked {
+
+class sampling {
+  static std::atomic<unsigned>& rate_ref()
+  {
+    static std::atomic<unsigned> rate{YAMC_CHECKED_SAMPLING_RATE};
+    return rate;
+  }
+
+  static std::atomic<unsigned>& counter_ref()
+  {
+    static std::atomic<unsigned> counter{0};
+    return counter;
+  }
+
+public:
+  static unsigned rate() noexcept
+  {
+    return rate_ref().load(std::memory_order_relaxed);
+  }
+
+  static void set_rate(unsigned n) noexcept
+  {
+    rate_ref().store(n, std::memory_order_relaxed);
+  }
+
+  /// decide whether new object is sampled
+  static bool select() noexcept
+  {
+    const unsigned n = rate();
+    if (n <= 1)
+      return (n == 1);
+    return counter_ref().fetch_add(1, std::memory_order_relaxed) % n == 0;
+  }
+};
+
+
+namespace detail {
+
+#if YAMC_CHECKED_SAMPLING
+// base class of checked mutex
+template <typename RawMutex>
+struct bypass {
+  const bool sampled_;
+  RawMutex raw_;  // native primitive for unsampled object
+
+  explicit bypass(bool s) : sampled_(s) {}
+};
+
+// unsampled object forwards to inner mutex of checking state
+template <>
+struct bypass<void> {
+  const bool sampled_;
+
+  explicit bypass(bool s) : sampled_(s) {}
+};
+#else
+// forwarding path is never taken
+struct null_raw {
+  static void lock() {}
+  static bool try_lock() { return false; }
+  static void unlock() {}
+  static void lock_shared() {}
+  static bool try_lock_shared() { return false; }
+  static void unlock_shared() {}
+  template <typename T> static bool try_lock_for(const T&) { return false; }
+  template <typename T> static bool try_lock_until(const T&) { return false; }
+  template <typename T> static bool try_lock_shared_for(const T&) { return false; }
+  template <typename T> static bool try_lock_shared_until(const T&) { return false; }
+};
+
+// base class of checked mutex, every object is sampled (empty base)
+template <typename RawMutex>
+struct bypass {
+  static constexpr bool sampled_ = true;
+  static constexpr null_raw raw_{};
+
+  explicit bypass(bool) {}
+};
+
+template <typename RawMutex>
+constexpr null_raw bypass<RawMutex>::raw_;
+#endif
+
+} // namespace detail
+} // namespace checked
+} // namespace yamc
+
+#endif
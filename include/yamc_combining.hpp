@@ -0,0 +1,232 @@
+/*
+ * yamc_combining.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2019 yohhoy
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef YAMC_COMBINING_HPP_
+#define YAMC_COMBINING_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "ttas_spin_mutex.hpp"
+#include "yamc_backoff_spin.hpp"
+#include "yamc_config.hpp"
+#include "yamc_thread_hint.hpp"
+
+
+/// number of publication slots of yamc::combining<T, Mutex>
+#ifndef YAMC_COMBINING_SLOTS
+#define YAMC_COMBINING_SLOTS 32
+#endif
+
+/// spin count of waiting request before blocking on mutex
+#ifndef YAMC_COMBINING_SPIN_COUNT
+#define YAMC_COMBINING_SPIN_COUNT 100
+#endif
+
+/// interval of spin iterations between try_lock() on mutex by waiting request
+#ifndef YAMC_COMBINING_TRYLOCK_INTERVAL
+#define YAMC_COMBINING_TRYLOCK_INTERVAL 16
+#endif
+
+
+/*
+ * Flat combining
+ *
+ * - yamc::combining<T, Mutex>
+ *
+ * apply(f) publishes a request of f(T&) into a cache-line-padded slot which is selected by
+ * per-thread hint, then the thread which acquires Mutex becomes "combiner" and executes all
+ * pending requests in a batch while T stays hot in its cache. Other threads spin on their
+ * own request (allocated on stack) until it is done, so that T's cache lines are not dragged
+ * to each core. Waiting thread tries Mutex only once every YAMC_COMBINING_TRYLOCK_INTERVAL
+ * iterations to keep RMW traffic off the lock's cache line. When all YAMC_COMBINING_SLOTS
+ * slots are in use, apply(f) executes f directly under Mutex.
+ * Slots are aligned to cache line, also when the object is allocated by new-expression.
+ *
+ * f is invoked exactly once by arbitrary thread, its result (or exception) is returned to
+ * the caller of apply(f).
+ *
+ * D. Hendler, I. Incze, N. Shavit, M. Tzafrir, "Flat Combining and the Synchronization-
+ * Parallelism Tradeoff", SPAA 2010.
+ */
+namespace yamc {
+
+namespace detail {
+
+template <typename R>
+class combining_result {
+  typename std::aligned_storage<sizeof(R), alignof(R)>::type buf_;
+  bool valid_ = false;
+
+public:
+  combining_result() = default;
+  ~combining_result()
+  {
+    if (valid_)
+      reinterpret_cast<R*>(&buf_)->~R();
+  }
+
+  combining_result(const combining_result&) = delete;
+  combining_result& operator=(const combining_result&) = delete;
+
+  template <typename F, typename T>
+  void invoke(F& f, T& data)
+  {
+    ::new (static_cast<void*>(&buf_)) R(f(data));
+    valid_ = true;
+  }
+
+  R get()
+  {
+    return std::move(*reinterpret_cast<R*>(&buf_));
+  }
+};
+
+template <>
+class combining_result<void> {
+public:
+  template <typename F, typename T>
+  void invoke(F& f, T& data)
+  {
+    f(data);
+  }
+
+  void get() {}
+};
+
+} // namespace detail
+
+
+template <typename T, typename Mutex = yamc::spin_ttas::mutex>
+class combining : public yamc::detail::cacheline_aligned_new {
+  struct request {
+    void (*invoke)(request*, T&);
+    std::exception_ptr error;
+    std::atomic<bool> done{false};
+  };
+
+  template <typename F, typename R>
+  struct request_for : request {
+    F& f;
+    detail::combining_result<R> result;
+
+    explicit request_for(F& fn) : f(fn)
+    {
+      this->invoke = [](request* r, T& data) {
+        auto self = static_cast<request_for*>(r);
+        self->result.invoke(self->f, data);
+      };
+    }
+  };
+
+  struct alignas(YAMC_CACHELINE_SIZE) slot {
+    std::atomic<request*> req{nullptr};
+  };
+
+  slot slots_[YAMC_COMBINING_SLOTS];
+  Mutex mtx_;
+  T data_;
+
+  bool publish(request* r)
+  {
+    const std::size_t hint = detail::this_thread_slot_hint();
+    for (std::size_t i = 0; i < YAMC_COMBINING_SLOTS; i++) {
+      slot& s = slots_[(hint + i) % YAMC_COMBINING_SLOTS];
+      request* expected = nullptr;
+      if (s.req.load(std::memory_order_relaxed) == nullptr
+          && s.req.compare_exchange_strong(expected, r, std::memory_order_release, std::memory_order_relaxed))
+        return true;
+    }
+    return false;
+  }
+
+  // execute all pending requests while holding mtx_
+  void combine()
+  {
+    for (slot& s : slots_) {
+      request* r = s.req.load(std::memory_order_acquire);
+      if (r == nullptr)
+        continue;
+      try {
+        r->invoke(r, data_);
+      } catch (...) {
+        r->error = std::current_exception();
+      }
+      s.req.store(nullptr, std::memory_order_relaxed);
+      // request object gets invalid after its owner returns
+      r->done.store(true, std::memory_order_release);
+    }
+  }
+
+public:
+  using value_type = T;
+  using mutex_type = Mutex;
+
+  combining() : data_() {}
+  explicit combining(const T& value) : data_(value) {}
+  explicit combining(T&& value) : data_(std::move(value)) {}
+
+  ~combining() = default;
+
+  combining(const combining&) = delete;
+  combining& operator=(const combining&) = delete;
+
+  /// execute f(T&) under mutual exclusion, return its result
+  template <typename F>
+  auto apply(F f) -> typename std::decay<decltype(f(std::declval<T&>()))>::type
+  {
+    using result_type = typename std::decay<decltype(f(std::declval<T&>()))>::type;
+    request_for<F, result_type> req(f);
+    if (!publish(&req)) {
+      // no free slot, fallback to normal locking
+      std::lock_guard<Mutex> lk(mtx_);
+      return f(data_);
+    }
+    for (unsigned spin = 0; !req.done.load(std::memory_order_acquire); spin++) {
+      if (spin < YAMC_COMBINING_SPIN_COUNT) {
+        if (spin % YAMC_COMBINING_TRYLOCK_INTERVAL != 0 || !mtx_.try_lock()) {
+          yamc::backoff::cpu_relax();
+          continue;
+        }
+      } else {
+        mtx_.lock();
+      }
+      // become combiner, my request is also done
+      combine();
+      mtx_.unlock();
+    }
+    if (req.error)
+      std::rethrow_exception(req.error);
+    return req.result.get();
+  }
+};
+
+} // namespace yamc
+
+#endif
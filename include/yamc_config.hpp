@@ -0,0 +1,93 @@
+/*
+ * yamc_config.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2019 yohhoy
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef YAMC_CONFIG_HPP_
+#define YAMC_CONFIG_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+
+/// cache line size to avoid false sharing
+#ifndef YAMC_CACHELINE_SIZE
+#define YAMC_CACHELINE_SIZE 64
+#endif
+
+
+namespace yamc {
+namespace detail {
+
+static_assert((YAMC_CACHELINE_SIZE & (YAMC_CACHELINE_SIZE - 1)) == 0,
+              "YAMC_CACHELINE_SIZE shall be power of two");
+
+/*
+ * dynamic allocation aligned to cache line
+ *
+ * Before C++17, operator new guarantees only alignof(std::max_align_t) and silently ignores
+ * alignas(YAMC_CACHELINE_SIZE) of the allocated type. Types which contain cache line aligned
+ * members derive from this class, so that new-expression over-allocates and aligns storage.
+ * Allocation via std::allocator (e.g. std::make_shared, std::vector) is not covered.
+ */
+struct cacheline_aligned_new {
+  static void* operator new(std::size_t size)
+  {
+    return allocate(size);
+  }
+  static void* operator new[](std::size_t size)
+  {
+    return allocate(size);
+  }
+  static void operator delete(void* p) noexcept
+  {
+    deallocate(p);
+  }
+  static void operator delete[](void* p) noexcept
+  {
+    deallocate(p);
+  }
+
+private:
+  static void* allocate(std::size_t size)
+  {
+    // raw storage is aligned at least to pointer, so there is always room to stash it
+    void* raw = ::operator new(size + YAMC_CACHELINE_SIZE);
+    const std::uintptr_t addr = (reinterpret_cast<std::uintptr_t>(raw) + YAMC_CACHELINE_SIZE)
+                              & ~static_cast<std::uintptr_t>(YAMC_CACHELINE_SIZE - 1);
+    void* p = reinterpret_cast<void*>(addr);
+    static_cast<void**>(p)[-1] = raw;
+    return p;
+  }
+  static void deallocate(void* p) noexcept
+  {
+    if (p)
+      ::operator delete(static_cast<void**>(p)[-1]);
+  }
+};
+
+} // namespace detail
+} // namespace yamc
+
+#endif
@@ -26,24 +26,38 @@
 #ifndef YAMC_LATCH_HPP_
 #define YAMC_LATCH_HPP_
 
+#include <atomic>
 #include <cassert>
 #include <cstddef>
-#include <condition_variable>
+#include <cstdint>
 #include <limits>
-#include <mutex>
+#include "yamc_wait_policy.hpp"
+
+
+/// spin count of yamc::latch::wait() before blocking
+#ifndef YAMC_LATCH_SPINCOUNT
+#define YAMC_LATCH_SPINCOUNT 100
+#endif
 
 
 /*
  * Latches in C++20 Standard Library
  *
+ * - yamc::basic_latch<WaitPolicy>
  * - yamc::latch
+ *
+ * count_down() is a single atomic operation on counter, only the final arrival
+ * sets 32-bit completion word and notifies waiting threads. wait() waits on the
+ * completion word by WaitPolicy (ptrdiff_t counter isn't directly waitable),
+ * yamc::latch spins YAMC_LATCH_SPINCOUNT times before blocking
+ * (yamc::wait_policy::spin_then_park).
  */
 namespace yamc {
 
-class latch {
-  std::ptrdiff_t counter_;
-  mutable std::condition_variable cv_;
-  mutable std::mutex mtx_;
+template <typename WaitPolicy>
+class basic_latch {
+  std::atomic<std::ptrdiff_t> counter_;
+  std::atomic<std::int32_t> done_;  // 1 after final arrival
 
 public:
   static constexpr ptrdiff_t (max)() noexcept
@@ -51,57 +65,52 @@ public:
     return (std::numeric_limits<ptrdiff_t>::max)();
   }
 
-  /*constexpr*/ explicit latch(std::ptrdiff_t expected)
+  /*constexpr*/ explicit basic_latch(std::ptrdiff_t expected)
     : counter_(expected)
+    , done_(expected == 0 ? 1 : 0)
   {
     assert(0 <= expected && expected < (max)());
   }
 
-  ~latch() = default;
+  ~basic_latch() = default;
 
-  latch(const latch&) = delete;
-  latch& operator=(const latch&) = delete;
+  basic_latch(const basic_latch&) = delete;
+  basic_latch& operator=(const basic_latch&) = delete;
 
   void count_down(std::ptrdiff_t update = 1)
   {
-    std::lock_guard<decltype(mtx_)> lk(mtx_);
-    assert(0 <= update && update <= counter_);
-    counter_ -= update;
-    if (counter_ == 0) {
-      cv_.notify_all();
+    const std::ptrdiff_t old = counter_.fetch_sub(update, std::memory_order_acq_rel);
+    assert(0 <= update && update <= old);
+    if (old == update) {
+      // final arrival
+      done_.store(1, std::memory_order_release);
+      WaitPolicy::notify_all(done_);
     }
   }
 
   bool try_wait() const noexcept
   {
-    std::lock_guard<decltype(mtx_)> lk(mtx_);
     // no spurious failure
-    return (counter_ == 0);
+    return (counter_.load(std::memory_order_acquire) == 0);
   }
 
   void wait() const
   {
-    std::unique_lock<decltype(mtx_)> lk(mtx_);
-    while (counter_ != 0) {
-      cv_.wait(lk);
+    while (done_.load(std::memory_order_acquire) == 0) {
+      WaitPolicy::wait(done_, std::int32_t(0), std::memory_order_acquire);
     }
   }
 
   void arrive_and_wait(std::ptrdiff_t update = 1)
   {
-    std::unique_lock<decltype(mtx_)> lk(mtx_);
     // equivalent to { count_down(update); wait(); }
-    assert(0 <= update && update <= counter_);
-    counter_ -= update;
-    if (counter_ == 0) {
-      cv_.notify_all();
-    }
-    while (counter_ != 0) {
-      cv_.wait(lk);
-    }
+    count_down(update);
+    wait();
   }
 };
 
+using latch = basic_latch<yamc::wait_policy::spin_then_park<YAMC_LATCH_SPINCOUNT>>;
+
 } // namespace yamc
 
 #endif
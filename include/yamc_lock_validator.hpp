@@ -29,10 +29,13 @@
 #include <cassert>
 #include <cstdint>
 #include <algorithm>
+#include <functional>
 #include <iostream>
 #include <mutex>
 #include <thread>
 #include <unordered_map>
+#include <unordered_set>
+#include <utility>
 #include <vector>
 
 
@@ -40,6 +43,11 @@
 #define YAMC_CHECK_VERBOSE 0
 #endif
 
+/// number of shards of lock-order edge cache
+#ifndef YAMC_VALIDATOR_SHARDS
+#define YAMC_VALIDATOR_SHARDS 16
+#endif
+
 namespace yamc {
 
 /*
@@ -47,30 +55,113 @@ namespace yamc {
  *
  * - yamc::validator::deadlock
  * - yamc::validator::null
+ *
+ * yamc::validator::deadlock is lockdep-style validator; each thread records its held locks
+ * in thread-local stack, and blocking acquisition of mutex B while holding mutex A adds
+ * A->B edge to global lock-order graph. When new edge makes a cycle (lock order inversion),
+ * it reports potential deadlock even if threads don't actually block.
+ * Known edges are cached in sharded table, new edge insertion and cycle check only take
+ * the graph lock. Both shared-lock edges (S->S) are ignored, they never deadlock
+ * without pending writers.
+ *
+ * Global state is a constant-initialized static member, so that checked mutex is usable
+ * during static initialization and no guard of function-local static is checked on each call.
+ * Edge table and graph are allocated on first use and never deallocated.
  */
 namespace validator {
 
 class deadlock {
 private:
-  struct entry {
+  struct held_lock {
+    uintptr_t mkey;
+    bool shared;
+  };
+  using edge = std::pair<uintptr_t, uintptr_t>;
+
+  struct edge_hash {
+    std::size_t operator()(const edge& e) const
+    {
+      return std::hash<uintptr_t>{}(e.first) ^ (std::hash<uintptr_t>{}(e.second) * 31);
+    }
+  };
+
+  struct edge_shard {
+    std::mutex mtx;
+    std::unordered_set<edge, edge_hash>* edges = nullptr;  // guarded by mtx
+  };
+
+  struct graph_node {
     std::size_t mid;
-    std::vector<std::thread::id> owners;
-    std::vector<std::thread::id> waiters;
+    std::vector<uintptr_t> out;  // locked after this mutex
+    std::vector<uintptr_t> in;   // locked before this mutex
   };
-  using mutexmap_type = std::unordered_map<uintptr_t, entry>;
+  using graph_type = std::unordered_map<uintptr_t, graph_node>;
 
-  struct table_ref {
+  struct graph_ref {
     std::unique_lock<std::mutex> lk;
-    mutexmap_type& mutexmap;
+    graph_type& graph;
     std::size_t& counter;
   };
 
-  static table_ref global_table()
+  struct global_state {
+    edge_shard shards[YAMC_VALIDATOR_SHARDS];
+    std::mutex guard;
+    graph_type* graph = nullptr;  // guarded by guard
+    std::size_t counter = 0;      // guarded by guard
+  };
+
+  // static data member of class template can be defined in header
+  template <typename = void>
+  struct global_holder {
+    static global_state state;
+  };
+
+  static std::vector<held_lock>& held_locks()
+  {
+    static thread_local std::vector<held_lock> held;
+    return held;
+  }
+
+  static edge_shard& shard_of(const edge& e)
+  {
+    return global_holder<>::state.shards[edge_hash{}(e) % YAMC_VALIDATOR_SHARDS];
+  }
+
+  static graph_ref global_graph()
+  {
+    global_state& g = global_holder<>::state;
+    std::unique_lock<std::mutex> lk(g.guard);
+    if (!g.graph)
+      g.graph = new graph_type;
+    return { std::move(lk), *g.graph, g.counter };
+  }
+
+  static bool is_cached(const edge& e)
+  {
+    auto& shard = shard_of(e);
+    std::lock_guard<std::mutex> lk(shard.mtx);
+    return shard.edges && shard.edges->count(e) != 0;
+  }
+
+  static void cache_edge(const edge& e, bool insert)
+  {
+    auto& shard = shard_of(e);
+    std::lock_guard<std::mutex> lk(shard.mtx);
+    if (insert) {
+      if (!shard.edges)
+        shard.edges = new std::unordered_set<edge, edge_hash>;
+      shard.edges->insert(e);
+    } else if (shard.edges) {
+      shard.edges->erase(e);
+    }
+  }
+
+  static graph_node& node_of(graph_ref& ref, uintptr_t mkey)
   {
-    static std::mutex global_guard;
-    static mutexmap_type global_mutexmap;
-    static std::size_t global_counter = 0;
-    return { std::unique_lock<std::mutex>(global_guard), global_mutexmap, global_counter };
+    auto itr = ref.graph.find(mkey);
+    if (itr == ref.graph.end())
+      itr = ref.graph.emplace(mkey, graph_node{ ++ref.counter, {}, {} }).first;
+    return itr->second;
   }
 
   template <typename T>
@@ -79,107 +170,124 @@ private:
     vec.erase(std::remove(vec.begin(), vec.end(), value), vec.end());
   }
 
-  static bool find_closepath(const mutexmap_type& mutexmap, uintptr_t end_mkey, std::thread::id tid)
+  static bool find_path(const graph_type& graph, uintptr_t from, uintptr_t to, std::vector<uintptr_t>& path)
   {
-    for (const auto& e : mutexmap) {
-      if (std::find(e.second.owners.begin(), e.second.owners.end(), tid) == e.second.owners.end())
+    // depth-first search on lock-order graph
+    std::vector<uintptr_t> visited;
+    std::vector<std::pair<uintptr_t, std::size_t>> stack{ {from, 0} };
+    visited.push_back(from);
+    while (!stack.empty()) {
+      auto& top = stack.back();
+      if (top.first == to) {
+        for (const auto& e : stack)
+          path.push_back(e.first);
+        return true;
+      }
+      auto itr = graph.find(top.first);
+      if (itr == graph.end() || itr->second.out.size() <= top.second) {
+        stack.pop_back();
         continue;
-      if (e.first == end_mkey)
-        return true;  // found close path
-      for (const auto& next_tid : e.second.waiters) {
-        if (find_closepath(mutexmap, end_mkey, next_tid)) {
-          return true;
-        }
+      }
+      const uintptr_t next = itr->second.out[top.second++];
+      if (std::find(visited.begin(), visited.end(), next) == visited.end()) {
+        visited.push_back(next);
+        stack.emplace_back(next, 0);
       }
     }
     return false;
   }
 
-  static void dump_mutexmap(std::ostream& os, const mutexmap_type& mutexmap)
+  static void report(graph_ref& ref, const std::vector<uintptr_t>& path, uintptr_t mkey, std::thread::id tid, bool shared)
   {
-    for (const auto& e : mutexmap) {
-      os << "  Mutex#" << e.second.mid << ": owners={";
-      int i = 0;
-      for (const auto& id : e.second.owners) {
-        os << (i++ ? "," : "") << id;
-      }
-      os << "} waiters={";
-      i = 0;
-      for (const auto& id : e.second.waiters) {
-        os << (i++ ? "," : "") << id;
-      }
-      os << "}\n";
+    std::cout << "Thread#" << tid << " wait for Mutex#" << node_of(ref, mkey).mid
+      << " " << (shared ? "shared-lock" : "lock") << '\n';
+    std::cout << "  lock order inversion: ";
+    for (const auto& m : path) {
+      std::cout << "Mutex#" << node_of(ref, m).mid << " -> ";
     }
-    os << std::endl;
+    std::cout << "Mutex#" << node_of(ref, mkey).mid << '\n';
+    std::cout << "==== DEADLOCK DETECTED ====" << std::endl;
   }
 
 public:
-  static void ctor(uintptr_t mkey)
-  {
-    auto&& table = global_table();
-    table.mutexmap[mkey] = { ++table.counter, {}, {} };
-  }
+  static void ctor(uintptr_t) {}
 
   static void dtor(uintptr_t mkey)
   {
-    auto&& table = global_table();
-    table.mutexmap.erase(mkey);
+    auto&& ref = global_graph();
+    auto itr = ref.graph.find(mkey);
+    if (itr == ref.graph.end())
+      return;
+    for (const auto& m : itr->second.out) {
+      remove_elem(ref.graph[m].in, mkey);
+      cache_edge({mkey, m}, false);
+    }
+    for (const auto& m : itr->second.in) {
+      remove_elem(ref.graph[m].out, mkey);
+      cache_edge({m, mkey}, false);
+    }
+    ref.graph.erase(itr);
   }
 
   static void locked(uintptr_t mkey, std::thread::id tid, bool shared)
   {
-    auto&& table = global_table();
-    table.mutexmap[mkey].owners.push_back(tid);
+    held_locks().push_back({mkey, shared});
 #if YAMC_CHECK_VERBOSE
-    std::cout << "Thread#" << tid << " acquired Mutex#" << table.mutexmap[mkey].mid
-      << " " << (shared ? "shared-lock" : "lock") << '\n';
-    dump_mutexmap(std::cout, table.mutexmap);
+    std::cout << "Thread#" << tid << " acquired Mutex@" << std::hex << mkey << std::dec
+      << " " << (shared ? "shared-lock" : "lock") << std::endl;
 #else
-    (void)shared;  // suppress "unused variable" warning
+    (void)tid;  // suppress "unused variable" warning
 #endif
   }
 
   static void unlocked(uintptr_t mkey, std::thread::id tid, bool shared)
   {
-    auto&& table = global_table();
-    remove_elem(table.mutexmap[mkey].owners, tid);
+    auto& held = held_locks();
+    for (auto itr = held.rbegin(); itr != held.rend(); ++itr) {
+      if (itr->mkey == mkey) {
+        held.erase(std::next(itr).base());
+        break;
+      }
+    }
 #if YAMC_CHECK_VERBOSE
-    std::cout << "Thread#" << tid << " released Mutex#" << table.mutexmap[mkey].mid
-      << " " << (shared ? "shared-lock" : "lock") << '\n';
-    dump_mutexmap(std::cout, table.mutexmap);
+    std::cout << "Thread#" << tid << " released Mutex@" << std::hex << mkey << std::dec
+      << " " << (shared ? "shared-lock" : "lock") << std::endl;
 #else
-    (void)shared;  // suppress "unused variable" warning
+    (void)tid; (void)shared;  // suppress "unused variable" warning
 #endif
   }
 
+  /// blocking acquisition, return false if it may cause deadlock
   static bool enqueue(uintptr_t mkey, std::thread::id tid, bool shared)
   {
-    auto&& table = global_table();
-    table.mutexmap[mkey].waiters.push_back(tid);
-    if (find_closepath(table.mutexmap, mkey, tid)) {
-      // detect deadlock
-      std::cout << "Thread#" << tid << " wait for Mutex#" << table.mutexmap[mkey].mid
-        << " " << (shared ? "shared-lock" : "lock") << '\n';
-      dump_mutexmap(std::cout, table.mutexmap);
-      std::cout << "==== DEADLOCK DETECTED ====" << std::endl;
-      return false;
+    for (const auto& h : held_locks()) {
+      if (h.mkey == mkey || (h.shared && shared))
+        continue;
+      const edge e{h.mkey, mkey};
+      if (is_cached(e))
+        continue;  // known lock order
+      auto&& ref = global_graph();
+      std::vector<uintptr_t> path;
+      if (find_path(ref.graph, mkey, h.mkey, path)) {
+        report(ref, path, mkey, tid, shared);
+        return false;
+      }
+      auto& from = node_of(ref, h.mkey);
+      if (std::find(from.out.begin(), from.out.end(), mkey) == from.out.end()) {
+        from.out.push_back(mkey);
+        node_of(ref, mkey).in.push_back(h.mkey);
+      }
+      cache_edge(e, true);
     }
-#if YAMC_CHECK_VERBOSE
-    std::cout << "Thread#" << tid << " wait for Mutex#" << table.mutexmap[mkey].mid
-      << " " << (shared ? "shared-lock" : "lock") << '\n';
-    dump_mutexmap(std::cout, table.mutexmap);
-#endif
     return true;
   }
-
-  static void dequeue(uintptr_t mkey, std::thread::id tid)
-  {
-    auto&& table = global_table();
-    remove_elem(table.mutexmap[mkey].waiters, tid);
-  }
 };
 
 
+template <typename T>
+deadlock::global_state deadlock::global_holder<T>::state;
+
+
 class null {
 public:
   static void ctor(uintptr_t) {}
@@ -187,7 +295,6 @@ public:
   static void locked(uintptr_t, std::thread::id, bool) {}
   static void unlocked(uintptr_t, std::thread::id, bool) {}
   static bool enqueue(uintptr_t, std::thread::id, bool) { return true; }
-  static void dequeue(uintptr_t, std::thread::id) {}
 };
 
 
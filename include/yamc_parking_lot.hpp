@@ -0,0 +1,290 @@
+/*
+ * yamc_parking_lot.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2019 yohhoy
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef YAMC_PARKING_LOT_HPP_
+#define YAMC_PARKING_LOT_HPP_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include "yamc_config.hpp"
+
+
+/// number of buckets in global parking lot
+#ifndef YAMC_PARKING_LOT_SIZE
+#define YAMC_PARKING_LOT_SIZE 256
+#endif
+
+/// maximum interval [usec] of "be fair" hint on unpark operation
+#ifndef YAMC_PARKING_LOT_FAIR_INTERVAL
+#define YAMC_PARKING_LOT_FAIR_INTERVAL 1000
+#endif
+
+
+namespace yamc {
+
+/*
+ * global parking lot, address-keyed wait queues
+ *
+ * - yamc::parking_lot::park(addr, token, validate)
+ * - yamc::parking_lot::park_until(addr, token, validate, abs_time)
+ * - yamc::parking_lot::unpark_one(addr, callback)
+ * - yamc::parking_lot::unpark_filter(addr, filter, callback)
+ * - yamc::parking_lot::unpark_all(addr, token)
+ *
+ * Parked threads are queued in FIFO order into a bucket of fixed size hash table,
+ * each bucket is guarded by its own mutex. Since waiting thread's queue node lives on
+ * its stack, synchronization object itself needs no storage for waiter management,
+ * only a few bits of its lock word.
+ *
+ * validate() and callback() are invoked while holding the bucket lock, so a lock word
+ * updated in callback() is consistent with validation by concurrent park().
+ * unpark_result::be_fair is set at randomized interval up to YAMC_PARKING_LOT_FAIR_INTERVAL
+ * for each bucket, which suggests handing off lock directly to the unparked thread
+ * (eventual fairness).
+ *
+ * F. Pizlo, "Locking in WebKit", 2016. https://webkit.org/blog/6161/locking-in-webkit/
+ */
+namespace parking_lot {
+
+/// result of park operation
+struct park_result {
+  bool unparked;           // false: validation failure or timeout
+  std::intptr_t token;     // unpark token from callback()
+};
+
+/// result of unpark operation
+struct unpark_result {
+  std::size_t unparked;    // number of unparked threads
+  bool have_more;          // still some threads are parked on the address
+  bool be_fair;            // hint for fair handoff
+};
+
+/// decision of unpark_filter() for each parked thread
+enum class filter_op {
+  unpark,
+  skip,
+  stop,
+};
+
+
+namespace detail {
+
+// queue node of parked thread
+struct waiter {
+  const void* addr;
+  waiter* next;
+  std::intptr_t park_token;
+  std::intptr_t unpark_token = 0;
+  bool unparked = false;
+  std::condition_variable cv;
+
+  waiter(const void* a, std::intptr_t t)
+    : addr(a), next(nullptr), park_token(t) {}
+};
+
+struct alignas(YAMC_CACHELINE_SIZE) bucket {
+  std::mutex mtx;
+  waiter* head = nullptr;
+  waiter* tail = nullptr;
+  std::chrono::steady_clock::time_point fair_time{};
+  std::uint32_t seed = 1;
+
+  void push_back(waiter* w)
+  {
+    if (tail)
+      tail->next = w;
+    else
+      head = w;
+    tail = w;
+  }
+
+  void erase(waiter* w, waiter* prev)
+  {
+    (prev ? prev->next : head) = w->next;
+    if (tail == w)
+      tail = prev;
+    w->next = nullptr;
+  }
+
+  bool time_to_be_fair()
+  {
+    const auto now = std::chrono::steady_clock::now();
+    if (now < fair_time)
+      return false;
+    // xorshift32
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    fair_time = now + std::chrono::microseconds(seed % (YAMC_PARKING_LOT_FAIR_INTERVAL + 1));
+    return true;
+  }
+};
+
+inline bucket& bucket_of(const void* addr)
+{
+  static bucket table[YAMC_PARKING_LOT_SIZE];
+  std::uintptr_t h = reinterpret_cast<std::uintptr_t>(addr);
+  h = (h ^ (h >> 9) ^ (h >> 17)) * 0x9E3779B1u;
+  return table[(h >> 8) % YAMC_PARKING_LOT_SIZE];
+}
+
+struct no_timeout {
+  bool wait(waiter& w, std::unique_lock<std::mutex>& lk) const
+  {
+    w.cv.wait(lk);
+    return true;
+  }
+};
+
+template <typename Clock, typename Duration>
+struct timeout_at {
+  const std::chrono::time_point<Clock, Duration>& tp;
+  bool wait(waiter& w, std::unique_lock<std::mutex>& lk) const
+  {
+    return w.cv.wait_until(lk, tp) == std::cv_status::no_timeout;
+  }
+};
+
+template <typename Validate, typename Timeout>
+park_result park_impl(const void* addr, std::intptr_t token, Validate& validate, const Timeout& tmo)
+{
+  bucket& b = bucket_of(addr);
+  std::unique_lock<std::mutex> lk(b.mtx);
+  if (!validate())
+    return {false, 0};
+  waiter w(addr, token);
+  b.push_back(&w);
+  while (!w.unparked) {
+    if (!tmo.wait(w, lk) && !w.unparked) {
+      // timeout, leave from queue
+      waiter* prev = nullptr;
+      for (waiter* p = b.head; p != &w; p = p->next) {
+        prev = p;
+      }
+      b.erase(&w, prev);
+      return {false, 0};
+    }
+  }
+  return {true, w.unpark_token};
+}
+
+} // namespace detail
+
+
+/// park current thread on addr if validate() returns true
+template <typename Validate>
+park_result park(const void* addr, std::intptr_t token, Validate validate)
+{
+  return detail::park_impl(addr, token, validate, detail::no_timeout{});
+}
+
+/// park current thread on addr if validate() returns true until abs_time
+template <typename Validate, typename Clock, typename Duration>
+park_result park_until(const void* addr, std::intptr_t token, Validate validate,
+                       const std::chrono::time_point<Clock, Duration>& abs_time)
+{
+  return detail::park_impl(addr, token, validate, detail::timeout_at<Clock, Duration>{abs_time});
+}
+
+/// unpark threads parked on addr in FIFO order, filter(park_token) selects threads
+///
+/// callback(unpark_result) is invoked before resuming unparked threads, and returns
+/// unpark token which is passed to them.
+///
+template <typename Filter, typename Callback>
+unpark_result unpark_filter(const void* addr, Filter filter, Callback callback)
+{
+  detail::bucket& b = detail::bucket_of(addr);
+  std::lock_guard<std::mutex> lk(b.mtx);
+  detail::waiter* selected = nullptr;
+  detail::waiter** link = &selected;
+  unpark_result r{0, false, false};
+  detail::waiter* prev = nullptr;
+  detail::waiter* p = b.head;
+  while (p) {
+    detail::waiter* next = p->next;
+    if (p->addr == addr) {
+      const filter_op op = filter(p->park_token);
+      if (op == filter_op::stop) {
+        r.have_more = true;
+        break;
+      }
+      if (op == filter_op::unpark) {
+        b.erase(p, prev);
+        *link = p;
+        link = &p->next;
+        ++r.unparked;
+        p = next;
+        continue;
+      }
+      r.have_more = true;
+    }
+    prev = p;
+    p = next;
+  }
+  if (r.unparked)
+    r.be_fair = b.time_to_be_fair();
+  const std::intptr_t token = callback(r);
+  // notify under bucket lock, waiter node gets invalid after its owner returns
+  for (p = selected; p; ) {
+    detail::waiter* next = p->next;
+    p->unpark_token = token;
+    p->unparked = true;
+    p->cv.notify_one();
+    p = next;
+  }
+  return r;
+}
+
+/// unpark one thread parked on addr
+template <typename Callback>
+unpark_result unpark_one(const void* addr, Callback callback)
+{
+  bool first = true;
+  return unpark_filter(addr,
+    [&](std::intptr_t) {
+      if (!first)
+        return filter_op::stop;
+      first = false;
+      return filter_op::unpark;
+    },
+    callback);
+}
+
+/// unpark all threads parked on addr, return number of unparked threads
+inline std::size_t unpark_all(const void* addr, std::intptr_t token = 0)
+{
+  return unpark_filter(addr,
+    [](std::intptr_t) { return filter_op::unpark; },
+    [=](const unpark_result&) { return token; }).unparked;
+}
+
+} // namespace parking_lot
+} // namespace yamc
+
+#endif
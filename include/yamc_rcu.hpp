@@ -0,0 +1,197 @@
+/*
+ * yamc_rcu.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2019 yohhoy
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef YAMC_RCU_HPP_
+#define YAMC_RCU_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include "yamc_config.hpp"
+#include "yamc_thread_hint.hpp"
+
+
+/// number of reader slots of yamc::rcu_cell<T, Mutex>
+#ifndef YAMC_RCU_SLOTS
+#define YAMC_RCU_SLOTS 32
+#endif
+
+
+/*
+ * Read-copy-update cell
+ *
+ * - yamc::rcu_cell<T, Mutex>
+ *
+ * Readers get a snapshot pointer of current value through read(). Writers are serialized
+ * by Mutex, publish a new copy of value and reclaim old one after grace period.
+ *
+ * Reader enters into cache-line-padded slot which is selected by sequential per-thread hint
+ * (like yamc::combining), and counts up one of two epoch counters there.
+ * Readers on different slots never write the same cache line, also when the cell is
+ * allocated by new-expression. Grace period flips the global epoch twice and waits for
+ * readers on previous epoch, so that continuous readers never starve writers. store()/update() blocks until all readers holding
+ * old value leave, then deletes old value. Calling store()/update() while holding
+ * a snapshot in the same thread causes deadlock.
+ *
+ * P. E. McKenney et al., "Read-Copy Update", Ottawa Linux Symposium, 2001.
+ */
+namespace yamc {
+
+template <typename T, typename Mutex = std::mutex>
+class rcu_cell : public yamc::detail::cacheline_aligned_new {
+  struct alignas(YAMC_CACHELINE_SIZE) slot {
+    std::atomic<std::size_t> count[2];
+  };
+
+  std::atomic<T*> ptr_;
+  std::atomic<unsigned> epoch_{0};  // modified under mtx_
+  mutable slot slots_[YAMC_RCU_SLOTS];
+  Mutex mtx_;
+
+  slot& current_slot() const
+  {
+    return slots_[detail::this_thread_slot_hint() % YAMC_RCU_SLOTS];
+  }
+
+  bool drained(unsigned parity) const
+  {
+    for (const auto& s : slots_) {
+      if (s.count[parity].load(std::memory_order_seq_cst) != 0)
+        return false;
+    }
+    return true;
+  }
+
+  // wait for all readers which may see old value (requires mtx_)
+  void synchronize()
+  {
+    for (int i = 0; i < 2; i++) {
+      const unsigned parity = epoch_.fetch_add(1, std::memory_order_seq_cst) & 1u;
+      while (!drained(parity)) {
+        // grace period takes a while, give way to readers
+        std::this_thread::yield();
+      }
+    }
+  }
+
+  void publish(std::unique_ptr<T> value)
+  {
+    // seq_cst exchange pairs with counter RMW/ptr_ load in read()
+    std::unique_ptr<T> old{ ptr_.exchange(value.release(), std::memory_order_seq_cst) };
+    synchronize();
+  }
+
+public:
+  class read_ptr {
+    std::atomic<std::size_t>* counter_;
+    const T* ptr_;
+
+    friend class rcu_cell;
+    read_ptr(std::atomic<std::size_t>* counter, const T* ptr)
+      : counter_(counter), ptr_(ptr) {}
+
+  public:
+    read_ptr(read_ptr&& rhs) noexcept
+      : counter_(rhs.counter_), ptr_(rhs.ptr_)
+    {
+      rhs.counter_ = nullptr;
+      rhs.ptr_ = nullptr;
+    }
+
+    ~read_ptr()
+    {
+      if (counter_)
+        counter_->fetch_sub(1, std::memory_order_release);
+    }
+
+    read_ptr(const read_ptr&) = delete;
+    read_ptr& operator=(const read_ptr&) = delete;
+    read_ptr& operator=(read_ptr&&) = delete;
+
+    const T* get() const noexcept { return ptr_; }
+    const T& operator*() const noexcept { return *ptr_; }
+    const T* operator->() const noexcept { return ptr_; }
+  };
+
+  rcu_cell()
+    : rcu_cell(std::unique_ptr<T>(new T())) {}
+
+  explicit rcu_cell(T value)
+    : rcu_cell(std::unique_ptr<T>(new T(std::move(value)))) {}
+
+  explicit rcu_cell(std::unique_ptr<T> value)
+    : ptr_(value.release())
+  {
+    for (auto& s : slots_) {
+      s.count[0].store(0, std::memory_order_relaxed);
+      s.count[1].store(0, std::memory_order_relaxed);
+    }
+  }
+
+  ~rcu_cell()
+  {
+    delete ptr_.load(std::memory_order_relaxed);
+  }
+
+  rcu_cell(const rcu_cell&) = delete;
+  rcu_cell& operator=(const rcu_cell&) = delete;
+
+  read_ptr read() const
+  {
+    slot& s = current_slot();
+    const unsigned parity = epoch_.load(std::memory_order_relaxed) & 1u;
+    std::atomic<std::size_t>* counter = &s.count[parity];
+    counter->fetch_add(1, std::memory_order_seq_cst);
+    return read_ptr(counter, ptr_.load(std::memory_order_seq_cst));
+  }
+
+  void store(T value)
+  {
+    store(std::unique_ptr<T>(new T(std::move(value))));
+  }
+
+  void store(std::unique_ptr<T> value)
+  {
+    std::lock_guard<Mutex> lk(mtx_);
+    publish(std::move(value));
+  }
+
+  // copy current value, modify it by f(T&) and publish
+  template <typename F>
+  void update(F f)
+  {
+    std::lock_guard<Mutex> lk(mtx_);
+    std::unique_ptr<T> value(new T(*ptr_.load(std::memory_order_relaxed)));
+    f(*value);
+    publish(std::move(value));
+  }
+};
+
+} // namespace yamc
+
+#endif
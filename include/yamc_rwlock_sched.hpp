@@ -43,6 +43,11 @@ namespace yamc {
  *
  * - yamc::rwlock::ReaderPrefer
  * - yamc::rwlock::WriterPrefer
+ * - yamc::rwlock::LockFree<RwLockPolicy>
+ *
+ * Upgrade ownership: single upgrader is counted as a reader, so it coexists with
+ * readers and blocks writers. The upgrader is promoted to writer when other readers
+ * are gone, *_ulock() and *_upgrade() functions handle these transitions.
  */
 namespace rwlock {
 
@@ -59,6 +64,7 @@ struct ReaderPrefer {
 
   struct state {
     std::size_t rwcount = 0;
+    bool upgrader = false;
   };
 
   static void before_wait_wlock(state&) {}
@@ -95,7 +101,49 @@ struct ReaderPrefer {
   static bool release_rlock(state& s)
   {
     assert(0 < (s.rwcount & reader_mask));
-    return (--s.rwcount == 0);
+    // notify when last reader (except upgrader) releases lock
+    return (--s.rwcount == (s.upgrader ? 1u : 0u));
+  }
+
+  static bool wait_ulock(state& s)
+  {
+    return (s.rwcount & writer_mask) || s.upgrader;
+  }
+
+  static void acquire_ulock(state& s)
+  {
+    acquire_rlock(s);
+    s.upgrader = true;
+  }
+
+  static void release_ulock(state& s)
+  {
+    assert(s.upgrader);
+    s.upgrader = false;
+    assert(0 < (s.rwcount & reader_mask));
+    --s.rwcount;
+  }
+
+  static void before_wait_upgrade(state&) {}
+  static void after_wait_upgrade(state&) {}
+
+  static bool wait_upgrade(state& s)
+  {
+    assert(s.upgrader);
+    return (s.rwcount != 1);
+  }
+
+  static void upgrade_ulock(state& s)
+  {
+    assert(s.upgrader && s.rwcount == 1);
+    s.upgrader = false;
+    s.rwcount = writer_mask;
+  }
+
+  static void downgrade_ulock(state& s)
+  {
+    assert(s.upgrader);
+    s.upgrader = false;
   }
 };
 
@@ -115,6 +163,7 @@ struct WriterPrefer {
   struct state {
     std::size_t nwriter = 0;
     std::size_t nreader = 0;
+    bool upgrader = false;
   };
 
   static void before_wait_wlock(state& s)
@@ -160,7 +209,113 @@ struct WriterPrefer {
   static bool release_rlock(state& s)
   {
     assert(0 < s.nreader);
-    return (--s.nreader == 0);
+    // notify when last reader (except upgrader) releases lock
+    return (--s.nreader == (s.upgrader ? 1u : 0u));
+  }
+
+  static bool wait_ulock(state& s)
+  {
+    return (s.nwriter != 0) || s.upgrader;
+  }
+
+  static void acquire_ulock(state& s)
+  {
+    acquire_rlock(s);
+    s.upgrader = true;
+  }
+
+  static void release_ulock(state& s)
+  {
+    assert(s.upgrader && 0 < s.nreader);
+    s.upgrader = false;
+    --s.nreader;
+  }
+
+  // upgrader waits as a writer, which blocks new readers
+  static void before_wait_upgrade(state& s)
+  {
+    before_wait_wlock(s);
+  }
+
+  static bool wait_upgrade(state& s)
+  {
+    assert(s.upgrader);
+    return (s.nreader != 1);
+  }
+
+  static void after_wait_upgrade(state& s)
+  {
+    after_wait_wlock(s);
+  }
+
+  static void upgrade_ulock(state& s)
+  {
+    assert(s.upgrader && s.nreader == 1);
+    s.upgrader = false;
+    s.nreader = 0;
+    acquire_wlock(s);
+  }
+
+  static void downgrade_ulock(state& s)
+  {
+    assert(s.upgrader);
+    s.upgrader = false;
+  }
+};
+
+
+/// Lock-free fast path of ReaderPrefer/WriterPrefer scheduling
+///
+/// NOTE:
+///   Shared mutex stores the policy state into single atomic word, uncontended lock/unlock
+///   operations are done by a CAS without internal mutex. pack/unpack convert between
+///   state and atomic word.
+///
+template <typename RwLockPolicy>
+struct LockFree;
+
+template <>
+struct LockFree<ReaderPrefer> : ReaderPrefer {
+  // word := [writer:1][upgrader:1][rwcount:N-2]
+  static const std::size_t upgrader_bit = writer_mask >> 1;
+
+  static std::size_t pack(const state& s)
+  {
+    assert((s.rwcount & reader_mask) < upgrader_bit);
+    return s.rwcount | (s.upgrader ? upgrader_bit : 0);
+  }
+
+  static state unpack(std::size_t word)
+  {
+    state s;
+    s.rwcount = word & ~upgrader_bit;
+    s.upgrader = (word & upgrader_bit) != 0;
+    return s;
+  }
+};
+
+template <>
+struct LockFree<WriterPrefer> : WriterPrefer {
+  // word := [locked:1][nwriter:N/2-1][upgrader:1][nreader:N/2-1]
+  static const unsigned shift = sizeof(std::size_t) * 4;
+  static const std::size_t upgrader_bit = std::size_t(1u) << (shift - 1);
+  static const std::size_t reader_mask = upgrader_bit - 1;
+
+  static std::size_t pack(const state& s)
+  {
+    assert((s.nwriter & wait_mask) < (wait_mask >> shift));
+    assert(s.nreader <= reader_mask);
+    return (s.nwriter & locked) | ((s.nwriter & wait_mask) << shift)
+         | (s.upgrader ? upgrader_bit : 0) | s.nreader;
+  }
+
+  static state unpack(std::size_t word)
+  {
+    state s;
+    s.nwriter = (word & locked) | ((word & ~locked) >> shift);
+    s.nreader = word & reader_mask;
+    s.upgrader = (word & upgrader_bit) != 0;
+    return s;
   }
 };
 
@@ -26,18 +26,152 @@
 #ifndef YAMC_SCOPED_LOCK_HPP_
 #define YAMC_SCOPED_LOCK_HPP_
 
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
 #include <mutex>
 #include <tuple>
 #include <type_traits>
+#include <utility>
+#include <vector>
+#include "yamc_backoff_spin.hpp"
 
 
 /*
  * std::scoped_lock in C++17 Standard Library
  *
  * - yamc::scoped_lock<MutexTypes...>
+ * - yamc::scoped_range_lock<Mutex>
+ *
+ * Acquisition strategy of multiple mutexes is selectable by tag:
+ * - (no tag): std::lock() deadlock avoidance algorithm
+ * - yamc::ordered_lock: block on each mutex in ascending address order, deadlock-free
+ *   without retry when all lockers of these mutexes follow address order
+ * - yamc::adaptive_lock: block on the first mutex in address order, try_lock() the rest.
+ *   On failure, release all, back off with BackoffPolicy, then block on the busy one.
+ *   This is safe for non-orderable sets, i.e. other lockers don't follow address order.
+ *
+ * scoped_range_lock<Mutex> locks runtime-sized set of std::vector<Mutex*>,
+ * duplicated pointers are locked only once (default strategy is yamc::ordered_lock).
  */
 namespace yamc {
 
+struct ordered_lock_t {};
+
+template <typename BackoffPolicy = YAMC_BACKOFF_SPIN_DEFAULT>
+struct basic_adaptive_lock_t {};
+
+using adaptive_lock_t = basic_adaptive_lock_t<>;
+
+constexpr ordered_lock_t ordered_lock{};
+constexpr adaptive_lock_t adaptive_lock{};
+
+
+namespace detail {
+
+// type-erased reference to Lockable object
+struct lockable_ref {
+  void* obj;
+  void (*lock_fn)(void*);
+  bool (*try_lock_fn)(void*);
+  void (*unlock_fn)(void*);
+
+  void lock() const { lock_fn(obj); }
+  bool try_lock() const { return try_lock_fn(obj); }
+  void unlock() const { unlock_fn(obj); }
+};
+
+template <typename Lockable>
+struct lockable_ops {
+  static void lock(void* p) { static_cast<Lockable*>(p)->lock(); }
+  static bool try_lock(void* p) { return static_cast<Lockable*>(p)->try_lock(); }
+  static void unlock(void* p) { static_cast<Lockable*>(p)->unlock(); }
+};
+
+template <typename Lockable>
+lockable_ref make_lockable_ref(Lockable& m)
+{
+  return { std::addressof(m), &lockable_ops<Lockable>::lock,
+           &lockable_ops<Lockable>::try_lock, &lockable_ops<Lockable>::unlock };
+}
+
+inline const lockable_ref& lockable_of(const lockable_ref& r) { return r; }
+inline const void* address_of(const lockable_ref& r) { return r.obj; }
+
+template <typename Lockable>
+Lockable& lockable_of(Lockable* p) { return *p; }
+template <typename Lockable>
+const void* address_of(Lockable* p) { return p; }
+
+template <typename Iterator>
+void sort_by_address(Iterator first, Iterator last)
+{
+  using value_type = typename std::iterator_traits<Iterator>::value_type;
+  std::sort(first, last, [](const value_type& a, const value_type& b) {
+    return std::less<const void*>()(address_of(a), address_of(b));
+  });
+}
+
+// release [first, last) except skip
+template <typename Iterator>
+void unlock_range(Iterator first, Iterator last, Iterator skip)
+{
+  for (; first != last; ++first) {
+    if (first != skip)
+      lockable_of(*first).unlock();
+  }
+}
+
+// lock sorted [first, last) in address order
+template <typename Iterator>
+void lock_ordered(Iterator first, Iterator last)
+{
+  Iterator p = first;
+  try {
+    for (; p != last; ++p) {
+      lockable_of(*p).lock();
+    }
+  } catch (...) {
+    unlock_range(first, p, last);
+    throw;
+  }
+}
+
+// lock sorted [first, last), block on one and try_lock the rest
+template <typename BackoffPolicy, typename Iterator>
+void lock_adaptive(Iterator first, Iterator last)
+{
+  if (first == last)
+    return;
+  typename BackoffPolicy::state state;
+  Iterator busy = first;
+  for (;;) {
+    lockable_of(*busy).lock();
+    Iterator p = first;
+    try {
+      for (; p != last; ++p) {
+        if (p != busy && !lockable_of(*p).try_lock())
+          break;
+      }
+    } catch (...) {
+      unlock_range(first, p, busy);
+      lockable_of(*busy).unlock();
+      throw;
+    }
+    if (p == last)
+      return;
+    unlock_range(first, p, busy);
+    lockable_of(*busy).unlock();
+    BackoffPolicy::wait(state);
+    busy = p;
+  }
+}
+
+} // namespace detail
+
+
 template <typename... MutexTypes>
 class scoped_lock {
   template <std::size_t I = 0>
@@ -59,6 +193,23 @@ public:
     std::lock(m...);
   }
 
+  explicit scoped_lock(ordered_lock_t, MutexTypes&... m)
+    : pm_(m...)
+  {
+    detail::lockable_ref refs[] = { detail::make_lockable_ref(m)... };
+    detail::sort_by_address(std::begin(refs), std::end(refs));
+    detail::lock_ordered(std::begin(refs), std::end(refs));
+  }
+
+  template <typename BackoffPolicy>
+  explicit scoped_lock(basic_adaptive_lock_t<BackoffPolicy>, MutexTypes&... m)
+    : pm_(m...)
+  {
+    detail::lockable_ref refs[] = { detail::make_lockable_ref(m)... };
+    detail::sort_by_address(std::begin(refs), std::end(refs));
+    detail::lock_adaptive<BackoffPolicy>(std::begin(refs), std::end(refs));
+  }
+
   explicit scoped_lock(std::adopt_lock_t, MutexTypes&... m)
     : pm_(m...)
   {
@@ -81,6 +232,9 @@ template <>
 class scoped_lock<> {
 public:
   explicit scoped_lock() = default;
+  explicit scoped_lock(ordered_lock_t) {}
+  template <typename BackoffPolicy>
+  explicit scoped_lock(basic_adaptive_lock_t<BackoffPolicy>) {}
   explicit scoped_lock(std::adopt_lock_t) {}
   ~scoped_lock() = default;
 
@@ -100,6 +254,19 @@ public:
     m.lock();
   }
 
+  explicit scoped_lock(ordered_lock_t, Mutex& m)
+    : m_(m)
+  {
+    m.lock();
+  }
+
+  template <typename BackoffPolicy>
+  explicit scoped_lock(basic_adaptive_lock_t<BackoffPolicy>, Mutex& m)
+    : m_(m)
+  {
+    m.lock();
+  }
+
   explicit scoped_lock(std::adopt_lock_t, Mutex& m)
     : m_(m)
   {
@@ -118,6 +285,58 @@ private:
 };
 
 
+template <typename Mutex>
+class scoped_range_lock {
+  static std::vector<Mutex*> normalize(std::vector<Mutex*> mtxs)
+  {
+    detail::sort_by_address(mtxs.begin(), mtxs.end());
+    mtxs.erase(std::unique(mtxs.begin(), mtxs.end()), mtxs.end());
+    return mtxs;
+  }
+
+public:
+  using mutex_type = Mutex;
+
+  explicit scoped_range_lock(std::vector<Mutex*> mtxs)
+    : pm_(normalize(std::move(mtxs)))
+  {
+    detail::lock_ordered(pm_.begin(), pm_.end());
+  }
+
+  explicit scoped_range_lock(ordered_lock_t, std::vector<Mutex*> mtxs)
+    : pm_(normalize(std::move(mtxs)))
+  {
+    detail::lock_ordered(pm_.begin(), pm_.end());
+  }
+
+  template <typename BackoffPolicy>
+  explicit scoped_range_lock(basic_adaptive_lock_t<BackoffPolicy>, std::vector<Mutex*> mtxs)
+    : pm_(normalize(std::move(mtxs)))
+  {
+    detail::lock_adaptive<BackoffPolicy>(pm_.begin(), pm_.end());
+  }
+
+  ~scoped_range_lock()
+  {
+    for (auto p = pm_.rbegin(); p != pm_.rend(); ++p) {
+      (*p)->unlock();
+    }
+  }
+
+  scoped_range_lock(const scoped_range_lock&) = delete;
+  scoped_range_lock& operator=(const scoped_range_lock&) = delete;
+
+  /// locked mutexes in address order
+  const std::vector<Mutex*>& mutexes() const noexcept
+  {
+    return pm_;
+  }
+
+private:
+  std::vector<Mutex*> pm_;
+};
+
+
 } // namespace yamc
 
 #endif
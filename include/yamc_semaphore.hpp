@@ -26,12 +26,14 @@
 #ifndef YAMC_SEMAPHORE_HPP_
 #define YAMC_SEMAPHORE_HPP_
 
+#include <atomic>
 #include <cassert>
 #include <cstddef>
+#include <cstdint>
 #include <chrono>
-#include <condition_variable>
 #include <limits>
-#include <mutex>
+#include <type_traits>
+#include "yamc_atomic_wait.hpp"
 
 
 /// default least_max_value of yamc::counting_semaphore
@@ -45,28 +47,125 @@
  *
  * - yamc::counting_semaphore<least_max_value>
  * - yamc::binary_semaphore
+ *
+ * Uncontended acquire/release is a single atomic operation on counter. Blocked thread waits
+ * with yamc::atomic_wait() on 32-bit word owned by the semaphore: the counter itself when
+ * least_max_value fits in it, otherwise separate sequence word bumped by each release.
+ * release(n) issues system call only if some threads are waiting.
+ *
+ * acquire(n) and try_acquire_*(n, ...) take n permits all-or-nothing. When n permits are not
+ * available at once, the acquirer becomes a single "debtor": it subtracts n from the counter
+ * (which may go negative) and waits until released permits pay off the debt. Negative counter
+ * blocks new acquirers, so a large request is never starved by a stream of small ones.
  */
 namespace yamc {
 
+namespace detail {
+
+template <std::ptrdiff_t least_max_value>
+using semaphore_counter_t = typename std::conditional<
+  (least_max_value <= (std::numeric_limits<std::int32_t>::max)()), std::int32_t, std::ptrdiff_t
+>::type;
+
+// 32-bit word which blocked acquirers wait on
+template <typename Counter, bool = (sizeof(Counter) == sizeof(std::int32_t))>
+class semaphore_wait_word {
+protected:
+  // 32-bit counter is directly waitable
+  std::atomic<std::int32_t>& wait_word(std::atomic<Counter>& counter) { return counter; }
+  void bump_wait_word() {}
+};
+
+template <typename Counter>
+class semaphore_wait_word<Counter, false> {
+  // wider counter can't be waited directly, and shared wait table entry can't wake up single waiter
+  std::atomic<std::int32_t> seq_{0};
+protected:
+  std::atomic<std::int32_t>& wait_word(std::atomic<Counter>&) { return seq_; }
+  void bump_wait_word() { seq_.fetch_add(1, std::memory_order_release); }
+};
+
+} // namespace detail
+
+
 template <std::ptrdiff_t least_max_value = YAMC_SEMAPHORE_LEAST_MAX_VALUE>
-class counting_semaphore {
-  std::ptrdiff_t counter_;
-  std::condition_variable cv_;
-  std::mutex mtx_;
+class counting_semaphore : detail::semaphore_wait_word<detail::semaphore_counter_t<least_max_value>> {
+  using counter_type = detail::semaphore_counter_t<least_max_value>;
+  std::atomic<counter_type> counter_;
+  std::atomic<std::int32_t> debtor_{0};  // 1 while multi-permit acquirer owes permits
 
-  template<typename Clock, typename Duration>
-  bool do_try_acquirewait(const std::chrono::time_point<Clock, Duration>& tp)
+  struct no_timeout {
+    bool wait(const std::atomic<std::int32_t>& a, std::int32_t old) const
+    {
+      yamc::atomic_wait(a, old, std::memory_order_relaxed);
+      return true;
+    }
+  };
+
+  template <typename Clock, typename Duration>
+  struct timeout_at {
+    const std::chrono::time_point<Clock, Duration>& tp;
+    bool wait(const std::atomic<std::int32_t>& a, std::int32_t old) const
+    {
+      return yamc::atomic_wait_until(a, old, tp, std::memory_order_relaxed);
+    }
+  };
+
+  bool try_decrement(counter_type& c, counter_type n = 1)
+  {
+    c = counter_.load(std::memory_order_relaxed);
+    while (n <= c) {
+      if (counter_.compare_exchange_weak(c, c - n, std::memory_order_acquire, std::memory_order_relaxed))
+        return true;
+    }
+    return false;
+  }
+
+  /// wait for permit, return false on timeout
+  template <typename Timeout>
+  bool acquire_wait(const Timeout& tmo)
   {
-    std::unique_lock<decltype(mtx_)> lk(mtx_);
-    while (counter_ <= 0) {
-      if (cv_.wait_until(lk, tp) == std::cv_status::timeout) {
-        if (0 < counter_)  // re-check predicate
-          break;
+    counter_type c;
+    for (;;) {
+      // load wait word before counter, pairs with bump_wait_word() in release()
+      const std::int32_t w = this->wait_word(counter_).load(std::memory_order_acquire);
+      if (try_decrement(c))
+        return true;
+      if (!tmo.wait(this->wait_word(counter_), w))
+        return try_decrement(c);  // re-check predicate
+    }
+  }
+
+  template <typename Timeout>
+  bool acquire_debt(counter_type n, const Timeout& tmo)
+  {
+    // serialize debtors, only one thread accumulates permits at a time
+    std::int32_t d = 0;
+    while (!debtor_.compare_exchange_weak(d, 1, std::memory_order_acquire, std::memory_order_relaxed)) {
+      if (d != 0 && !tmo.wait(debtor_, d))
         return false;
+      d = 0;
+    }
+    counter_type c = counter_.fetch_sub(n, std::memory_order_acquire) - n;
+    while (c < 0) {
+      const std::int32_t w = this->wait_word(counter_).load(std::memory_order_acquire);
+      c = counter_.load(std::memory_order_acquire);
+      if (0 <= c)
+        break;
+      if (!tmo.wait(this->wait_word(counter_), w)) {
+        c = counter_.load(std::memory_order_acquire);
+        if (c < 0) {
+          // timeout, give back whole request
+          counter_.fetch_add(n, std::memory_order_release);
+          this->bump_wait_word();
+          yamc::atomic_notify_all(this->wait_word(counter_));
+        }
+        break;
       }
     }
-    --counter_;
-    return true;
+    debtor_.store(0, std::memory_order_release);
+    yamc::atomic_notify_all(debtor_);
+    return (0 <= c);
   }
 
 public:
@@ -77,7 +176,7 @@ public:
   }
 
   /*constexpr*/ explicit counting_semaphore(std::ptrdiff_t desired)
-    : counter_(desired)
+    : counter_(static_cast<counter_type>(desired))
   {
     assert(0 <= desired && desired <= (max)());
     // counting_semaphore constructor throws nothing.
@@ -90,45 +189,78 @@ public:
 
   void release(std::ptrdiff_t update = 1)
   {
-    std::lock_guard<decltype(mtx_)> lk(mtx_);
-    assert(0 <= update && update <= (max)() - counter_);
-    counter_ += update;
-    if (0 < counter_) {
-      cv_.notify_all();
+    const counter_type old = counter_.fetch_add(static_cast<counter_type>(update), std::memory_order_release);
+    assert(0 <= update && (old < 0 || update <= (max)() - old));
+    (void)old;
+    this->bump_wait_word();
+    if (old < 0) {
+      // debtor may be blocked
+      yamc::atomic_notify_all(this->wait_word(counter_));
+      return;
+    }
+    // wake up at most `update' waiters
+    for (std::ptrdiff_t n = 0; n < update; ++n) {
+      yamc::atomic_notify_one(this->wait_word(counter_));
     }
   }
 
   void acquire()
   {
-    std::unique_lock<decltype(mtx_)> lk(mtx_);
-    while (counter_ <= 0) {
-      cv_.wait(lk);
-    }
-    --counter_;
+    counter_type c;
+    if (!try_decrement(c))
+      acquire_wait(no_timeout{});
   }
 
   bool try_acquire() noexcept
   {
-    std::unique_lock<decltype(mtx_)> lk(mtx_);
-    if (counter_ <= 0) {
-      // no spurious failure
-      return false;
-    }
-    --counter_;
-    return true;
+    // no spurious failure
+    counter_type c;
+    return try_decrement(c);
   }
 
   template<class Rep, class Period>
   bool try_acquire_for(const std::chrono::duration<Rep, Period>& rel_time)
   {
     const auto tp = std::chrono::steady_clock::now() + rel_time;
-    return do_try_acquirewait(tp);
+    return try_acquire_until(tp);
   }
 
   template<class Clock, class Duration>
   bool try_acquire_until(const std::chrono::time_point<Clock, Duration>& abs_time)
   {
-    return do_try_acquirewait(abs_time);
+    counter_type c;
+    return try_decrement(c) || acquire_wait(timeout_at<Clock, Duration>{abs_time});
+  }
+
+  void acquire(std::ptrdiff_t n)
+  {
+    assert(0 <= n && n <= (max)());
+    counter_type c;
+    if (!try_decrement(c, static_cast<counter_type>(n)))
+      acquire_debt(static_cast<counter_type>(n), no_timeout{});
+  }
+
+  bool try_acquire(std::ptrdiff_t n) noexcept
+  {
+    assert(0 <= n && n <= (max)());
+    counter_type c;
+    return try_decrement(c, static_cast<counter_type>(n));
+  }
+
+  template<class Rep, class Period>
+  bool try_acquire_for(std::ptrdiff_t n, const std::chrono::duration<Rep, Period>& rel_time)
+  {
+    const auto tp = std::chrono::steady_clock::now() + rel_time;
+    return try_acquire_until(n, tp);
+  }
+
+  template<class Clock, class Duration>
+  bool try_acquire_until(std::ptrdiff_t n, const std::chrono::time_point<Clock, Duration>& abs_time)
+  {
+    assert(0 <= n && n <= (max)());
+    counter_type c;
+    return try_decrement(c, static_cast<counter_type>(n))
+        || acquire_debt(static_cast<counter_type>(n), timeout_at<Clock, Duration>{abs_time});
   }
 };
 
@@ -0,0 +1,158 @@
+/*
+ * yamc_seqlock.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2019 yohhoy
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef YAMC_SEQLOCK_HPP_
+#define YAMC_SEQLOCK_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <mutex>
+#include <type_traits>
+#include "ttas_spin_mutex.hpp"
+#include "yamc_backoff_spin.hpp"
+
+
+/*
+ * Sequence lock (seqlock)
+ *
+ * - yamc::seqlock<T, Mutex>
+ *
+ * Writers are serialized by Mutex and bump sequence counter before/after update.
+ * Readers take an optimistic copy and validate it against sequence counter, then retry
+ * when the copy overlaps with concurrent update. Read operation performs no store,
+ * so readers never contend each other, and writer is never blocked by readers.
+ *
+ * Value is held in an array of atomic words to avoid data race on racy reads,
+ * T shall be TriviallyCopyable type.
+ *
+ * H.-J. Boehm, "Can Seqlocks Get Along With Programming Language Memory Models?",
+ * ACM SIGPLAN Workshop on Memory Systems Performance and Correctness, 2012.
+ */
+namespace yamc {
+
+template <typename T, typename Mutex = yamc::spin_ttas::mutex>
+class seqlock {
+  static_assert(std::is_trivially_copyable<T>::value, "T shall be TriviallyCopyable");
+
+  using word_type = std::size_t;
+  static constexpr std::size_t nwords = (sizeof(T) + sizeof(word_type) - 1) / sizeof(word_type);
+
+  // seq_ := {even=stable, odd=update in progress}
+  std::atomic<std::size_t> seq_{0};
+  std::atomic<word_type> data_[nwords];
+  Mutex mtx_;
+
+  void do_read(T& value) const
+  {
+    word_type buf[nwords];
+    for (std::size_t i = 0; i < nwords; i++) {
+      buf[i] = data_[i].load(std::memory_order_relaxed);
+    }
+    std::memcpy(&value, buf, sizeof(T));
+  }
+
+  void do_write(const T& value)
+  {
+    word_type buf[nwords] = {};
+    std::memcpy(buf, &value, sizeof(T));
+    const std::size_t seq = seq_.load(std::memory_order_relaxed);
+    seq_.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (std::size_t i = 0; i < nwords; i++) {
+      data_[i].store(buf[i], std::memory_order_relaxed);
+    }
+    seq_.store(seq + 2, std::memory_order_release);
+  }
+
+public:
+  using value_type = T;
+  using mutex_type = Mutex;
+
+  seqlock() : seqlock(T{}) {}
+
+  explicit seqlock(const T& value)
+  {
+    word_type buf[nwords] = {};
+    std::memcpy(buf, &value, sizeof(T));
+    for (std::size_t i = 0; i < nwords; i++) {
+      data_[i].store(buf[i], std::memory_order_relaxed);
+    }
+  }
+
+  ~seqlock() = default;
+
+  seqlock(const seqlock&) = delete;
+  seqlock& operator=(const seqlock&) = delete;
+
+  /// read value, retry until get a consistent snapshot
+  T load() const
+  {
+    T value;
+    while (!try_load(value)) {
+      yamc::backoff::cpu_relax();
+    }
+    return value;
+  }
+
+  /// single attempt of optimistic read, return false if it overlaps with update
+  bool try_load(T& value) const
+  {
+    const std::size_t seq0 = seq_.load(std::memory_order_acquire);
+    if (seq0 & 1)
+      return false;
+    do_read(value);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    const std::size_t seq1 = seq_.load(std::memory_order_relaxed);
+    return (seq0 == seq1);
+  }
+
+  void store(const T& value)
+  {
+    std::lock_guard<Mutex> lk(mtx_);
+    do_write(value);
+  }
+
+  /// read-modify-write under writer exclusion
+  template <typename F>
+  void update(F f)
+  {
+    std::lock_guard<Mutex> lk(mtx_);
+    T value;
+    do_read(value);
+    f(value);
+    do_write(value);
+  }
+
+  /// current sequence number, even value when no update is in progress
+  std::size_t sequence() const
+  {
+    return seq_.load(std::memory_order_acquire);
+  }
+};
+
+} // namespace yamc
+
+#endif
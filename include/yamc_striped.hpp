@@ -0,0 +1,195 @@
+/*
+ * yamc_striped.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2019 yohhoy
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef YAMC_STRIPED_HPP_
+#define YAMC_STRIPED_HPP_
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include "yamc_config.hpp"
+
+
+/// default number of stripes of yamc::striped<Mutex>
+#ifndef YAMC_STRIPED_DEFAULT_SIZE
+#define YAMC_STRIPED_DEFAULT_SIZE 16
+#endif
+
+
+/*
+ * lock striping table
+ *
+ * - yamc::striped<Mutex, N>
+ *
+ * Key is mapped to one of N mutexes by its hash value, each mutex is placed in
+ * its own cache line to prevent from false sharing between adjacent stripes,
+ * also when the table itself is allocated by new-expression.
+ * lock_all() acquires multiple stripes in ascending index order, so that
+ * concurrent lock_all() calls with any key order never deadlock.
+ */
+namespace yamc {
+
+template <typename Mutex, std::size_t N = YAMC_STRIPED_DEFAULT_SIZE>
+class striped : public yamc::detail::cacheline_aligned_new {
+  static_assert(0 < N, "N shall be positive");
+
+  struct alignas(YAMC_CACHELINE_SIZE) slot {
+    Mutex mtx;
+  };
+
+  slot slots_[N];
+
+  static std::size_t mix(std::size_t h)
+  {
+    // std::hash may be identity function (e.g. integers, pointers)
+    h ^= h >> 16;
+    h *= 0x45d9f3bu;
+    h ^= h >> 16;
+    return h;
+  }
+
+  template <typename... Keys>
+  std::array<std::size_t, sizeof...(Keys)> sorted_indices(const Keys&... keys) const
+  {
+    std::array<std::size_t, sizeof...(Keys)> idx = {{ index(keys)... }};
+    std::sort(idx.begin(), idx.end());
+    return idx;
+  }
+
+public:
+  using mutex_type = Mutex;
+
+  striped() = default;
+  ~striped() = default;
+
+  striped(const striped&) = delete;
+  striped& operator=(const striped&) = delete;
+
+  static constexpr std::size_t size() noexcept
+  {
+    return N;
+  }
+
+  template <typename Key>
+  std::size_t index(const Key& key) const
+  {
+    return mix(std::hash<Key>{}(key)) % N;
+  }
+
+  /// mutex for key
+  template <typename Key>
+  Mutex& get(const Key& key)
+  {
+    return slots_[index(key)].mtx;
+  }
+
+  /// mutex of i-th stripe
+  Mutex& at(std::size_t i)
+  {
+    return slots_[i].mtx;
+  }
+
+  template <typename Key>
+  void lock(const Key& key)
+  {
+    get(key).lock();
+  }
+
+  template <typename Key>
+  bool try_lock(const Key& key)
+  {
+    return get(key).try_lock();
+  }
+
+  template <typename Key>
+  void unlock(const Key& key)
+  {
+    get(key).unlock();
+  }
+
+  template <typename Key>
+  void lock_shared(const Key& key)
+  {
+    get(key).lock_shared();
+  }
+
+  template <typename Key>
+  bool try_lock_shared(const Key& key)
+  {
+    return get(key).try_lock_shared();
+  }
+
+  template <typename Key>
+  void unlock_shared(const Key& key)
+  {
+    get(key).unlock_shared();
+  }
+
+  /// lock stripes for all keys, keys which share stripe are locked once
+  template <typename... Keys>
+  void lock_all(const Keys&... keys)
+  {
+    const auto idx = sorted_indices(keys...);
+    for (std::size_t i = 0; i < idx.size(); i++) {
+      if (i == 0 || idx[i - 1] != idx[i])
+        slots_[idx[i]].mtx.lock();
+    }
+  }
+
+  template <typename... Keys>
+  void unlock_all(const Keys&... keys)
+  {
+    const auto idx = sorted_indices(keys...);
+    for (std::size_t i = idx.size(); 0 < i; i--) {
+      if (i == 1 || idx[i - 2] != idx[i - 1])
+        slots_[idx[i - 1]].mtx.unlock();
+    }
+  }
+
+  template <typename... Keys>
+  void lock_all_shared(const Keys&... keys)
+  {
+    const auto idx = sorted_indices(keys...);
+    for (std::size_t i = 0; i < idx.size(); i++) {
+      if (i == 0 || idx[i - 1] != idx[i])
+        slots_[idx[i]].mtx.lock_shared();
+    }
+  }
+
+  template <typename... Keys>
+  void unlock_all_shared(const Keys&... keys)
+  {
+    const auto idx = sorted_indices(keys...);
+    for (std::size_t i = idx.size(); 0 < i; i--) {
+      if (i == 1 || idx[i - 2] != idx[i - 1])
+        slots_[idx[i - 1]].mtx.unlock_shared();
+    }
+  }
+};
+
+} // namespace yamc
+
+#endif
@@ -0,0 +1,53 @@
+/*
+ * yamc_thread_hint.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2019 yohhoy
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef YAMC_THREAD_HINT_HPP_
+#define YAMC_THREAD_HINT_HPP_
+
+#include <atomic>
+#include <cstddef>
+
+
+namespace yamc {
+namespace detail {
+
+/*
+ * slot hint of the current thread
+ *
+ * Each thread gets sequential number on first call, and keeps it in thread-local storage.
+ * Unlike hash of std::thread::id (e.g. page-aligned pthread_t on libc++), consecutive
+ * threads spread over consecutive slots, and later calls cost only a thread-local load.
+ */
+inline std::size_t this_thread_slot_hint()
+{
+  static std::atomic<std::size_t> next{0};
+  static thread_local std::size_t hint = next.fetch_add(1, std::memory_order_relaxed);
+  return hint;
+}
+
+} // namespace detail
+} // namespace yamc
+
+#endif
@@ -0,0 +1,205 @@
+/*
+ * yamc_tree_barrier.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2019 yohhoy
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef YAMC_TREE_BARRIER_HPP_
+#define YAMC_TREE_BARRIER_HPP_
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <utility>
+#include "yamc_atomic_wait.hpp"
+#include "yamc_backoff_spin.hpp"
+#include "yamc_barrier.hpp"
+#include "yamc_config.hpp"
+#include "yamc_thread_hint.hpp"
+
+
+/// spin count of yamc::tree::barrier wait() before blocking
+#ifndef YAMC_BARRIER_SPINCOUNT
+#define YAMC_BARRIER_SPINCOUNT 100
+#endif
+
+
+namespace yamc {
+
+/*
+ * combining tree barrier
+ *
+ * - yamc::tree::barrier<CompletionFunction>
+ *
+ * Arriving thread starts from the tree node selected by per-thread hint, and claims
+ * a ticket of the node with CAS operation. The first arrival of each node leaves,
+ * the second one goes up to the parent node. The last arrival at the root node runs
+ * the completion function and moves to next phase. Each arrival touches O(log N)
+ * cache lines, and waiting threads spin on phase value before blocking on it.
+ * This algorithm is same as std::barrier in GNU libstdc++.
+ *
+ * arrive_and_drop() blocks until the phase completion like yamc::barrier.
+ */
+namespace tree {
+
+template <class CompletionFunction = yamc::detail::default_barrier_completion>
+class barrier {
+  using phase_type = unsigned char;
+  static constexpr std::size_t max_rounds = 64;
+
+  // tickets[r] := {old_phase=no arrival, old_phase+1=half, old_phase+2=full} at round r
+  // (each node occupies own cache line)
+  struct alignas(YAMC_CACHELINE_SIZE) node : yamc::detail::cacheline_aligned_new {
+    std::atomic<phase_type> tickets[max_rounds];
+  };
+
+  std::ptrdiff_t expected_;  // modified only in phase completion step
+  std::unique_ptr<node[]> state_;
+  std::atomic<std::ptrdiff_t> expected_adjustment_{0};
+  CompletionFunction completion_;
+  std::atomic<phase_type> phase_{0};
+
+  // return true if the last arrival of current phase
+  bool do_arrive(phase_type old_phase, std::size_t current)
+  {
+    const phase_type half_step = static_cast<phase_type>(old_phase + 1);
+    const phase_type full_step = static_cast<phase_type>(old_phase + 2);
+    std::size_t current_expected = static_cast<std::size_t>(expected_);
+    if (current_expected <= 1)
+      return true;
+    current %= ((current_expected + 1) >> 1);
+    for (std::size_t round = 0; ; ++round) {
+      if (current_expected <= 1)
+        return true;
+      const std::size_t end_node = (current_expected + 1) >> 1;
+      const std::size_t last_node = end_node - 1;
+      for (; ; ++current) {
+        if (current == end_node)
+          current = 0;
+        std::atomic<phase_type>& ticket = state_[current].tickets[round];
+        phase_type expect = old_phase;
+        if (current == last_node && (current_expected & 1)) {
+          // sole arrival of the last node, go up to next round
+          if (ticket.compare_exchange_strong(expect, full_step, std::memory_order_acq_rel))
+            break;
+        } else if (ticket.compare_exchange_strong(expect, half_step, std::memory_order_acq_rel)) {
+          // first arrival of the node
+          return false;
+        } else if (expect == half_step) {
+          // second arrival of the node, go up to next round
+          if (ticket.compare_exchange_strong(expect, full_step, std::memory_order_acq_rel))
+            break;
+        }
+      }
+      current_expected = last_node + 1;
+      current >>= 1;
+    }
+  }
+
+  void phase_completion_step(phase_type old_phase)
+  {
+    completion_();
+    expected_ += expected_adjustment_.load(std::memory_order_relaxed);
+    expected_adjustment_.store(0, std::memory_order_relaxed);
+    phase_.store(static_cast<phase_type>(old_phase + 2), std::memory_order_release);
+    yamc::atomic_notify_all(phase_);
+  }
+
+  void do_wait(phase_type old_phase) const
+  {
+    for (unsigned int n = 0; n < YAMC_BARRIER_SPINCOUNT; ++n) {
+      if (phase_.load(std::memory_order_acquire) != old_phase)
+        return;
+      yamc::backoff::cpu_relax();
+    }
+    while (phase_.load(std::memory_order_acquire) == old_phase) {
+      yamc::atomic_wait(phase_, old_phase, std::memory_order_acquire);
+    }
+  }
+
+public:
+  using arrival_token = yamc::detail::barrier_arrival_token;
+
+  static constexpr ptrdiff_t (max)() noexcept
+  {
+    return (std::numeric_limits<ptrdiff_t>::max)();
+  }
+
+  /*constexpr*/ explicit barrier(std::ptrdiff_t expected, CompletionFunction f = CompletionFunction())
+    : expected_(expected)
+    , state_(new node[static_cast<std::size_t>(expected + 1) >> 1])
+    , completion_(std::move(f))
+  {
+    assert(0 <= expected && expected < (max()));
+    const std::size_t nnode = static_cast<std::size_t>(expected + 1) >> 1;
+    for (std::size_t i = 0; i < nnode; ++i) {
+      for (auto& ticket : state_[i].tickets) {
+        ticket.store(0, std::memory_order_relaxed);
+      }
+    }
+  }
+
+  ~barrier() = default;
+
+  barrier(const barrier&) = delete;
+  barrier& operator=(const barrier&) = delete;
+
+#if 201703L <= __cplusplus
+  [[nodiscard]]
+#endif
+  arrival_token arrive(std::ptrdiff_t update = 1)
+  {
+    assert(0 < update);
+    const std::size_t current = yamc::detail::this_thread_slot_hint();
+    const phase_type old_phase = phase_.load(std::memory_order_acquire);
+    for (; 0 < update; --update) {
+      if (do_arrive(old_phase, current)) {
+        phase_completion_step(old_phase);
+      }
+    }
+    return arrival_token{old_phase};
+  }
+
+  void wait(arrival_token&& arrival) const
+  {
+    do_wait(static_cast<phase_type>(arrival.phase_));
+  }
+
+  void arrive_and_wait()
+  {
+    // equivalent to wait(arrive())
+    wait(arrive());
+  }
+
+  void arrive_and_drop()
+  {
+    expected_adjustment_.fetch_sub(1, std::memory_order_relaxed);
+    wait(arrive());
+  }
+};
+
+} // namespace tree
+} // namespace yamc
+
+#endif
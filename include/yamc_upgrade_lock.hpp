@@ -0,0 +1,187 @@
+/*
+ * yamc_upgrade_lock.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2019 yohhoy
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef YAMC_UPGRADE_LOCK_HPP_
+#define YAMC_UPGRADE_LOCK_HPP_
+
+#include <cassert>
+#include <mutex>
+#include <system_error>
+#include <utility>  // std::swap
+
+
+/*
+ * RAII wrapper of upgrade ownership (like boost::upgrade_lock)
+ *
+ * - yamc::upgrade_lock<Mutex>
+ *
+ * Mutex shall provide lock_upgrade(), try_lock_upgrade() and unlock_upgrade().
+ * To promote upgrade ownership to exclusive ownership, release() upgrade_lock and
+ * call unlock_upgrade_and_lock() (e.g. then adopt by std::unique_lock).
+ */
+namespace yamc {
+
+template <typename Mutex>
+class upgrade_lock {
+  void locking_precondition(const char* emsg)
+  {
+    if (pm_ == nullptr) {
+      throw std::system_error(std::make_error_code(std::errc::operation_not_permitted), emsg);
+    }
+    if (owns_) {
+      throw std::system_error(std::make_error_code(std::errc::resource_deadlock_would_occur), emsg);
+    }
+  }
+
+public:
+  using mutex_type = Mutex;
+
+  upgrade_lock() noexcept = default;
+
+  explicit upgrade_lock(mutex_type& m)
+  {
+    m.lock_upgrade();
+    pm_ = &m;
+    owns_ = true;
+  }
+
+  upgrade_lock(mutex_type& m, std::defer_lock_t) noexcept
+  {
+    pm_ = &m;
+    owns_ = false;
+  }
+
+  upgrade_lock(mutex_type& m, std::try_to_lock_t)
+  {
+    pm_ = &m;
+    owns_ = m.try_lock_upgrade();
+  }
+
+  upgrade_lock(mutex_type& m, std::adopt_lock_t)
+  {
+    pm_ = &m;
+    owns_ = true;
+  }
+
+  ~upgrade_lock()
+  {
+    if (owns_) {
+      assert(pm_ != nullptr);
+      pm_->unlock_upgrade();
+    }
+  }
+
+  upgrade_lock(const upgrade_lock&) = delete;
+  upgrade_lock& operator=(const upgrade_lock&) = delete;
+
+  upgrade_lock(upgrade_lock&& rhs) noexcept
+  {
+    if (pm_ && owns_) {
+      pm_->unlock_upgrade();
+    }
+    pm_ = rhs.pm_;
+    owns_ = rhs.owns_;
+    rhs.pm_ = nullptr;
+    rhs.owns_ = false;
+  }
+
+  upgrade_lock& operator=(upgrade_lock&& rhs) noexcept
+  {
+    if (pm_ && owns_) {
+      pm_->unlock_upgrade();
+    }
+    pm_ = rhs.pm_;
+    owns_ = rhs.owns_;
+    rhs.pm_ = nullptr;
+    rhs.owns_ = false;
+    return *this;
+  }
+
+  void lock()
+  {
+    locking_precondition("upgrade_lock::lock");
+    pm_->lock_upgrade();
+    owns_ = true;
+  }
+
+  bool try_lock()
+  {
+    locking_precondition("upgrade_lock::try_lock");
+    return (owns_ = pm_->try_lock_upgrade());
+  }
+
+  void unlock()
+  {
+    assert(pm_ != nullptr);
+    if (!owns_) {
+      throw std::system_error(std::make_error_code(std::errc::operation_not_permitted), "upgrade_lock::unlock");
+    }
+    pm_->unlock_upgrade();
+    owns_ = false;
+  }
+
+  void swap(upgrade_lock& sl) noexcept
+  {
+    std::swap(pm_, sl.pm_);
+    std::swap(owns_, sl.owns_);
+  }
+
+  mutex_type* release() noexcept
+  {
+    mutex_type* result = pm_;
+    pm_ = nullptr;
+    owns_ = false;
+    return result;
+  }
+
+  bool owns_lock() const noexcept
+    { return owns_; }
+
+  explicit operator bool() const noexcept
+    { return owns_; }
+
+  mutex_type* mutex() const noexcept
+    { return pm_; }
+
+private:
+  mutex_type* pm_ = nullptr;
+  bool owns_ = false;
+};
+
+} // namespace yamc
+
+
+namespace std {
+
+/// std::swap() specialization for yamc::upgrade_lock<Mutex> type
+template <typename Mutex>
+void swap(yamc::upgrade_lock<Mutex>& lhs, yamc::upgrade_lock<Mutex>& rhs) noexcept
+{
+  lhs.swap(rhs);
+}
+
+} // namespace std
+
+#endif
@@ -0,0 +1,112 @@
+/*
+ * yamc_wait_policy.hpp
+ *
+ * MIT License
+ *
+ * Copyright (c) 2019 yohhoy
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef YAMC_WAIT_POLICY_HPP_
+#define YAMC_WAIT_POLICY_HPP_
+
+#include <atomic>
+#include "yamc_atomic_wait.hpp"
+#include "yamc_backoff_spin.hpp"
+
+
+/// default spin count of yamc::wait_policy::spin_then_park<N> before blocking
+#ifndef YAMC_WAIT_SPINCOUNT
+#define YAMC_WAIT_SPINCOUNT 100
+#endif
+
+
+namespace yamc {
+
+/*
+ * waiting policy of yamc::barrier and yamc::basic_latch
+ *
+ * - yamc::wait_policy::spin<BackoffPolicy>
+ * - yamc::wait_policy::spin_then_park<SpinCount>
+ * - yamc::wait_policy::park
+ *
+ * wait(a, old, order) blocks current thread while (a == old), notify_all(a) wakes up
+ * all waiting threads. spin policy never issues system call on both sides.
+ */
+namespace wait_policy {
+
+/// busy waiting with BackoffPolicy
+template <typename BackoffPolicy = YAMC_BACKOFF_SPIN_DEFAULT>
+struct spin {
+  template <typename T>
+  static void wait(const std::atomic<T>& a, T old, std::memory_order order)
+  {
+    typename BackoffPolicy::state state;
+    while (a.load(order) == old) {
+      BackoffPolicy::wait(state);
+    }
+  }
+
+  template <typename T>
+  static void notify_all(std::atomic<T>&)
+  {
+    // no effect
+  }
+};
+
+/// spin SpinCount times before blocking with yamc::atomic_wait()
+template <unsigned int SpinCount = YAMC_WAIT_SPINCOUNT>
+struct spin_then_park {
+  template <typename T>
+  static void wait(const std::atomic<T>& a, T old, std::memory_order order)
+  {
+    for (unsigned int n = 0; n < SpinCount; ++n) {
+      if (a.load(order) != old)
+        return;
+      yamc::backoff::cpu_relax();
+    }
+    yamc::atomic_wait(a, old, order);
+  }
+
+  template <typename T>
+  static void notify_all(std::atomic<T>& a)
+  {
+    yamc::atomic_notify_all(a);
+  }
+};
+
+/// block with yamc::atomic_wait() immediately
+struct park {
+  template <typename T>
+  static void wait(const std::atomic<T>& a, T old, std::memory_order order)
+  {
+    yamc::atomic_wait(a, old, order);
+  }
+
+  template <typename T>
+  static void notify_all(std::atomic<T>& a)
+  {
+    yamc::atomic_notify_all(a);
+  }
+};
+
+} // namespace wait_policy
+} // namespace yamc
+
+#endif
@@ -0,0 +1,280 @@
+/*
+ * async_test.cpp
+ */
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "gtest/gtest.h"
+#include "yamc_async.hpp"
+#include "yamc_testutil.hpp"
+
+
+#define TEST_THREADS 4
+#define TEST_ITERATION 500u
+
+
+#if YAMC_ASYNC_SUPPORTED
+
+namespace {
+
+// fire-and-forget coroutine
+struct task {
+  struct promise_type {
+    task get_return_object() { return {}; }
+    std::suspend_never initial_suspend() { return {}; }
+    std::suspend_never final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); }
+  };
+};
+
+// executor which defers resumption until run()
+struct manual_executor {
+  std::vector<std::coroutine_handle<>>* queue;
+
+  void operator()(std::coroutine_handle<> h) const { queue->push_back(h); }
+
+  static void run(std::vector<std::coroutine_handle<>>& q)
+  {
+    while (!q.empty()) {
+      auto h = q.front();
+      q.erase(q.begin());
+      h.resume();
+    }
+  }
+};
+
+// suspend coroutines until open()
+struct gate {
+  std::vector<std::coroutine_handle<>> waiters;
+
+  auto wait()
+  {
+    struct awaiter {
+      gate& g;
+      bool await_ready() { return false; }
+      void await_suspend(std::coroutine_handle<> h) { g.waiters.push_back(h); }
+      void await_resume() {}
+    };
+    return awaiter{*this};
+  }
+
+  void open()
+  {
+    auto ws = std::move(waiters);
+    for (auto h : ws)
+      h.resume();
+  }
+};
+
+} // namespace
+
+
+// async_mutex::lock_async() resumes waiters in FIFO order
+TEST(AsyncMutexTest, FifoOrder)
+{
+  yamc::async_mutex mtx;
+  std::string log;
+  auto worker = [&](char id) -> task {
+    co_await mtx.lock_async();
+    log += id;
+    mtx.unlock();
+  };
+  ASSERT_TRUE(mtx.try_lock());
+  worker('a');
+  worker('b');
+  worker('c');
+  EXPECT_EQ("", log);
+  mtx.unlock();
+  EXPECT_EQ("abc", log);
+  EXPECT_TRUE(mtx.try_lock());
+  mtx.unlock();
+}
+
+// async_mutex::scoped_lock_async()
+TEST(AsyncMutexTest, ScopedLock)
+{
+  yamc::async_mutex mtx;
+  bool done = false;
+  auto worker = [&]() -> task {
+    auto lk = co_await mtx.scoped_lock_async();
+    EXPECT_TRUE(lk.owns_lock());
+    EXPECT_FALSE(mtx.try_lock());
+    done = true;
+  };
+  worker();
+  EXPECT_TRUE(done);
+  EXPECT_TRUE(mtx.try_lock());
+  mtx.unlock();
+}
+
+// async_mutex::lock_async(executor) resumes waiter through executor
+TEST(AsyncMutexTest, Executor)
+{
+  yamc::async_mutex mtx;
+  std::vector<std::coroutine_handle<>> queue;
+  bool done = false;
+  // coroutine lambda shall outlive its suspension
+  auto worker = [&]() -> task {
+    co_await mtx.lock_async(manual_executor{&queue});
+    done = true;
+    mtx.unlock();
+  };
+  ASSERT_TRUE(mtx.try_lock());
+  worker();
+  mtx.unlock();
+  EXPECT_FALSE(done);
+  EXPECT_EQ(1u, queue.size());
+  // lock has been handed off to the waiter
+  EXPECT_FALSE(mtx.try_lock());
+  manual_executor::run(queue);
+  EXPECT_TRUE(done);
+  EXPECT_TRUE(mtx.try_lock());
+  mtx.unlock();
+}
+
+// async_mutex with multiple threads
+TEST(AsyncMutexTest, MultiThread)
+{
+  yamc::async_mutex mtx;
+  std::size_t counter = 0;
+  std::atomic<std::size_t> ndone{0};
+  auto worker = [&]() -> task {
+    for (std::size_t n = 0; n < TEST_ITERATION; ++n) {
+      co_await mtx.lock_async();
+      counter = counter + 1;
+      mtx.unlock();
+    }
+    ++ndone;
+  };
+  yamc::test::task_runner(
+    TEST_THREADS,
+    [&](std::size_t /*id*/) {
+      worker();
+      // coroutine may be resumed on other thread
+      while (ndone.load() < TEST_THREADS) {
+        std::this_thread::yield();
+      }
+    });
+  EXPECT_EQ(TEST_ITERATION * TEST_THREADS, counter);
+}
+
+
+template <typename RwLockFairness>
+struct AsyncSharedMutexTest : ::testing::Test {};
+
+using RwLockFairnessTypes = ::testing::Types<
+  yamc::rwlock::TaskFairness,
+  yamc::rwlock::PhaseFairness
+>;
+
+TYPED_TEST_SUITE(AsyncSharedMutexTest, RwLockFairnessTypes);
+
+// async_shared_mutex shares lock between readers
+TYPED_TEST(AsyncSharedMutexTest, SharedLock)
+{
+  yamc::basic_async_shared_mutex<TypeParam> mtx;
+  gate g;
+  int nreader = 0;
+  auto reader = [&]() -> task {
+    auto lk = co_await mtx.scoped_lock_shared_async();
+    ++nreader;
+    co_await g.wait();
+  };
+  reader();
+  reader();
+  EXPECT_EQ(2, nreader);
+  EXPECT_FALSE(mtx.try_lock());
+  EXPECT_TRUE(mtx.try_lock_shared());
+  mtx.unlock_shared();
+  g.open();
+  EXPECT_TRUE(mtx.try_lock());
+  mtx.unlock();
+}
+
+// async_shared_mutex wakes up readers by RwLockFairness
+TYPED_TEST(AsyncSharedMutexTest, Fairness)
+{
+  yamc::basic_async_shared_mutex<TypeParam> mtx;
+  gate g;
+  std::string log;
+  auto reader = [&](char id) -> task {
+    co_await mtx.lock_shared_async();
+    log += id;
+    co_await g.wait();
+    mtx.unlock_shared();
+  };
+  auto writer = [&](char id) -> task {
+    co_await mtx.lock_async();
+    log += id;
+    co_await g.wait();
+    mtx.unlock();
+  };
+  ASSERT_TRUE(mtx.try_lock());
+  reader('r');
+  writer('W');
+  reader('s');
+  EXPECT_EQ("", log);
+  mtx.unlock();
+  if (TypeParam::phased) {
+    EXPECT_EQ("rs", log);
+    g.open();
+    EXPECT_EQ("rsW", log);
+  } else {
+    EXPECT_EQ("r", log);
+    g.open();
+    EXPECT_EQ("rW", log);
+    g.open();
+    EXPECT_EQ("rWs", log);
+  }
+  g.open();
+  EXPECT_TRUE(mtx.try_lock());
+  mtx.unlock();
+}
+
+
+// async_semaphore::release(update) resumes waiters in FIFO order
+TEST(AsyncSemaphoreTest, Release)
+{
+  yamc::async_semaphore sem{0};
+  std::string log;
+  auto worker = [&](char id) -> task {
+    co_await sem.acquire_async();
+    log += id;
+  };
+  worker('a');
+  worker('b');
+  worker('c');
+  EXPECT_EQ("", log);
+  sem.release(2);
+  EXPECT_EQ("ab", log);
+  EXPECT_FALSE(sem.try_acquire());
+  sem.release();
+  EXPECT_EQ("abc", log);
+  sem.release();
+  EXPECT_TRUE(sem.try_acquire());
+}
+
+// async_semaphore::acquire_async() without suspension
+TEST(AsyncSemaphoreTest, Acquire)
+{
+  yamc::async_semaphore sem{1};
+  bool done = false;
+  auto worker = [&]() -> task {
+    co_await sem.acquire_async();
+    done = true;
+  };
+  worker();
+  EXPECT_TRUE(done);
+  EXPECT_FALSE(sem.try_acquire());
+}
+
+#else
+
+TEST(AsyncMutexTest, NotSupported)
+{
+  GTEST_SKIP() << "C++20 coroutines are not supported";
+}
+
+#endif
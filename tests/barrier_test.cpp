@@ -4,9 +4,47 @@
 #include <type_traits>
 #include "gtest/gtest.h"
 #include "yamc_barrier.hpp"
+#include "yamc_tree_barrier.hpp"
 #include "yamc_testutil.hpp"
 
 
+// selector for generic barrier implementation
+struct GenericBarrier {
+  template <class CompletionFunction = yamc::detail::default_barrier_completion>
+  using barrier = yamc::barrier<CompletionFunction>;
+};
+
+// selector for generic barrier with spinning WaitPolicy
+struct SpinBarrier {
+  template <class CompletionFunction = yamc::detail::default_barrier_completion>
+  using barrier = yamc::barrier<CompletionFunction, yamc::wait_policy::spin<yamc::backoff::yield>>;
+};
+
+// selector for generic barrier with spin-then-park WaitPolicy
+struct SpinThenParkBarrier {
+  template <class CompletionFunction = yamc::detail::default_barrier_completion>
+  using barrier = yamc::barrier<CompletionFunction, yamc::wait_policy::spin_then_park<>>;
+};
+
+// selector for combining tree barrier implementation
+struct TreeBarrier {
+  template <class CompletionFunction = yamc::detail::default_barrier_completion>
+  using barrier = yamc::tree::barrier<CompletionFunction>;
+};
+
+using BarrierSelector = ::testing::Types<
+  GenericBarrier,
+  SpinBarrier,
+  SpinThenParkBarrier,
+  TreeBarrier
+>;
+
+template <typename Selector>
+struct BarrierTest : ::testing::Test {};
+
+TYPED_TEST_SUITE(BarrierTest, BarrierSelector);
+
+
 struct null_completion {
   void operator()() {}
 };
@@ -20,35 +58,35 @@ struct counting_completion {
 
 
 // type requirements (compile-time assertion)
-TEST(BarrierTest, TypeRequirements)
+TYPED_TEST(BarrierTest, TypeRequirements)
 {
-  using arrival_token = yamc::barrier<>::arrival_token;
+  using arrival_token = typename TypeParam::template barrier<>::arrival_token;
   static_assert(std::is_move_constructible<arrival_token>::value, "Cpp17MoveConstructible");
   static_assert(std::is_move_assignable<arrival_token>::value, "Cpp17MoveAssignable");
   static_assert(std::is_destructible<arrival_token>::value, "Cpp17Destructible");
 }
 
 // barrier constructor
-TEST(BarrierTest, Ctor)
+TYPED_TEST(BarrierTest, Ctor)
 {
-  EXPECT_NO_THROW(yamc::barrier<>{1});
+  EXPECT_NO_THROW(typename TypeParam::template barrier<>{1});
 }
 
 // barrier construction with completion
-TEST(BarrierTest, CtorCompletion)
+TYPED_TEST(BarrierTest, CtorCompletion)
 {
-  EXPECT_NO_THROW(yamc::barrier<null_completion>{1});
+  EXPECT_NO_THROW(typename TypeParam::template barrier<null_completion>{1});
 }
 
 // barrier construction with completion argument
-TEST(BarrierTest, CtorCompletionArg)
+TYPED_TEST(BarrierTest, CtorCompletionArg)
 {
   null_completion completion;
-  EXPECT_NO_THROW((yamc::barrier<null_completion>{1, completion}));
+  EXPECT_NO_THROW((typename TypeParam::template barrier<null_completion>{1, completion}));
 }
 
 // barrier constructor throws exception
-TEST(BarrierTest, CtorThrow)
+TYPED_TEST(BarrierTest, CtorThrow)
 {
   struct throwing_completion {
     throwing_completion() = default;
@@ -59,13 +97,13 @@ TEST(BarrierTest, CtorThrow)
     }
     void operator()() {}
   } completion;
-  EXPECT_THROW((yamc::barrier<throwing_completion>{1, completion}), int);
+  EXPECT_THROW((typename TypeParam::template barrier<throwing_completion>{1, completion}), int);
 }
 
 // barrier::arrive()
-TEST(BarrierTest, Arrive)
+TYPED_TEST(BarrierTest, Arrive)
 {
-  yamc::barrier<> barrier{3};  // expected count=3
+  typename TypeParam::template barrier<> barrier{3};  // expected count=3
   EXPECT_NO_THROW((void)barrier.arrive());   // c=3->2
   EXPECT_NO_THROW((void)barrier.arrive(2));  // c=2->0, next phase
   EXPECT_NO_THROW((void)barrier.arrive(3));  // c=3->0, next phase
@@ -73,11 +111,11 @@ TEST(BarrierTest, Arrive)
 }
 
 // barrier::arrive() with completion
-TEST(BarrierTest, ArriveCompletion)
+TYPED_TEST(BarrierTest, ArriveCompletion)
 {
   int counter = 0;
   counting_completion complation{&counter};
-  yamc::barrier<counting_completion> barrier{2, complation};  // expected count=2
+  typename TypeParam::template barrier<counting_completion> barrier{2, complation};  // expected count=2
   EXPECT_NO_THROW((void)barrier.arrive());   // c=2->1
   EXPECT_EQ(counter, 0);
   EXPECT_NO_THROW((void)barrier.arrive());   // c=1->0, call completion
@@ -87,28 +125,28 @@ TEST(BarrierTest, ArriveCompletion)
 }
 
 // barrier::wait()
-TEST(BarrierTest, Wait)
+TYPED_TEST(BarrierTest, Wait)
 {
-  yamc::barrier<> barrier{1};
+  typename TypeParam::template barrier<> barrier{1};
   EXPECT_NO_THROW(barrier.wait(barrier.arrive()));
   auto token = barrier.arrive();
   EXPECT_NO_THROW(barrier.wait(std::move(token)));
 }
 
 // barrier::arrive_and_wait()
-TEST(BarrierTest, ArriveAndWait)
+TYPED_TEST(BarrierTest, ArriveAndWait)
 {
-  yamc::barrier<> barrier{1};
+  typename TypeParam::template barrier<> barrier{1};
   EXPECT_NO_THROW(barrier.arrive_and_wait());
   EXPECT_NO_THROW(barrier.arrive_and_wait());
 }
 
 // barrier::arrive_and_wait() with completion
-TEST(BarrierTest, ArriveAndWaitCompletion)
+TYPED_TEST(BarrierTest, ArriveAndWaitCompletion)
 {
   int counter = 0;
   counting_completion complation{&counter};
-  yamc::barrier<counting_completion> barrier{1, complation};
+  typename TypeParam::template barrier<counting_completion> barrier{1, complation};
   EXPECT_NO_THROW(barrier.arrive_and_wait());
   EXPECT_EQ(counter, 1);
   EXPECT_NO_THROW(barrier.arrive_and_wait());
@@ -116,18 +154,18 @@ TEST(BarrierTest, ArriveAndWaitCompletion)
 }
 
 // barrier::arrive_and_drop()
-TEST(BarrierTest, ArriveAndDrop)
+TYPED_TEST(BarrierTest, ArriveAndDrop)
 {
-  yamc::barrier<> barrier{1};
+  typename TypeParam::template barrier<> barrier{1};
   EXPECT_NO_THROW(barrier.arrive_and_drop());
 }
 
 // barrier::arrive_and_drop() with completion
-TEST(BarrierTest, ArriveAndDropCompletion)
+TYPED_TEST(BarrierTest, ArriveAndDropCompletion)
 {
   int counter = 0;
   counting_completion complation{&counter};
-  yamc::barrier<counting_completion> barrier{1, complation};
+  typename TypeParam::template barrier<counting_completion> barrier{1, complation};
   EXPECT_NO_THROW(barrier.arrive_and_drop());
   EXPECT_EQ(counter, 1);
 }
@@ -144,10 +182,10 @@ TEST(BarrierTest, ArriveAndDropCompletion)
 //
 //   X=arrive_and_wait()
 //
-TEST(BarrierTest, BasicPhasing)
+TYPED_TEST(BarrierTest, BasicPhasing)
 {
   SETUP_STEPTEST;
-  yamc::barrier<> barrier{3};
+  typename TypeParam::template barrier<> barrier{3};
   yamc::test::task_runner(
     3,
     [&](std::size_t id) {
@@ -188,10 +226,10 @@ TEST(BarrierTest, BasicPhasing)
 //
 //   A=arrive(), W=wait()
 //
-TEST(BarrierTest, ArriveWaitPhasing)
+TYPED_TEST(BarrierTest, ArriveWaitPhasing)
 {
   SETUP_STEPTEST;
-  yamc::barrier<> barrier{2};
+  typename TypeParam::template barrier<> barrier{2};
   yamc::test::task_runner(
     2,
     [&](std::size_t id) {
@@ -230,10 +268,10 @@ TEST(BarrierTest, ArriveWaitPhasing)
 //   A=arrive(), W=wait()
 //   X=arrive_and_wait()
 //
-TEST(BarrierTest, PastToken)
+TYPED_TEST(BarrierTest, PastToken)
 {
   SETUP_STEPTEST;
-  yamc::barrier<> barrier{2};
+  typename TypeParam::template barrier<> barrier{2};
   yamc::test::task_runner(
     2,
     [&](std::size_t id) {
@@ -269,10 +307,10 @@ TEST(BarrierTest, PastToken)
 //
 //   X=arrive_and_wait(), D=arrive_and_drop()
 //
-TEST(BarrierTest, DropPhasing)
+TYPED_TEST(BarrierTest, DropPhasing)
 {
   SETUP_STEPTEST;
-  yamc::barrier<> barrier{3};
+  typename TypeParam::template barrier<> barrier{3};
   yamc::test::task_runner(
     3,
     [&](std::size_t id) {
@@ -301,8 +339,31 @@ TEST(BarrierTest, DropPhasing)
   );
 }
 
+// phasing with many threads
+TYPED_TEST(BarrierTest, ManyThreadsPhasing)
+{
+  constexpr std::size_t nthread = 13;
+  constexpr int nphase = 100;
+  int counter = 0;
+  counting_completion complation{&counter};
+  typename TypeParam::template barrier<counting_completion> barrier{nthread, complation};
+  std::atomic<int> arrived{0};
+  yamc::test::task_runner(
+    nthread,
+    [&](std::size_t /*id*/) {
+      for (int n = 1; n <= nphase; ++n) {
+        ++arrived;
+        EXPECT_NO_THROW(barrier.arrive_and_wait());
+        EXPECT_LE(static_cast<int>(nthread) * n, arrived.load());
+        EXPECT_LE(n, counter);
+      }
+    }
+  );
+  EXPECT_EQ(nphase, counter);
+}
+
 // barrier::max()
-TEST(BarrierTest, Max)
+TYPED_TEST(BarrierTest, Max)
 {
-  EXPECT_GT((yamc::barrier<>::max)(), 0);
+  EXPECT_GT((TypeParam::template barrier<>::max)(), 0);
 }
@@ -3,12 +3,20 @@
  */
 #include <type_traits>
 #include "gtest/gtest.h"
+#include "naive_spin_mutex.hpp"
+#include "ttas_spin_mutex.hpp"
 #include "checked_mutex.hpp"
 #include "checked_shared_mutex.hpp"
 #include "fair_mutex.hpp"
 #include "fair_shared_mutex.hpp"
 #include "alternate_mutex.hpp"
 #include "alternate_shared_mutex.hpp"
+#include "distributed_shared_mutex.hpp"
+#include "futex_mutex.hpp"
+#include "parking_mutex.hpp"
+#include "parking_shared_mutex.hpp"
+#include "elision_mutex.hpp"
+#include "instrumented_mutex.hpp"
 #if defined(__linux__) || defined(__APPLE__)
 #include "posix_native_mutex.hpp"
 #define ENABLE_POSIX_NATIVE_MUTEX
@@ -39,10 +47,30 @@ using NormalMutexTypes = ::testing::Types<
   yamc::fair::shared_mutex,
   yamc::alternate::mutex,
   yamc::alternate::timed_mutex,
-  yamc::alternate::shared_mutex
+  yamc::alternate::shared_mutex,
+  yamc::distributed::shared_mutex,
+  yamc::futex::mutex,
+  yamc::futex::adaptive_mutex,
+  yamc::parking::mutex,
+  yamc::parking::timed_mutex,
+  yamc::parking::fair_mutex,
+  yamc::parking::shared_mutex,
+  yamc::elision::mutex<>,
+  yamc::elision::mutex<std::mutex>,
+  yamc::elision::shared_mutex<>,
+  yamc::instrumented<yamc::fair::mutex>,
+  yamc::instrumented<yamc::alternate::shared_mutex>
 #if defined(ENABLE_POSIX_NATIVE_MUTEX)
   , yamc::posix::mutex
   , yamc::posix::shared_mutex
+  , yamc::posix::basic_native_mutex<yamc::posix::attr::prio_inherit>
+#if YAMC_POSIX_ROBUST_SUPPORTED
+  , yamc::posix::basic_native_mutex<yamc::posix::attr::prio_inherit, yamc::posix::attr::robust>
+#endif
+#if YAMC_POSIX_NP_SUPPORTED
+  , yamc::posix::basic_native_mutex<yamc::posix::attr::adaptive>
+  , yamc::posix::basic_rwlock<yamc::posix::attr::prefer_writer>
+#endif
 #if YAMC_POSIX_TIMEOUT_SUPPORTED
   , yamc::posix::timed_mutex
 #endif
@@ -119,6 +147,8 @@ TYPED_TEST(NormalMutexTest, TryLockFail)
 
 
 using RecursiveMutexTypes = ::testing::Types<
+  yamc::spin_ttas::recursive_mutex,
+  yamc::spin_ttas::basic_recursive_mutex<yamc::backoff::yield>,
   yamc::checked::recursive_mutex,
   yamc::checked::recursive_timed_mutex,
   yamc::fair::recursive_mutex,
@@ -127,6 +157,7 @@ using RecursiveMutexTypes = ::testing::Types<
   yamc::alternate::recursive_timed_mutex
 #if defined(ENABLE_POSIX_NATIVE_MUTEX)
   , yamc::posix::recursive_mutex
+  , yamc::posix::basic_native_recursive_mutex<yamc::posix::attr::prio_inherit>
 #if YAMC_POSIX_TIMEOUT_SUPPORTED
   , yamc::posix::recursive_timed_mutex
 #endif
@@ -225,6 +256,8 @@ TYPED_TEST(RecursiveMutexTest, TryLockFail)
 
 
 using TimedMutexTypes = ::testing::Types<
+  yamc::spin::timed_mutex,
+  yamc::spin_ttas::timed_mutex,
   yamc::checked::timed_mutex,
   yamc::checked::recursive_timed_mutex,
   yamc::checked::shared_timed_mutex,
@@ -233,11 +266,15 @@ using TimedMutexTypes = ::testing::Types<
   yamc::fair::shared_timed_mutex,
   yamc::alternate::timed_mutex,
   yamc::alternate::recursive_timed_mutex,
-  yamc::alternate::shared_timed_mutex
+  yamc::alternate::shared_timed_mutex,
+  yamc::parking::timed_mutex,
+  yamc::parking::fair_timed_mutex,
+  yamc::parking::shared_timed_mutex
 #if defined(ENABLE_POSIX_NATIVE_MUTEX)
 #if YAMC_POSIX_TIMEOUT_SUPPORTED
   , yamc::posix::timed_mutex
   , yamc::posix::recursive_timed_mutex
+  , yamc::posix::basic_native_mutex<yamc::posix::attr::prio_inherit>
 #endif
 #if YAMC_POSIX_TIMEOUT_SUPPORTED
   , yamc::posix::shared_timed_mutex
@@ -448,6 +485,134 @@ TEST(PosixRWLockTest, NativeHandle)
   (void)handle;  // suppress "unused variable" warning
 }
 
+#if YAMC_POSIX_CLOCKWAIT_SUPPORTED
+// posix::native_mutex::try_lock_until() with steady_clock
+TEST(NativeMutexTest, TryLockUntilSteadyClock)
+{
+  yamc::posix::native_mutex mtx;
+  EXPECT_TRUE(mtx.try_lock_until(std::chrono::steady_clock::now() + TEST_NOT_TIMEOUT));
+  {
+    yamc::test::join_thread thd([&]{
+      yamc::test::stopwatch<> sw;
+      EXPECT_FALSE(mtx.try_lock_until(std::chrono::steady_clock::now() + TEST_EXPECT_TIMEOUT));
+      EXPECT_LE(TEST_EXPECT_TIMEOUT, sw.elapsed());
+    });
+  }
+  mtx.unlock();
+}
+
+// posix::native_recursive_mutex::try_lock_until() with steady_clock
+TEST(NativeRecursiveMutexTest, TryLockUntilSteadyClock)
+{
+  yamc::posix::native_recursive_mutex mtx;
+  EXPECT_TRUE(mtx.try_lock_until(std::chrono::steady_clock::now() + TEST_NOT_TIMEOUT));
+  EXPECT_TRUE(mtx.try_lock_until(std::chrono::steady_clock::now() + TEST_NOT_TIMEOUT));
+  mtx.unlock();
+  mtx.unlock();
+}
+
+// posix::rwlock::try_lock{,_shared}_until() with steady_clock
+TEST(PosixRWLockTest, TryLockUntilSteadyClock)
+{
+  yamc::posix::rwlock mtx;
+  EXPECT_TRUE(mtx.try_lock_shared_until(std::chrono::steady_clock::now() + TEST_NOT_TIMEOUT));
+  {
+    yamc::test::join_thread thd([&]{
+      yamc::test::stopwatch<> sw;
+      EXPECT_FALSE(mtx.try_lock_until(std::chrono::steady_clock::now() + TEST_EXPECT_TIMEOUT));
+      EXPECT_LE(TEST_EXPECT_TIMEOUT, sw.elapsed());
+    });
+  }
+  mtx.unlock_shared();
+  EXPECT_TRUE(mtx.try_lock_until(std::chrono::steady_clock::now() + TEST_NOT_TIMEOUT));
+  mtx.unlock();
+}
+#endif // YAMC_POSIX_CLOCKWAIT_SUPPORTED
+
+// posix::basic_native_mutex<prio_protect<N>> sets priority ceiling
+TEST(NativeMutexTest, PrioProtect)
+{
+  yamc::posix::basic_native_mutex<yamc::posix::attr::prio_protect<1>> mtx;
+  int ceiling = 0;
+  EXPECT_EQ(0, ::pthread_mutex_getprioceiling(mtx.native_handle(), &ceiling));
+  EXPECT_EQ(1, ceiling);
+}
+
+#if YAMC_POSIX_NP_SUPPORTED
+// conflicting mutex type attributes
+TEST(NativeMutexTest, MutexTypeCount)
+{
+  using yamc::posix::detail::mutex_type_count;
+  EXPECT_EQ(0, (mutex_type_count<yamc::posix::attr::prio_inherit>::value));
+  EXPECT_EQ(1, (mutex_type_count<yamc::posix::attr::recursive, yamc::posix::attr::prio_inherit>::value));
+  EXPECT_EQ(2, (mutex_type_count<yamc::posix::attr::recursive, yamc::posix::attr::adaptive>::value));
+}
+#endif
+
+#if YAMC_POSIX_ROBUST_SUPPORTED
+// posix::basic_native_mutex<robust> recovers from owner death
+TEST(NativeMutexTest, RobustOwnerDead)
+{
+  yamc::posix::basic_native_mutex<yamc::posix::attr::robust> mtx;
+  {
+    // owner thread exits without unlock
+    yamc::test::join_thread thd([&]{
+      mtx.lock();
+    });
+  }
+  EXPECT_NO_THROW(mtx.lock());
+  EXPECT_TRUE(mtx.owner_dead());
+  EXPECT_NO_THROW(mtx.consistent());
+  EXPECT_FALSE(mtx.owner_dead());
+  mtx.unlock();
+  EXPECT_TRUE(mtx.try_lock());
+  EXPECT_FALSE(mtx.owner_dead());
+  mtx.unlock();
+}
+
+// posix::basic_native_mutex<robust> gets unusable without consistent()
+TEST(NativeMutexTest, RobustNotRecoverable)
+{
+  yamc::posix::basic_native_mutex<yamc::posix::attr::robust> mtx;
+  {
+    yamc::test::join_thread thd([&]{
+      mtx.lock();
+    });
+  }
+  EXPECT_NO_THROW(mtx.lock());
+  EXPECT_TRUE(mtx.owner_dead());
+  mtx.unlock();
+  try {
+    mtx.lock();
+    FAIL() << "lock() shall throw";
+  } catch (const std::system_error& e) {
+    EXPECT_EQ(ENOTRECOVERABLE, e.code().value());
+  }
+  EXPECT_FALSE(mtx.try_lock());
+}
+
+// posix::basic_native_recursive_mutex<robust> recovers from owner death
+TEST(NativeRecursiveMutexTest, RobustOwnerDead)
+{
+  yamc::posix::basic_native_recursive_mutex<yamc::posix::attr::robust> mtx;
+  {
+    yamc::test::join_thread thd([&]{
+      mtx.lock();
+      mtx.lock();
+    });
+  }
+  EXPECT_TRUE(mtx.try_lock());
+  EXPECT_TRUE(mtx.owner_dead());
+  EXPECT_TRUE(mtx.try_lock());
+  EXPECT_NO_THROW(mtx.consistent());
+  mtx.unlock();
+  mtx.unlock();
+  EXPECT_TRUE(mtx.try_lock());
+  EXPECT_FALSE(mtx.owner_dead());
+  mtx.unlock();
+}
+#endif // YAMC_POSIX_ROBUST_SUPPORTED
+
 #if YAMC_POSIX_SPINLOCK_SUPPORTED
 // posix::spinlock::native_handle_type
 TEST(PosixSpinlockTest, NativeHandleType)
@@ -4,6 +4,7 @@
  * test configuration:
  *   - YAMC_CHECKED_CALL_ABORT=0  throw std::system_error [default]
  *   - YAMC_CHECKED_CALL_ABORT=1  call std::abort()
+ *   - YAMC_CHECKED_SAMPLING=1    enable sampled validation
  */
 #include <system_error>
 #include "gtest/gtest.h"
@@ -442,3 +443,65 @@ TYPED_TEST(CheckedSharedTimedMutexTest, LockSharedToTryLockUntil) {
   EXPECT_CHECK_FAILURE(mtx.try_lock_until(std::chrono::system_clock::now()));
   ASSERT_NO_THROW(mtx.unlock_shared());
 }
+
+
+#if YAMC_CHECKED_SAMPLING
+using CheckedSamplingTypes = ::testing::Types<
+  yamc::checked::mutex,
+  yamc::checked::timed_mutex,
+  yamc::checked::recursive_mutex,
+  yamc::checked::recursive_timed_mutex,
+  yamc::checked::shared_mutex,
+  yamc::checked::shared_timed_mutex
+>;
+
+template <typename Mutex>
+struct CheckedSamplingTest : ::testing::Test {};
+
+TYPED_TEST_SUITE(CheckedSamplingTest, CheckedSamplingTypes);
+
+// unsampled object works as native mutex
+TYPED_TEST(CheckedSamplingTest, Unsampled) {
+  TypeParam mtx(false);
+  EXPECT_FALSE(mtx.sampled());
+  ASSERT_NO_THROW(mtx.lock());
+  {
+    yamc::test::join_thread thd([&]{
+      EXPECT_FALSE(mtx.try_lock());
+    });
+  }
+  ASSERT_NO_THROW(mtx.unlock());
+  EXPECT_TRUE(mtx.try_lock());
+  mtx.unlock();
+}
+
+// sampling rate
+TYPED_TEST(CheckedSamplingTest, SamplingRate) {
+  const unsigned saved = yamc::checked::sampling::rate();
+  yamc::checked::sampling::set_rate(0);
+  {
+    TypeParam mtx;
+    EXPECT_FALSE(mtx.sampled());
+  }
+  yamc::checked::sampling::set_rate(3);
+  {
+    std::size_t nsampled = 0;
+    for (int i = 0; i < 6; i++) {
+      TypeParam mtx;
+      nsampled += mtx.sampled() ? 1 : 0;
+    }
+    EXPECT_EQ(2u, nsampled);
+  }
+  yamc::checked::sampling::set_rate(1);
+  {
+    TypeParam mtx;
+    EXPECT_TRUE(mtx.sampled());
+  }
+  yamc::checked::sampling::set_rate(saved);
+  {
+    // explicit choice overrides sampling rate
+    TypeParam mtx(true);
+    EXPECT_TRUE(mtx.sampled());
+  }
+}
+#endif // YAMC_CHECKED_SAMPLING
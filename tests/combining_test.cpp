@@ -0,0 +1,89 @@
+/*
+ * combining_test.cpp
+ */
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+#include "gtest/gtest.h"
+// small publication table to exercise fallback path
+#define YAMC_COMBINING_SLOTS 4
+#include "yamc_combining.hpp"
+#include "ttas_spin_mutex.hpp"
+#include "fair_mutex.hpp"
+#include "yamc_testutil.hpp"
+
+
+#define TEST_THREADS 8
+#define TEST_ITERATION 10000u
+
+
+using MutexTypes = ::testing::Types<
+  std::mutex,
+  yamc::spin_ttas::mutex,
+  yamc::fair::mutex
+>;
+
+template <typename Mutex>
+struct CombiningTest : ::testing::Test {};
+
+TYPED_TEST_SUITE(CombiningTest, MutexTypes);
+
+// combining constructor
+TYPED_TEST(CombiningTest, Ctor)
+{
+  yamc::combining<int, TypeParam> c0;
+  EXPECT_EQ(0, c0.apply([](int& v) { return v; }));
+  yamc::combining<int, TypeParam> c1{42};
+  EXPECT_EQ(42, c1.apply([](int& v) { return v; }));
+}
+
+// combining::apply() without result
+TYPED_TEST(CombiningTest, ApplyVoid)
+{
+  yamc::combining<int, TypeParam> c;
+  c.apply([](int& v) { v = 5; });
+  EXPECT_EQ(5, c.apply([](int& v) { return v; }));
+}
+
+// combining::apply() with move-only result
+TYPED_TEST(CombiningTest, ApplyMoveOnly)
+{
+  yamc::combining<int, TypeParam> c{7};
+  std::unique_ptr<int> p = c.apply([](int& v) { return std::unique_ptr<int>(new int(v)); });
+  ASSERT_TRUE(p != nullptr);
+  EXPECT_EQ(7, *p);
+}
+
+// combining::apply() propagates exception to the caller
+TYPED_TEST(CombiningTest, ApplyException)
+{
+  yamc::combining<int, TypeParam> c;
+  EXPECT_THROW(c.apply([](int&) -> int { throw std::runtime_error("apply"); }), std::runtime_error);
+  EXPECT_EQ(1, c.apply([](int& v) { return ++v; }));
+}
+
+// concurrent combining::apply() returns its own result
+TYPED_TEST(CombiningTest, ConcurrentApply)
+{
+  yamc::combining<std::size_t, TypeParam> c;
+  std::vector<std::vector<std::size_t>> results(TEST_THREADS);
+  yamc::test::task_runner(
+    TEST_THREADS,
+    [&](std::size_t id) {
+      for (std::size_t n = 0; n < TEST_ITERATION; ++n) {
+        results[id].push_back(c.apply([](std::size_t& v) { return v++; }));
+      }
+    });
+  EXPECT_EQ(TEST_THREADS * TEST_ITERATION, c.apply([](std::size_t& v) { return v; }));
+  std::vector<std::size_t> all;
+  for (const auto& r : results) {
+    EXPECT_TRUE(std::is_sorted(r.begin(), r.end()));
+    all.insert(all.end(), r.begin(), r.end());
+  }
+  std::sort(all.begin(), all.end());
+  for (std::size_t i = 0; i < all.size(); i++) {
+    ASSERT_EQ(i, all[i]);
+  }
+}
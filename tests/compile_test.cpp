@@ -6,12 +6,22 @@
 #include <utility>  // std::{move,swap}
 #include "naive_spin_mutex.hpp"
 #include "ttas_spin_mutex.hpp"
+#include "mcs_spin_mutex.hpp"
+#include "ticket_spin_mutex.hpp"
+#include "ticket_spin_shared_mutex.hpp"
+#include "cohort_mutex.hpp"
 #include "checked_mutex.hpp"
 #include "checked_shared_mutex.hpp"
 #include "fair_mutex.hpp"
 #include "fair_shared_mutex.hpp"
 #include "alternate_mutex.hpp"
 #include "alternate_shared_mutex.hpp"
+#include "distributed_shared_mutex.hpp"
+#include "futex_mutex.hpp"
+#include "parking_mutex.hpp"
+#include "parking_shared_mutex.hpp"
+#include "elision_mutex.hpp"
+#include "instrumented_mutex.hpp"
 #include "yamc_testutil.hpp"
 
 
@@ -33,6 +43,15 @@ void test_requirements()
 }
 
 
+template <typename Mutex>
+void test_constexpr_ctor()
+{
+  // constant-initializable like std::mutex
+  constexpr Mutex mtx{};
+  (void)mtx;
+}
+
+
 template <typename TimedMutex>
 void test_requirements_timed()
 {
@@ -105,21 +124,72 @@ void test_requirements_shared_timed()
 }
 
 
+// lock validator of checked mutex works during dynamic initialization of static objects
+yamc::checked::mutex g_checked_mtx1;
+yamc::checked::mutex g_checked_mtx2;
+const bool g_checked_init = []{
+  std::lock_guard<yamc::checked::mutex> lk1(g_checked_mtx1);
+  std::lock_guard<yamc::checked::mutex> lk2(g_checked_mtx2);
+  return true;
+}();
+
+
 int main()
 {
+  test_constexpr_ctor<yamc::spin::mutex>();
+  test_constexpr_ctor<yamc::spin::timed_mutex>();
+  test_constexpr_ctor<yamc::spin_weak::mutex>();
+  test_constexpr_ctor<yamc::spin_ttas::mutex>();
+  test_constexpr_ctor<yamc::spin_ttas::timed_mutex>();
+  test_constexpr_ctor<yamc::spin_ttas::recursive_mutex>();
+  test_constexpr_ctor<yamc::spin_mcs::mutex>();
+  test_constexpr_ctor<yamc::spin_ticket::mutex>();
+  test_constexpr_ctor<yamc::spin_ticket::shared_mutex>();
+  test_constexpr_ctor<yamc::futex::mutex>();
+  test_constexpr_ctor<yamc::futex::adaptive_mutex>();
+  test_constexpr_ctor<yamc::parking::mutex>();
+  test_constexpr_ctor<yamc::parking::timed_mutex>();
+  test_constexpr_ctor<yamc::parking::shared_mutex>();
+  test_constexpr_ctor<yamc::parking::shared_timed_mutex>();
+
   test_requirements<yamc::spin::mutex>();
   test_requirements<yamc::spin_weak::mutex>();
   test_requirements<yamc::spin_ttas::mutex>();
+  test_requirements<yamc::spin_mcs::mutex>();
+  test_requirements<yamc::spin_ticket::mutex>();
   // spinlock mutex with yamc::backoff::* policy
   test_requirements<yamc::spin::basic_mutex<yamc::backoff::exponential<1000>>>();
   test_requirements<yamc::spin_weak::basic_mutex<yamc::backoff::exponential<1000>>>();
   test_requirements<yamc::spin_ttas::basic_mutex<yamc::backoff::exponential<1000>>>();
+  test_requirements<yamc::spin_mcs::basic_mutex<yamc::backoff::exponential<1000>>>();
+  test_requirements<yamc::spin_ticket::basic_mutex<yamc::backoff::exponential<1000>>>();
   test_requirements<yamc::spin::basic_mutex<yamc::backoff::yield>>();
   test_requirements<yamc::spin_weak::basic_mutex<yamc::backoff::yield>>();
   test_requirements<yamc::spin_ttas::basic_mutex<yamc::backoff::yield>>();
+  test_requirements<yamc::spin_mcs::basic_mutex<yamc::backoff::yield>>();
+  test_requirements<yamc::spin_ticket::basic_mutex<yamc::backoff::yield>>();
   test_requirements<yamc::spin::basic_mutex<yamc::backoff::busy>>();
   test_requirements<yamc::spin_weak::basic_mutex<yamc::backoff::busy>>();
   test_requirements<yamc::spin_ttas::basic_mutex<yamc::backoff::busy>>();
+  test_requirements<yamc::spin_mcs::basic_mutex<yamc::backoff::busy>>();
+  test_requirements<yamc::spin_ticket::basic_mutex<yamc::backoff::busy>>();
+  test_requirements<yamc::spin_ticket::basic_mutex<yamc::backoff::proportional<>>>();
+  test_requirements<yamc::spin::basic_mutex<yamc::backoff::truncated_exponential<>>>();
+  test_requirements<yamc::spin_weak::basic_mutex<yamc::backoff::truncated_exponential<>>>();
+  test_requirements<yamc::spin_ttas::basic_mutex<yamc::backoff::truncated_exponential<>>>();
+  test_requirements<yamc::spin::basic_mutex<yamc::backoff::bounded_random<>>>();
+  test_requirements<yamc::spin_weak::basic_mutex<yamc::backoff::bounded_random<>>>();
+  test_requirements<yamc::spin_ttas::basic_mutex<yamc::backoff::bounded_random<>>>();
+  test_requirements_timed<yamc::spin::timed_mutex>();
+  test_requirements_timed<yamc::spin_ttas::timed_mutex>();
+  test_requirements_timed<yamc::spin::basic_timed_mutex<yamc::backoff::busy>>();
+  test_requirements_timed<yamc::spin_ttas::basic_timed_mutex<yamc::backoff::busy>>();
+  test_requirements<yamc::spin_ttas::recursive_mutex>();
+  test_requirements<yamc::spin_ttas::basic_recursive_mutex<yamc::backoff::yield>>();
+  test_requirements_shared<yamc::spin_ticket::shared_mutex>();
+  test_requirements_shared<yamc::spin_ticket::basic_shared_mutex<yamc::backoff::yield>>();
+  test_requirements<yamc::cohort::mutex<>>();
+  test_requirements<yamc::cohort::mutex<yamc::spin_mcs::mutex, yamc::spin_ttas::mutex>>();
 
   test_requirements<yamc::checked::mutex>();
   test_requirements<yamc::checked::recursive_mutex>();
@@ -153,5 +223,34 @@ int main()
   test_requirements_shared<yamc::alternate::basic_shared_mutex<yamc::rwlock::WriterPrefer>>();
   test_requirements_shared_timed<yamc::alternate::basic_shared_timed_mutex<yamc::rwlock::ReaderPrefer>>();
   test_requirements_shared_timed<yamc::alternate::basic_shared_timed_mutex<yamc::rwlock::WriterPrefer>>();
+  test_requirements_shared<yamc::alternate::basic_shared_mutex<yamc::rwlock::LockFree<yamc::rwlock::ReaderPrefer>>>();
+  test_requirements_shared<yamc::alternate::basic_shared_mutex<yamc::rwlock::LockFree<yamc::rwlock::WriterPrefer>>>();
+  test_requirements_shared_timed<yamc::alternate::basic_shared_timed_mutex<yamc::rwlock::LockFree<yamc::rwlock::ReaderPrefer>>>();
+  test_requirements_shared_timed<yamc::alternate::basic_shared_timed_mutex<yamc::rwlock::LockFree<yamc::rwlock::WriterPrefer>>>();
+
+  test_requirements_shared<yamc::distributed::shared_mutex>();
+  test_requirements_shared<yamc::distributed::basic_shared_mutex<4>>();
+
+  test_requirements<yamc::futex::mutex>();
+  test_requirements<yamc::futex::adaptive_mutex>();
+
+  test_requirements<yamc::parking::mutex>();
+  test_requirements_timed<yamc::parking::timed_mutex>();
+  test_requirements<yamc::parking::fair_mutex>();
+  test_requirements_timed<yamc::parking::fair_timed_mutex>();
+  test_requirements_shared<yamc::parking::shared_mutex>();
+  test_requirements_shared_timed<yamc::parking::shared_timed_mutex>();
+  test_requirements_shared<yamc::parking::basic_shared_mutex<yamc::rwlock::TaskFairness>>();
+  test_requirements_shared_timed<yamc::parking::basic_shared_timed_mutex<yamc::rwlock::TaskFairness>>();
+
+  test_requirements<yamc::elision::mutex<>>();
+  test_requirements<yamc::elision::mutex<std::mutex>>();
+  test_requirements_shared<yamc::elision::shared_mutex<>>();
+  test_requirements_shared<yamc::elision::shared_mutex<yamc::fair::shared_mutex>>();
+
+  test_requirements<yamc::instrumented<std::mutex>>();
+  test_requirements_timed<yamc::instrumented<std::timed_mutex>>();
+  test_requirements_shared<yamc::instrumented<yamc::alternate::shared_mutex>>();
+  test_requirements_shared_timed<yamc::instrumented<yamc::alternate::shared_timed_mutex>>();
   return 0;
 }
@@ -180,6 +180,47 @@ TYPED_TEST(CheckedMutexTest, SimultaneousDeadlock)
 }
 
 
+// lock order inversion without actual blocking
+TYPED_TEST(CheckedMutexTest, LockOrderInversion)
+{
+  auto test_body = []{
+    TypeParam mtx1;
+    TypeParam mtx2;
+    {
+      yamc::test::join_thread thd([&]{
+        EXPECT_NO_THROW(mtx1.lock());
+        EXPECT_NO_THROW(mtx2.lock());  // mtx1 -> mtx2
+        EXPECT_NO_THROW(mtx2.unlock());
+        EXPECT_NO_THROW(mtx1.unlock());
+      });
+    }
+    ASSERT_NO_THROW(mtx2.lock());
+    EXPECT_CHECK_FAILURE_INNER({
+      mtx1.lock();  // mtx2 -> mtx1
+    });
+    EXPECT_NO_THROW(mtx2.unlock());
+  };
+  EXPECT_CHECK_FAILURE_OUTER(test_body());
+}
+
+// consistent lock order and try_lock never report deadlock
+TYPED_TEST(CheckedMutexTest, ConsistentLockOrder)
+{
+  TypeParam mtx1;
+  TypeParam mtx2;
+  for (int i = 0; i < 2; i++) {
+    ASSERT_NO_THROW(mtx1.lock());
+    EXPECT_NO_THROW(mtx2.lock());
+    EXPECT_NO_THROW(mtx2.unlock());
+    EXPECT_NO_THROW(mtx1.unlock());
+  }
+  ASSERT_NO_THROW(mtx2.lock());
+  EXPECT_TRUE(mtx1.try_lock());
+  EXPECT_NO_THROW(mtx1.unlock());
+  EXPECT_NO_THROW(mtx2.unlock());
+}
+
+
 using CheckedTimedMutexTypes = ::testing::Types<
   yamc::checked::timed_mutex,
   yamc::checked::recursive_timed_mutex,
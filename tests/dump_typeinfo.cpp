@@ -8,12 +8,23 @@
 #include <type_traits>
 #include "naive_spin_mutex.hpp"
 #include "ttas_spin_mutex.hpp"
+#include "mcs_spin_mutex.hpp"
+#include "ticket_spin_mutex.hpp"
+#include "ticket_spin_shared_mutex.hpp"
+#include "cohort_mutex.hpp"
 #include "checked_mutex.hpp"
 #include "checked_shared_mutex.hpp"
 #include "fair_mutex.hpp"
 #include "fair_shared_mutex.hpp"
 #include "alternate_mutex.hpp"
 #include "alternate_shared_mutex.hpp"
+#include "distributed_shared_mutex.hpp"
+#include "futex_mutex.hpp"
+#include "parking_mutex.hpp"
+#include "parking_shared_mutex.hpp"
+#include "elision_mutex.hpp"
+#include "yamc_striped.hpp"
+#include "instrumented_mutex.hpp"
 // platform native
 #if defined(__linux__) || defined(__APPLE__)
 #include "posix_native_mutex.hpp"
@@ -51,8 +62,15 @@ int main()
   DUMP(std::recursive_timed_mutex);
 
   DUMP(yamc::spin::mutex);
+  DUMP(yamc::spin::timed_mutex);
   DUMP(yamc::spin_weak::mutex);
   DUMP(yamc::spin_ttas::mutex);
+  DUMP(yamc::spin_ttas::timed_mutex);
+  DUMP(yamc::spin_ttas::recursive_mutex);
+  DUMP(yamc::spin_mcs::mutex);
+  DUMP(yamc::spin_ticket::mutex);
+  DUMP(yamc::spin_ticket::shared_mutex);
+  DUMP(yamc::cohort::mutex<>);
 
   DUMP(yamc::checked::mutex);
   DUMP(yamc::checked::timed_mutex);
@@ -84,11 +102,39 @@ int main()
   DUMP(yamc::alternate::basic_shared_mutex<yamc::rwlock::WriterPrefer>);
   DUMP(yamc::alternate::basic_shared_timed_mutex<yamc::rwlock::ReaderPrefer>);
   DUMP(yamc::alternate::basic_shared_timed_mutex<yamc::rwlock::WriterPrefer>);
+  DUMP(yamc::alternate::basic_shared_mutex<yamc::rwlock::LockFree<yamc::rwlock::ReaderPrefer>>);
+  DUMP(yamc::alternate::basic_shared_mutex<yamc::rwlock::LockFree<yamc::rwlock::WriterPrefer>>);
+
+  DUMP(yamc::distributed::shared_mutex);
+
+  DUMP(yamc::futex::mutex);
+  DUMP(yamc::futex::adaptive_mutex);
+
+  DUMP(yamc::parking::mutex);
+  DUMP(yamc::parking::timed_mutex);
+  DUMP(yamc::parking::fair_mutex);
+  DUMP(yamc::parking::fair_timed_mutex);
+  DUMP(yamc::parking::shared_mutex);
+  DUMP(yamc::parking::shared_timed_mutex);
+
+  DUMP(yamc::elision::mutex<>);
+  DUMP(yamc::elision::shared_mutex<>);
+
+  // padded stripes (YAMC_STRIPED_DEFAULT_SIZE)
+  DUMP(yamc::striped<yamc::spin_ttas::mutex>);
+  DUMP(yamc::striped<std::mutex>);
+  DUMP(yamc::striped<yamc::alternate::shared_mutex>);
+
+  DUMP(yamc::instrumented<std::mutex>);
+  DUMP(yamc::instrumented<yamc::spin_ttas::mutex>);
 
 #if defined(ENABLE_POSIX_NATIVE_MUTEX)
   DUMP(yamc::posix::native_mutex);
   DUMP(yamc::posix::native_recursive_mutex);
   DUMP(yamc::posix::rwlock);
+  DUMP(yamc::posix::basic_native_mutex<yamc::posix::attr::prio_inherit>);
+  DUMP(yamc::posix::basic_native_recursive_mutex<yamc::posix::attr::prio_inherit>);
+  DUMP(yamc::posix::basic_rwlock<>);
 #if YAMC_POSIX_SPINLOCK_SUPPORTED
   DUMP(yamc::posix::spinlock);
 #endif
@@ -4,6 +4,9 @@
 #include "gtest/gtest.h"
 #include "fair_mutex.hpp"
 #include "fair_shared_mutex.hpp"
+#include "parking_mutex.hpp"
+#include "parking_shared_mutex.hpp"
+#include "ticket_spin_shared_mutex.hpp"
 #include "yamc_testutil.hpp"
 
 
@@ -22,7 +25,14 @@ using FairMutexTypes = ::testing::Types<
   yamc::fair::basic_shared_mutex<yamc::rwlock::TaskFairness>,
   yamc::fair::basic_shared_mutex<yamc::rwlock::PhaseFairness>,
   yamc::fair::basic_shared_timed_mutex<yamc::rwlock::TaskFairness>,
-  yamc::fair::basic_shared_timed_mutex<yamc::rwlock::PhaseFairness>
+  yamc::fair::basic_shared_timed_mutex<yamc::rwlock::PhaseFairness>,
+  yamc::parking::fair_mutex,
+  yamc::parking::fair_timed_mutex,
+  yamc::parking::basic_shared_mutex<yamc::rwlock::TaskFairness>,
+  yamc::parking::basic_shared_mutex<yamc::rwlock::PhaseFairness>,
+  yamc::parking::basic_shared_timed_mutex<yamc::rwlock::TaskFairness>,
+  yamc::parking::basic_shared_timed_mutex<yamc::rwlock::PhaseFairness>,
+  yamc::spin_ticket::shared_mutex
 >;
 
 template <typename Mutex>
@@ -92,7 +102,10 @@ using FairTimedMutexTypes = ::testing::Types<
   yamc::fair::timed_mutex,
   yamc::fair::recursive_timed_mutex,
   yamc::fair::basic_shared_timed_mutex<yamc::rwlock::TaskFairness>,
-  yamc::fair::basic_shared_timed_mutex<yamc::rwlock::PhaseFairness>
+  yamc::fair::basic_shared_timed_mutex<yamc::rwlock::PhaseFairness>,
+  yamc::parking::fair_timed_mutex,
+  yamc::parking::basic_shared_timed_mutex<yamc::rwlock::TaskFairness>,
+  yamc::parking::basic_shared_timed_mutex<yamc::rwlock::PhaseFairness>
 >;
 
 template <typename Mutex>
@@ -222,7 +235,12 @@ using FairSharedMutexTypes = ::testing::Types<
   yamc::fair::basic_shared_mutex<yamc::rwlock::PhaseFairness>,
   yamc::fair::basic_shared_mutex<yamc::rwlock::TaskFairness>,
   yamc::fair::basic_shared_timed_mutex<yamc::rwlock::PhaseFairness>,
-  yamc::fair::basic_shared_timed_mutex<yamc::rwlock::TaskFairness>
+  yamc::fair::basic_shared_timed_mutex<yamc::rwlock::TaskFairness>,
+  yamc::parking::basic_shared_mutex<yamc::rwlock::PhaseFairness>,
+  yamc::parking::basic_shared_mutex<yamc::rwlock::TaskFairness>,
+  yamc::parking::basic_shared_timed_mutex<yamc::rwlock::PhaseFairness>,
+  yamc::parking::basic_shared_timed_mutex<yamc::rwlock::TaskFairness>,
+  yamc::spin_ticket::shared_mutex
 >;
 
 template <typename Mutex>
@@ -299,7 +317,9 @@ using TaskFairSharedMutexTypes = ::testing::Types<
   yamc::fair::basic_shared_timed_mutex<yamc::rwlock::PhaseFairness>,
 #endif
   yamc::fair::basic_shared_mutex<yamc::rwlock::TaskFairness>,
-  yamc::fair::basic_shared_timed_mutex<yamc::rwlock::TaskFairness>
+  yamc::fair::basic_shared_timed_mutex<yamc::rwlock::TaskFairness>,
+  yamc::parking::basic_shared_mutex<yamc::rwlock::TaskFairness>,
+  yamc::parking::basic_shared_timed_mutex<yamc::rwlock::TaskFairness>
 >;
 
 template <typename Mutex>
@@ -392,7 +412,10 @@ using PhaseFairSharedMutexTypes = ::testing::Types<
   yamc::fair::basic_shared_timed_mutex<yamc::rwlock::TaskFairness>,
 #endif
   yamc::fair::basic_shared_mutex<yamc::rwlock::PhaseFairness>,
-  yamc::fair::basic_shared_timed_mutex<yamc::rwlock::PhaseFairness>
+  yamc::fair::basic_shared_timed_mutex<yamc::rwlock::PhaseFairness>,
+  yamc::parking::basic_shared_mutex<yamc::rwlock::PhaseFairness>,
+  yamc::parking::basic_shared_timed_mutex<yamc::rwlock::PhaseFairness>,
+  yamc::spin_ticket::shared_mutex
 >;
 
 template <typename Mutex>
@@ -481,7 +504,9 @@ TYPED_TEST(PhaseFairSharedMutexTest, PhaseFifoSched)
 
 using FairSharedTimedMutexTypes = ::testing::Types<
   yamc::fair::basic_shared_timed_mutex<yamc::rwlock::PhaseFairness>,
-  yamc::fair::basic_shared_timed_mutex<yamc::rwlock::TaskFairness>
+  yamc::fair::basic_shared_timed_mutex<yamc::rwlock::TaskFairness>,
+  yamc::parking::basic_shared_timed_mutex<yamc::rwlock::PhaseFairness>,
+  yamc::parking::basic_shared_timed_mutex<yamc::rwlock::TaskFairness>
 >;
 
 template <typename Mutex>
@@ -0,0 +1,160 @@
+/*
+ * instrumented_test.cpp
+ */
+#include <mutex>
+#include <numeric>
+#include <sstream>
+#include "gtest/gtest.h"
+#include "instrumented_mutex.hpp"
+#include "ttas_spin_mutex.hpp"
+#include "alternate_mutex.hpp"
+#include "alternate_shared_mutex.hpp"
+#include "yamc_testutil.hpp"
+
+
+#define TEST_THREADS   8
+#define TEST_ITERATION 10000u
+
+
+using MutexTypes = ::testing::Types<
+  std::mutex,
+  yamc::spin_ttas::mutex,
+  yamc::alternate::timed_mutex,
+  yamc::alternate::shared_mutex
+>;
+
+template <typename Mutex>
+struct InstrumentedTest : ::testing::Test {};
+
+TYPED_TEST_SUITE(InstrumentedTest, MutexTypes);
+
+// acquisition count
+TYPED_TEST(InstrumentedTest, Acquisitions)
+{
+  yamc::instrumented<TypeParam> mtx;
+  for (int i = 0; i < 3; i++) {
+    std::lock_guard<decltype(mtx)> lk(mtx);
+  }
+  auto s = mtx.stats();
+  EXPECT_EQ(3u, s.acquisitions);
+  EXPECT_EQ(0u, s.contended);
+  EXPECT_EQ(3u, std::accumulate(std::begin(s.wait_hist), std::end(s.wait_hist), std::uint64_t(0)));
+  EXPECT_EQ(3u, std::accumulate(std::begin(s.hold_hist), std::end(s.hold_hist), std::uint64_t(0)));
+}
+
+// contended acquisition count
+TYPED_TEST(InstrumentedTest, Contended)
+{
+  yamc::instrumented<TypeParam> mtx;
+  yamc::test::barrier step(2);
+  {
+    yamc::test::join_thread thd([&]{
+      ASSERT_NO_THROW(mtx.lock());
+      step.await();  // b1
+      WAIT_TICKS;
+      EXPECT_NO_THROW(mtx.unlock());
+    });
+    step.await();  // b1
+    EXPECT_NO_THROW(mtx.lock());  // contended
+    EXPECT_NO_THROW(mtx.unlock());
+  }
+  auto s = mtx.stats();
+  EXPECT_EQ(2u, s.acquisitions);
+  EXPECT_EQ(1u, s.contended);
+  // contended wait falls into bins of YAMC_INSTRUMENT_CONTENDED_TICKS or more
+  EXPECT_EQ(1u, std::accumulate(std::begin(s.wait_hist) + 13, std::end(s.wait_hist), std::uint64_t(0)));
+}
+
+// counter consistency under contention
+TYPED_TEST(InstrumentedTest, ManyThreads)
+{
+  yamc::instrumented<TypeParam> mtx;
+  std::size_t counter = 0;
+  yamc::test::task_runner(
+    TEST_THREADS,
+    [&](std::size_t) {
+      for (unsigned n = 0; n < TEST_ITERATION; n++) {
+        std::lock_guard<decltype(mtx)> lk(mtx);
+        ++counter;
+      }
+    });
+  auto s = mtx.stats();
+  EXPECT_EQ(TEST_ITERATION * TEST_THREADS, counter);
+  EXPECT_EQ(TEST_ITERATION * TEST_THREADS, s.acquisitions);
+  EXPECT_LE(s.contended, s.acquisitions);
+  mtx.reset_stats();
+  EXPECT_EQ(0u, mtx.stats().acquisitions);
+}
+
+// shared-lock acquisition count
+TEST(InstrumentedSharedTest, LockShared)
+{
+  yamc::instrumented<yamc::alternate::shared_mutex> mtx;
+  EXPECT_NO_THROW(mtx.lock_shared());
+  EXPECT_TRUE(mtx.try_lock_shared());
+  EXPECT_NO_THROW(mtx.unlock_shared());
+  EXPECT_NO_THROW(mtx.unlock_shared());
+  EXPECT_EQ(2u, mtx.stats().acquisitions);
+}
+
+// shared-lock hold time
+TEST(InstrumentedSharedTest, SharedHold)
+{
+  yamc::instrumented<yamc::alternate::shared_mutex> mtx;
+  EXPECT_NO_THROW(mtx.lock_shared());
+  EXPECT_NO_THROW(mtx.lock_shared());
+  EXPECT_NO_THROW(mtx.unlock_shared());
+  EXPECT_NO_THROW(mtx.unlock_shared());
+  EXPECT_NO_THROW(mtx.lock());
+  EXPECT_NO_THROW(mtx.unlock());
+  auto s = mtx.stats();
+  EXPECT_EQ(2u, std::accumulate(std::begin(s.shared_hold_hist), std::end(s.shared_hold_hist), std::uint64_t(0)));
+  EXPECT_EQ(1u, std::accumulate(std::begin(s.hold_hist), std::end(s.hold_hist), std::uint64_t(0)));
+}
+
+// recursive lock records single hold time from outermost lock
+TEST(InstrumentedRecursiveTest, Hold)
+{
+  yamc::instrumented<std::recursive_mutex> mtx;
+  EXPECT_NO_THROW(mtx.lock());
+  EXPECT_NO_THROW(mtx.lock());
+  EXPECT_NO_THROW(mtx.unlock());
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  EXPECT_NO_THROW(mtx.unlock());
+  auto s = mtx.stats();
+  EXPECT_EQ(2u, s.acquisitions);
+  EXPECT_EQ(1u, std::accumulate(std::begin(s.hold_hist), std::end(s.hold_hist), std::uint64_t(0)));
+  // outermost hold spans the sleep (10ms is far beyond 2^12 ticks)
+  EXPECT_EQ(1u, std::accumulate(std::begin(s.hold_hist) + 13, std::end(s.hold_hist), std::uint64_t(0)));
+}
+
+// registry lists all instrumented mutexes
+TEST(InstrumentedRegistryTest, Collect)
+{
+  auto count = [](const char* name) {
+    int n = 0;
+    for (const auto& s : yamc::instrument::registry::collect()) {
+      n += (s.name == name);
+    }
+    return n;
+  };
+  EXPECT_EQ(0, count("foo"));
+  {
+    yamc::instrumented<std::mutex> mtx{"foo"};
+    EXPECT_EQ(1, count("foo"));
+  }
+  EXPECT_EQ(0, count("foo"));
+}
+
+// registry::dump_text(), dump_json()
+TEST(InstrumentedRegistryTest, Dump)
+{
+  yamc::instrumented<std::mutex> mtx{"bar\"baz"};
+  mtx.lock();
+  mtx.unlock();
+  std::ostringstream text, json;
+  yamc::instrument::registry::dump_text(text);
+  yamc::instrument::registry::dump_json(json);
+  EXPECT_NE(std::string::npos, text.str().find("bar\"baz acquisitions=1 contended=0"));
+  EXPECT_NE(std::string::npos, json.str().find("{\"name\":\"bar\\\"baz\",\"acquisitions\":1,\"contended\":0,"));
+}
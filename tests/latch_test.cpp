@@ -6,6 +6,9 @@
 #include "yamc_testutil.hpp"
 
 
+#define TEST_THREADS   8
+
+
 // latch constructor
 TEST(LatchTest, Ctor)
 {
@@ -77,8 +80,83 @@ TEST(LatchTest, ArriveAndWait)
   }
 }
 
+// latch::count_down() from many threads
+TEST(LatchTest, CountDownMany)
+{
+  yamc::latch latch{TEST_THREADS};
+  std::atomic<int> arrived{0};
+  yamc::test::task_runner(
+    TEST_THREADS + 1,
+    [&](std::size_t id) {
+      if (id == 0) {
+        // wait-thread
+        EXPECT_NO_THROW(latch.wait());
+        EXPECT_EQ(TEST_THREADS, arrived.load());
+      } else {
+        // signal-threads
+        ++arrived;
+        EXPECT_NO_THROW(latch.count_down());
+      }
+    }
+  );
+  EXPECT_TRUE(latch.try_wait());
+}
+
 // latch::max()
 TEST(LatchTest, Max)
 {
   EXPECT_GT((yamc::latch::max)(), 0);
 }
+
+
+using WaitPolicyTypes = ::testing::Types<
+  yamc::wait_policy::spin<yamc::backoff::yield>,
+  yamc::wait_policy::spin_then_park<>,
+  yamc::wait_policy::park
+>;
+
+template <typename WaitPolicy>
+struct LatchWaitPolicyTest : ::testing::Test {};
+
+TYPED_TEST_SUITE(LatchWaitPolicyTest, WaitPolicyTypes);
+
+// basic_latch<WaitPolicy>::wait()
+TYPED_TEST(LatchWaitPolicyTest, Wait)
+{
+  SETUP_STEPTEST;
+  yamc::basic_latch<TypeParam> latch{2};
+  // signal-thread
+  yamc::test::join_thread thd([&]{
+    EXPECT_STEP(1);
+    EXPECT_NO_THROW(latch.count_down());
+    EXPECT_STEP(2);
+    EXPECT_NO_THROW(latch.count_down());
+  });
+  // wait-thread
+  {
+    EXPECT_NO_THROW(latch.wait());
+    EXPECT_STEP(3);
+  }
+}
+
+// basic_latch<WaitPolicy>::count_down() from many threads
+TYPED_TEST(LatchWaitPolicyTest, CountDownMany)
+{
+  yamc::basic_latch<TypeParam> latch{TEST_THREADS};
+  std::atomic<int> arrived{0};
+  yamc::test::task_runner(
+    TEST_THREADS + 1,
+    [&](std::size_t id) {
+      if (id == 0) {
+        // wait-thread
+        EXPECT_NO_THROW(latch.wait());
+        EXPECT_EQ(TEST_THREADS, arrived.load());
+      } else {
+        // signal-threads
+        ++arrived;
+        EXPECT_NO_THROW(latch.count_down());
+      }
+    }
+  );
+  EXPECT_TRUE(latch.try_wait());
+}
@@ -2,9 +2,12 @@
  * lock_test.cpp
  */
 #include <type_traits>
+#include <vector>
 #include "gtest/gtest.h"
 #include "yamc_shared_lock.hpp"
 #include "yamc_scoped_lock.hpp"
+#include "yamc_upgrade_lock.hpp"
+#include "alternate_shared_mutex.hpp"
 #include "yamc_testutil.hpp"
 
 
@@ -488,3 +491,152 @@ TEST(ScopedLockTest, AvoidDeadlock)
     }
   });
 }
+
+// explicit scoped_lock(ordered_lock_t, Mutex1, Mutex2)
+TEST(ScopedLockTest, CtorOrderedLock2)
+{
+  MockMutex mtx1, mtx2;
+  {
+    yamc::scoped_lock<MockMutex, MockMutex> lk(yamc::ordered_lock, mtx1, mtx2);
+    EXPECT_TRUE(mtx1.locked);
+    EXPECT_TRUE(mtx2.locked);
+  }
+  EXPECT_FALSE(mtx1.locked);
+  EXPECT_FALSE(mtx2.locked);
+}
+
+// explicit scoped_lock(adaptive_lock_t, Mutex1, Mutex2)
+TEST(ScopedLockTest, CtorAdaptiveLock2)
+{
+  MockMutex mtx1, mtx2;
+  {
+    yamc::scoped_lock<MockMutex, MockMutex> lk(yamc::adaptive_lock, mtx1, mtx2);
+    EXPECT_TRUE(mtx1.locked);
+    EXPECT_TRUE(mtx2.locked);
+  }
+  EXPECT_FALSE(mtx1.locked);
+  EXPECT_FALSE(mtx2.locked);
+}
+
+using ScopedLockStrategies = ::testing::Types<
+  yamc::ordered_lock_t,
+  yamc::adaptive_lock_t,
+  yamc::basic_adaptive_lock_t<yamc::backoff::yield>
+>;
+
+template <typename Tag>
+struct ScopedLockStrategyTest : ::testing::Test {};
+
+TYPED_TEST_SUITE(ScopedLockStrategyTest, ScopedLockStrategies);
+
+// lock in reversed order concurrently
+TYPED_TEST(ScopedLockStrategyTest, AvoidDeadlock)
+{
+  std::mutex mtx1, mtx2;
+  std::size_t counter = 0;
+  yamc::test::task_runner(4, [&](std::size_t id) {
+    for (std::size_t n = 0; n < 10000; ++n) {
+      if (id % 2 == 0) {
+        yamc::scoped_lock<std::mutex, std::mutex> lk(TypeParam{}, mtx1, mtx2);
+        ++counter;
+      } else {
+        yamc::scoped_lock<std::mutex, std::mutex> lk(TypeParam{}, mtx2, mtx1);
+        ++counter;
+      }
+    }
+  });
+  EXPECT_EQ(4u * 10000u, counter);
+}
+
+// scoped_range_lock with overlapping sets
+TYPED_TEST(ScopedLockStrategyTest, RangeLock)
+{
+  std::mutex mtxs[8];
+  std::size_t counter = 0;
+  yamc::test::task_runner(4, [&](std::size_t id) {
+    for (std::size_t n = 0; n < 10000; ++n) {
+      std::vector<std::mutex*> v;
+      for (std::size_t i = 0; i < 4; ++i) {
+        v.push_back(&mtxs[(id * 3 + n + i * 5) % 8]);
+      }
+      v.push_back(v.front());  // duplicated
+      v.push_back(&mtxs[0]);  // every set shares mtxs[0], which guards counter
+      yamc::scoped_range_lock<std::mutex> lk(TypeParam{}, std::move(v));
+      ++counter;
+    }
+  });
+  EXPECT_EQ(4u * 10000u, counter);
+}
+
+// scoped_range_lock locks unique mutexes
+TEST(ScopedRangeLockTest, CtorLock)
+{
+  MockMutex mtx1, mtx2, mtx3;
+  {
+    yamc::scoped_range_lock<MockMutex> lk({&mtx3, &mtx1, &mtx3});
+    EXPECT_TRUE(mtx1.locked);
+    EXPECT_FALSE(mtx2.locked);
+    EXPECT_TRUE(mtx3.locked);
+    EXPECT_EQ(2u, lk.mutexes().size());
+  }
+  EXPECT_FALSE(mtx1.locked);
+  EXPECT_FALSE(mtx3.locked);
+}
+
+
+using UpgradeMutex = yamc::alternate::shared_mutex;
+
+// explicit upgrade_lock(mutex_type&)
+TEST(UpgradeLockTest, CtorMutex)
+{
+  UpgradeMutex mtx;
+  {
+    yamc::upgrade_lock<UpgradeMutex> lk(mtx);
+    EXPECT_EQ(&mtx, lk.mutex());
+    EXPECT_TRUE(lk.owns_lock());
+    EXPECT_FALSE(mtx.try_lock_upgrade());
+    EXPECT_TRUE(mtx.try_lock_shared());
+    mtx.unlock_shared();
+  }
+  EXPECT_TRUE(mtx.try_lock());
+  mtx.unlock();
+}
+
+// upgrade_lock(mutex_type&, try_to_lock_t)
+TEST(UpgradeLockTest, CtorTryToLock)
+{
+  UpgradeMutex mtx;
+  yamc::upgrade_lock<UpgradeMutex> lk1(mtx, std::try_to_lock);
+  EXPECT_TRUE(lk1.owns_lock());
+  yamc::upgrade_lock<UpgradeMutex> lk2(mtx, std::try_to_lock);
+  EXPECT_FALSE(lk2.owns_lock());
+}
+
+// upgrade_lock::lock(), unlock()
+TEST(UpgradeLockTest, LockUnlock)
+{
+  UpgradeMutex mtx;
+  yamc::upgrade_lock<UpgradeMutex> lk(mtx, std::defer_lock);
+  EXPECT_FALSE(lk.owns_lock());
+  lk.lock();
+  EXPECT_TRUE(lk.owns_lock());
+  EXPECT_THROW_SYSTEM_ERROR(std::errc::resource_deadlock_would_occur, {
+    lk.lock();
+  });
+  lk.unlock();
+  EXPECT_FALSE(lk.owns_lock());
+  EXPECT_THROW_SYSTEM_ERROR(std::errc::operation_not_permitted, {
+    lk.unlock();
+  });
+}
+
+// promote upgrade_lock to std::unique_lock
+TEST(UpgradeLockTest, Upgrade)
+{
+  UpgradeMutex mtx;
+  yamc::upgrade_lock<UpgradeMutex> lk(mtx);
+  UpgradeMutex* pm = lk.release();
+  pm->unlock_upgrade_and_lock();
+  std::unique_lock<UpgradeMutex> ulk(*pm, std::adopt_lock);
+  EXPECT_FALSE(mtx.try_lock_shared());
+}
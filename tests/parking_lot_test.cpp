@@ -0,0 +1,156 @@
+/*
+ * parking_lot_test.cpp
+ */
+#include <atomic>
+#include <vector>
+#include "gtest/gtest.h"
+#include "yamc_parking_lot.hpp"
+#include "yamc_testutil.hpp"
+
+
+#define TEST_THREADS 4
+
+#define TEST_EXPECT_TIMEOUT std::chrono::milliseconds(300)
+
+
+namespace {
+
+// number of threads parked on addr
+std::size_t count_parked(const void* addr)
+{
+  std::size_t n = 0;
+  yamc::parking_lot::unpark_filter(addr,
+    [&](std::intptr_t) { ++n; return yamc::parking_lot::filter_op::skip; },
+    [](const yamc::parking_lot::unpark_result&) { return std::intptr_t(0); });
+  return n;
+}
+
+void wait_parked(const void* addr, std::size_t n)
+{
+  while (count_parked(addr) < n) {
+    std::this_thread::yield();
+  }
+}
+
+} // namespace
+
+
+// park() with validation failure
+TEST(ParkingLotTest, ValidateFail)
+{
+  int obj = 0;
+  auto r = yamc::parking_lot::park(&obj, 0, []{ return false; });
+  EXPECT_FALSE(r.unparked);
+  EXPECT_EQ(0u, count_parked(&obj));
+}
+
+// park_until() timeout
+TEST(ParkingLotTest, ParkUntilTimeout)
+{
+  int obj = 0;
+  yamc::test::stopwatch<> sw;
+  auto r = yamc::parking_lot::park_until(&obj, 0, []{ return true; },
+    std::chrono::steady_clock::now() + TEST_EXPECT_TIMEOUT);
+  EXPECT_FALSE(r.unparked);
+  EXPECT_LE(TEST_EXPECT_TIMEOUT, sw.elapsed());
+  EXPECT_EQ(0u, count_parked(&obj));
+}
+
+// unpark_one() passes unpark token
+TEST(ParkingLotTest, UnparkOne)
+{
+  int obj = 0;
+  yamc::test::join_thread thd([&]{
+    auto r = yamc::parking_lot::park(&obj, 0, []{ return true; });
+    EXPECT_TRUE(r.unparked);
+    EXPECT_EQ(42, r.token);
+  });
+  wait_parked(&obj, 1);
+  auto r = yamc::parking_lot::unpark_one(&obj, [](const yamc::parking_lot::unpark_result& r) {
+    EXPECT_EQ(1u, r.unparked);
+    EXPECT_FALSE(r.have_more);
+    return std::intptr_t(42);
+  });
+  EXPECT_EQ(1u, r.unparked);
+  EXPECT_FALSE(r.have_more);
+}
+
+// unpark_one() without parked thread
+TEST(ParkingLotTest, UnparkOneEmpty)
+{
+  int obj = 0;
+  bool called = false;
+  auto r = yamc::parking_lot::unpark_one(&obj, [&](const yamc::parking_lot::unpark_result& r) {
+    called = true;
+    EXPECT_EQ(0u, r.unparked);
+    EXPECT_FALSE(r.have_more);
+    return std::intptr_t(0);
+  });
+  EXPECT_TRUE(called);
+  EXPECT_EQ(0u, r.unparked);
+}
+
+// unpark_all()
+TEST(ParkingLotTest, UnparkAll)
+{
+  int obj = 0, other = 0;
+  std::atomic<int> nunparked{0};
+  yamc::test::task_runner(TEST_THREADS + 1, [&](std::size_t id) {
+    if (id == 0) {
+      wait_parked(&obj, TEST_THREADS);
+      EXPECT_EQ(0u, yamc::parking_lot::unpark_all(&other));
+      EXPECT_EQ(std::size_t(TEST_THREADS), yamc::parking_lot::unpark_all(&obj, 7));
+    } else {
+      auto r = yamc::parking_lot::park(&obj, 0, []{ return true; });
+      EXPECT_TRUE(r.unparked);
+      EXPECT_EQ(7, r.token);
+      ++nunparked;
+    }
+  });
+  EXPECT_EQ(TEST_THREADS, nunparked);
+}
+
+// unpark_filter() walks parked threads in FIFO order
+TEST(ParkingLotTest, UnparkFilter)
+{
+  int obj = 0;
+  std::vector<std::intptr_t> order;
+  std::mutex mtx;
+  std::vector<std::thread> thds;
+  for (std::intptr_t i = 0; i < 3; i++) {
+    thds.emplace_back([&,i]{
+      auto r = yamc::parking_lot::park(&obj, i, []{ return true; });
+      EXPECT_TRUE(r.unparked);
+      std::lock_guard<std::mutex> lk(mtx);
+      order.push_back(i);
+    });
+    wait_parked(&obj, static_cast<std::size_t>(i + 1));
+  }
+  std::vector<std::intptr_t> tokens;
+  auto r = yamc::parking_lot::unpark_filter(&obj,
+    [&](std::intptr_t token) {
+      tokens.push_back(token);
+      return (token == 1) ? yamc::parking_lot::filter_op::unpark : yamc::parking_lot::filter_op::skip;
+    },
+    [](const yamc::parking_lot::unpark_result&) { return std::intptr_t(0); });
+  EXPECT_EQ(1u, r.unparked);
+  EXPECT_TRUE(r.have_more);
+  EXPECT_EQ((std::vector<std::intptr_t>{0, 1, 2}), tokens);
+  thds[1].join();
+  // front is token=0
+  tokens.clear();
+  r = yamc::parking_lot::unpark_filter(&obj,
+    [&](std::intptr_t token) {
+      tokens.push_back(token);
+      return yamc::parking_lot::filter_op::stop;
+    },
+    [](const yamc::parking_lot::unpark_result&) { return std::intptr_t(0); });
+  EXPECT_EQ(0u, r.unparked);
+  EXPECT_TRUE(r.have_more);
+  EXPECT_EQ((std::vector<std::intptr_t>{0}), tokens);
+  yamc::parking_lot::unpark_one(&obj, [](const yamc::parking_lot::unpark_result&) { return std::intptr_t(0); });
+  thds[0].join();
+  yamc::parking_lot::unpark_one(&obj, [](const yamc::parking_lot::unpark_result&) { return std::intptr_t(0); });
+  thds[2].join();
+  EXPECT_EQ((std::vector<std::intptr_t>{1, 0, 2}), order);
+}
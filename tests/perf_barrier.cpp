@@ -0,0 +1,99 @@
+/*
+ * perf_barrier.cpp
+ *
+ * barrier phase latency as thread count grows
+ * - phase: from the last arrival to the last thread resume
+ * - wakeup: from the last arrival to each thread resume
+ */
+#include <cstdint>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include "yamc_barrier.hpp"
+#include "yamc_tree_barrier.hpp"
+#include "yamc_testutil.hpp"
+
+
+#define PERF_PHASES 2000
+
+
+inline std::int64_t now_ns()
+{
+  using namespace std::chrono;
+  return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void print_latency(const yamc::test::histogram& h)
+{
+  std::cout
+    << '\t' << h.quantile(0.5) << '\t' << h.quantile(0.99) << '\t' << h.quantile(0.999)
+    << '\t' << h.quantile(1.0);
+}
+
+
+template <typename Barrier>
+void perform_phase(std::size_t nthread)
+{
+  Barrier bar(static_cast<std::ptrdiff_t>(nthread));
+  std::vector<std::vector<std::int64_t>> arrive(nthread), resume(nthread);
+
+  std::vector<std::thread> thds;
+  for (std::size_t i = 0; i < nthread; i++) {
+    arrive[i].resize(PERF_PHASES);
+    resume[i].resize(PERF_PHASES);
+    thds.emplace_back([&,i]{
+      for (unsigned p = 0; p < PERF_PHASES; p++) {
+        arrive[i][p] = now_ns();
+        bar.arrive_and_wait();
+        resume[i][p] = now_ns();
+      }
+    });
+  }
+  for (auto& t : thds) {
+    t.join();
+  }
+
+  yamc::test::histogram phase_lat, wake_lat;  // [nsec]
+  for (unsigned p = 0; p < PERF_PHASES; p++) {
+    std::int64_t last_arrive = 0, last_resume = 0;
+    for (std::size_t i = 0; i < nthread; i++) {
+      last_arrive = (std::max)(last_arrive, arrive[i][p]);
+      last_resume = (std::max)(last_resume, resume[i][p]);
+    }
+    phase_lat.add(last_resume - last_arrive);
+    for (std::size_t i = 0; i < nthread; i++) {
+      wake_lat.add(resume[i][p] - last_arrive);
+    }
+  }
+
+  std::cout << nthread;
+  print_latency(phase_lat);
+  print_latency(wake_lat);
+  std::cout << std::endl;
+}
+
+
+template <typename Barrier>
+void perf_barrier(const char* title, unsigned nthread)
+{
+  std::cout
+    << "# " << title
+    << " ncpu=" << std::thread::hardware_concurrency() << " nthread=" << nthread
+    << " phases=" << PERF_PHASES << std::endl;
+  std::cout << "# Thread\t[p50]\t[p99]\t[p99.9]\t[max]\t[wake:p50]\t[p99]\t[p99.9]\t[max]" << std::endl;
+  for (unsigned n = 2; n <= nthread; n++) {
+    perform_phase<Barrier>(n);
+  }
+  std::cout << "\n\n" << std::flush;
+}
+
+
+int main()
+{
+  unsigned nthread = 8;
+
+  perf_barrier<yamc::barrier<>>("Barrier", nthread);
+  perf_barrier<yamc::tree::barrier<>>("TreeBarrier", nthread);
+}
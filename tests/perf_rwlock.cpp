@@ -1,33 +1,98 @@
 /*
  * perf_rwlock.cpp
+ *
+ * usage: perf_rwlock [options] [type...]
+ *   -l, --list              list available mutex types
+ *   -a, --all               run all mutex types
+ *   -t, --threads N[,N..]   number of threads [10]
+ *   -r, --ratio PERCENT     mix write/read ops in each thread [off: sweep writer threads]
+ *   -c, --task WEIGHT       critical section length [100]
+ *   -w, --wait WEIGHT       think-time length [200]
+ *   -d, --duration SEC      measurement duration [5]
+ *   -p, --pin               pin threads to CPUs
+ *   -f, --format FMT        output format dat|csv|json [dat]
+ *
+ * Default "dat" output is gnuplot datasets, see perf_rwlock.sh.
  */
+#include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <cstdlib>
 #include <atomic>
 #include <chrono>
 #include <iostream>
 #include <iterator>
 #include <numeric>
 #include <mutex>
+#include <string>
 #include <thread>
+#include <utility>
 #include <vector>
+#include "naive_spin_mutex.hpp"
+#include "ttas_spin_mutex.hpp"
+#include "mcs_spin_mutex.hpp"
+#include "ticket_spin_mutex.hpp"
+#include "ticket_spin_shared_mutex.hpp"
+#include "checked_mutex.hpp"
+#include "checked_shared_mutex.hpp"
+#include "alternate_mutex.hpp"
 #include "alternate_shared_mutex.hpp"
 #include "fair_mutex.hpp"
 #include "fair_shared_mutex.hpp"
+#include "distributed_shared_mutex.hpp"
+#include "futex_mutex.hpp"
+#include "elision_mutex.hpp"
 #include "yamc_testutil.hpp"
+#if TEST_PLATFORM_LINUX || TEST_PLATFORM_OSX
+#include "posix_native_mutex.hpp"
+#define ENABLE_POSIX_NATIVE_MUTEX
+#endif
+#if TEST_PLATFORM_WINDOWS
+#include "win_native_mutex.hpp"
+#define ENABLE_WIN_NATIVE_MUTEX
+#endif
+#if TEST_PLATFORM_OSX
+#include "apple_native_mutex.hpp"
+#define ENABLE_APPLE_NATIVE_MUTEX
+#endif
+#if TEST_PLATFORM_LINUX
+#include <pthread.h>
+#include <sched.h>
+#endif
 
 
-// measurement duration
-#define PERF_DURATION std::chrono::seconds(5)
+// default measurement duration [sec]
+#define PERF_DURATION 5
 
 #define PERF_WEIGHT_TASK 100
 #define PERF_WEIGHT_WAIT 200
 
+#define PERF_NTHREAD 10
+
 #ifndef PERF_SCHED_YEILD
 #define PERF_SCHED_YEILD std::this_thread::yield()
 #endif
 
+
 // dummy task (waste CPU instructions)
-#define PERF_DUMMY_TASK(weight_) { volatile unsigned n = (weight_); while (--n); }
+inline void dummy_task(unsigned weight)
+{
+  volatile unsigned n = weight;
+  while (0 < n) {
+    n = n - 1;
+  }
+}
+
+
+struct options {
+  std::vector<unsigned> nthreads;
+  int wratio = -1;  // write percent in mixed mode, -1 = dedicated writer/reader threads
+  unsigned task = PERF_WEIGHT_TASK;
+  unsigned wait = PERF_WEIGHT_WAIT;
+  double duration = PERF_DURATION;
+  bool pin = false;
+  std::string format = "dat";
+};
 
 
 struct config {
@@ -36,125 +101,154 @@ struct config {
 };
 
 
-template <typename SharedMutex>
-void perform_rwlock_contention(const config& cfg)
-{
-  yamc::test::barrier gate(cfg.nwriter + cfg.nreader + 1);
-  std::vector<std::thread> thds;
-  std::vector<std::size_t> counters(cfg.nwriter + cfg.nreader);
+struct thread_result {
+  std::size_t nwrite = 0;
+  std::size_t nread = 0;
+  yamc::test::histogram wlat;  // acquisition latency [nsec]
+  yamc::test::histogram rlat;
+};
 
-  std::atomic<int> running = {1};
-  SharedMutex mtx;
 
-  // setup writer threads
-  for (std::size_t i = 0; i < cfg.nwriter; i++) {
-    std::size_t idx = i;
-    thds.emplace_back([&,idx]{
-      std::size_t nwcount = 0;
-      gate.await();  // start
-      while (running.load(std::memory_order_relaxed)) {
-        mtx.lock();
-        PERF_DUMMY_TASK(PERF_WEIGHT_TASK)
-        ++nwcount;  // write op
-        mtx.unlock();
-        PERF_DUMMY_TASK(PERF_WEIGHT_WAIT)
-        PERF_SCHED_YEILD;
-      }
-      gate.await();  // end
-      counters[idx] = nwcount;
-    });
-  }
+/// statistics of write or read operations
+struct group_stat {
+  std::size_t nthread = 0;
+  std::size_t nissue = 0;
+  double avg = 0.;   // [count/sec/thread]
+  double sd = 0.;    // [count/sec/thread]
+  std::uint64_t p50 = 0, p99 = 0, p999 = 0;  // [nsec]
+  double fairness = 0.;  // Jain's fairness index
+};
 
-  // setup reader threads
-  for (std::size_t i = 0; i < cfg.nreader; i++) {
-    std::size_t idx = cfg.nwriter + i;
-    thds.emplace_back([&,idx]{
-      std::size_t nrcount = 0;
-      gate.await();  // start
-      while (running.load(std::memory_order_relaxed)) {
-        mtx.lock_shared();
-        PERF_DUMMY_TASK(PERF_WEIGHT_TASK)
-        ++nrcount;  // read op
-        mtx.unlock_shared();
-        PERF_DUMMY_TASK(PERF_WEIGHT_WAIT)
-        PERF_SCHED_YEILD;
-      }
-      gate.await();  // end
-      counters[idx] = nrcount;
-    });
-  }
+struct record {
+  std::string type;
+  unsigned nthread;
+  bool rwlock;
+  group_stat wr;
+  group_stat rd;
+};
 
-  // run measurement
-  yamc::test::stopwatch<> sw;
-  gate.await();  // start
-  std::this_thread::sleep_for(PERF_DURATION);
-  running.store(0, std::memory_order_relaxed);
-  gate.await();  // end
-  double elapsed = (double)sw.elapsed().count() / 1000000.;  // [sec]
 
-  // summarize write/read issue count
-  for (auto& t : thds) {
-    t.join();
+group_stat summarize(const std::vector<std::size_t>& counts, const yamc::test::histogram& lat, double elapsed)
+{
+  group_stat s;
+  s.nthread = counts.size();
+  if (s.nthread == 0)
+    return s;
+  s.nissue = std::accumulate(counts.begin(), counts.end(), std::size_t{0});
+  s.avg = (double)s.nissue / s.nthread / elapsed;
+  double var = 0., sq = 0.;
+  for (auto v : counts) {
+    var += (v / elapsed - s.avg) * (v / elapsed - s.avg);
+    sq += (double)v * v;
   }
-  auto pivot = counters.begin();
-  std::advance(pivot, cfg.nwriter);
-  std::size_t nwissue = std::accumulate(counters.begin(), pivot, std::size_t{0});
-  std::size_t nrissue = std::accumulate(pivot, counters.end(), std::size_t{0});
-
-  // average [count/sec/thread]
-  double wavg = (double)nwissue / cfg.nwriter / elapsed;
-  double ravg = (double)nrissue / cfg.nreader / elapsed;
-  // SD(standard deviation) [count/sec/thread]
-  double wsd = std::sqrt(std::accumulate(counters.begin(), pivot, 0.,
-                                          [wavg, elapsed](double acc, std::size_t v) {
-                                            return acc + (v / elapsed - wavg) * (v / elapsed - wavg);
-                                          }) / cfg.nwriter);
-  double rsd = std::sqrt(std::accumulate(pivot, counters.end(), 0.,
-                                          [ravg, elapsed](double acc, std::size_t v) {
-                                            return acc + (v / elapsed - ravg) * (v / elapsed - ravg);
-                                          }) / cfg.nreader);
-
-  // print result
-  std::cout
-    << cfg.nwriter << '\t' << nwissue << '\t' << wavg << '\t' << wsd << '\t'
-    << cfg.nreader << '\t' << nrissue << '\t' << ravg << '\t' << rsd << std::endl;
+  s.sd = std::sqrt(var / s.nthread);
+  s.fairness = (0. < sq) ? (double)s.nissue * s.nissue / (s.nthread * sq) : 1.;
+  s.p50 = lat.quantile(0.5);
+  s.p99 = lat.quantile(0.99);
+  s.p999 = lat.quantile(0.999);
+  return s;
 }
 
 
+void pin_thread(std::thread& thd, std::size_t idx)
+{
+  const unsigned ncpu = std::thread::hardware_concurrency();
+  if (ncpu == 0)
+    return;
+#if TEST_PLATFORM_LINUX
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  CPU_SET(idx % ncpu, &cpuset);
+  pthread_setaffinity_np(thd.native_handle(), sizeof(cpuset), &cpuset);
+#elif TEST_PLATFORM_WINDOWS
+  ::SetThreadAffinityMask(thd.native_handle(), DWORD_PTR{1} << (idx % ncpu));
+#else
+  // not supported
+  (void)thd;
+  (void)idx;
+#endif
+}
+
+
+template <typename Mutex, bool Shared>
+struct lock_ops {
+  static void lock_shared(Mutex& m) { m.lock(); }
+  static void unlock_shared(Mutex& m) { m.unlock(); }
+};
+
 template <typename Mutex>
-void perform_lock_contention(const config& cfg)
+struct lock_ops<Mutex, true> {
+  static void lock_shared(Mutex& m) { m.lock_shared(); }
+  static void unlock_shared(Mutex& m) { m.unlock_shared(); }
+};
+
+
+template <typename Mutex, bool Shared>
+record perform_contention(const char* type, const config& cfg, const options& opt)
 {
-  std::size_t nthread = cfg.nwriter + cfg.nreader;
+  using clock = std::chrono::steady_clock;
+  using ops = lock_ops<Mutex, Shared>;
+  const std::size_t nthread = cfg.nwriter + cfg.nreader;
+  const bool mixed = Shared && 0 <= opt.wratio;
   yamc::test::barrier gate(nthread + 1);
   std::vector<std::thread> thds;
-  std::vector<std::size_t> counters(nthread);
+  std::vector<thread_result> results(nthread);
 
   std::atomic<int> running = {1};
   Mutex mtx;
 
-  // writer/reader threads
+  auto write_op = [&](thread_result& res) {
+    const auto t0 = clock::now();
+    mtx.lock();
+    const auto t1 = clock::now();
+    dummy_task(opt.task);
+    ++res.nwrite;  // write op
+    mtx.unlock();
+    res.wlat.add(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+  };
+  auto read_op = [&](thread_result& res) {
+    const auto t0 = clock::now();
+    ops::lock_shared(mtx);
+    const auto t1 = clock::now();
+    dummy_task(opt.task);
+    ++res.nread;  // read op
+    ops::unlock_shared(mtx);
+    res.rlat.add(std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count());
+  };
+
   for (std::size_t i = 0; i < nthread; i++) {
     std::size_t idx = i;
     thds.emplace_back([&,idx]{
-      std::size_t ncount = 0;
+      thread_result res;
+      std::uint32_t rnd = static_cast<std::uint32_t>(idx) * 2654435761u + 1;
       gate.await();  // start
       while (running.load(std::memory_order_relaxed)) {
-        mtx.lock();
-        PERF_DUMMY_TASK(PERF_WEIGHT_TASK)
-        ++ncount;  // write/read op
-        mtx.unlock();
-        PERF_DUMMY_TASK(PERF_WEIGHT_WAIT)
+        bool write;
+        if (mixed) {
+          // xorshift32
+          rnd ^= rnd << 13; rnd ^= rnd >> 17; rnd ^= rnd << 5;
+          write = (static_cast<int>(rnd % 100) < opt.wratio);
+        } else {
+          write = (idx < cfg.nwriter);
+        }
+        if (write)
+          write_op(res);
+        else
+          read_op(res);
+        dummy_task(opt.wait);
         PERF_SCHED_YEILD;
       }
       gate.await();  // end
-      counters[idx] = ncount;
+      results[idx] = std::move(res);
     });
+    if (opt.pin)
+      pin_thread(thds.back(), idx);
   }
 
   // run measurement
   yamc::test::stopwatch<> sw;
   gate.await();  // start
-  std::this_thread::sleep_for(PERF_DURATION);
+  std::this_thread::sleep_for(std::chrono::milliseconds(static_cast<long long>(opt.duration * 1000)));
   running.store(0, std::memory_order_relaxed);
   gate.await();  // end
   double elapsed = (double)sw.elapsed().count() / 1000000.;  // [sec]
@@ -163,68 +257,334 @@ void perform_lock_contention(const config& cfg)
   for (auto& t : thds) {
     t.join();
   }
-  std::size_t nissue = std::accumulate(counters.begin(), counters.end(), std::size_t{0});
+  std::vector<std::size_t> wcounts, rcounts;
+  yamc::test::histogram wlat, rlat;
+  for (std::size_t i = 0; i < nthread; i++) {
+    if (mixed || i < cfg.nwriter)
+      wcounts.push_back(results[i].nwrite);
+    if (mixed || cfg.nwriter <= i)
+      rcounts.push_back(results[i].nread);
+    wlat.merge(results[i].wlat);
+    rlat.merge(results[i].rlat);
+  }
+  record rec;
+  rec.type = type;
+  rec.nthread = static_cast<unsigned>(nthread);
+  rec.rwlock = Shared;
+  rec.wr = summarize(wcounts, wlat, elapsed);
+  rec.rd = summarize(rcounts, rlat, elapsed);
+  return rec;
+}
 
-  // average [count/sec/thread]
-  double avg = (double)nissue / nthread / elapsed;
-  // SD(standard deviation) [count/sec/thread]
-  double sd = std::sqrt(std::accumulate(counters.begin(), counters.end(), 0.,
-                                         [avg, elapsed](double acc, std::size_t v) {
-                                            return acc + (v / elapsed - avg) * (v / elapsed - avg);
-                                         }) / nthread);
 
-  // print result
-  std::cout
-    << nthread << '\t' << nissue << '\t' << avg << '\t' << sd << "\t-\t-\t-\t-" << std::endl;
-}
+/// output formatter
+class reporter {
+  const options& opt_;
+  bool first_ = true;
 
+  static void print_dat(std::ostream& os, const group_stat& s, bool valid)
+  {
+    if (valid)
+      os << s.nthread << '\t' << s.nissue << '\t' << s.avg << '\t' << s.sd;
+    else
+      os << "-\t-\t-\t-";
+  }
 
-void print_header(const char* title, unsigned nthread)
-{
-  std::cout
-    << "# " << title
-    << " ncpu=" << std::thread::hardware_concurrency() << " nthread=" << nthread
-    << " task/wait=" << PERF_WEIGHT_TASK << "/" << PERF_WEIGHT_WAIT
-    << " duration=" << PERF_DURATION.count() << std::endl;
-}
+  static void print_dat_latency(std::ostream& os, const group_stat& s, bool valid)
+  {
+    if (valid)
+      os << '\t' << s.p50 << '\t' << s.p99 << '\t' << s.p999 << '\t' << s.fairness;
+    else
+      os << "\t-\t-\t-\t-";
+  }
+
+  static void print_csv(std::ostream& os, const group_stat& s)
+  {
+    os << ',' << s.nthread << ',' << s.nissue << ',' << s.avg << ',' << s.sd
+       << ',' << s.p50 << ',' << s.p99 << ',' << s.p999 << ',' << s.fairness;
+  }
+
+  static void print_json(std::ostream& os, const char* key, const group_stat& s)
+  {
+    os << '"' << key << "\":{\"nthread\":" << s.nthread << ",\"ops\":" << s.nissue
+       << ",\"ops_per_sec\":" << s.avg << ",\"sd\":" << s.sd
+       << ",\"p50_ns\":" << s.p50 << ",\"p99_ns\":" << s.p99 << ",\"p999_ns\":" << s.p999
+       << ",\"fairness\":" << s.fairness << '}';
+  }
+
+public:
+  explicit reporter(const options& opt) : opt_(opt)
+  {
+    if (opt_.format == "csv") {
+      std::cout << "type,nthread"
+                << ",write_threads,write_ops,write_ops_per_sec,write_sd,write_p50_ns,write_p99_ns,write_p999_ns,write_fairness"
+                << ",read_threads,read_ops,read_ops_per_sec,read_sd,read_p50_ns,read_p99_ns,read_p999_ns,read_fairness"
+                << std::endl;
+    } else if (opt_.format == "json") {
+      std::cout << "[";
+    }
+  }
+
+  ~reporter()
+  {
+    if (opt_.format == "json")
+      std::cout << "\n]" << std::endl;
+  }
+
+  reporter(const reporter&) = delete;
+  reporter& operator=(const reporter&) = delete;
+
+  void begin_dataset(const char* title, unsigned nthread, bool rwlock)
+  {
+    if (opt_.format != "dat")
+      return;
+    std::cout
+      << "# " << title
+      << " ncpu=" << std::thread::hardware_concurrency() << " nthread=" << nthread
+      << " task/wait=" << opt_.task << "/" << opt_.wait
+      << " duration=" << opt_.duration;
+    if (0 <= opt_.wratio)
+      std::cout << " ratio=" << opt_.wratio;
+    std::cout << '\n';
+    if (rwlock)
+      std::cout << "# Write\t[raw]\t[ops]\t[sd]\tRead\t[raw]\t[ops]\t[sd]";
+    else
+      std::cout << "# Wt/Rd\t[raw]\t[ops]\t[sd]\t-\t-\t-\t-";
+    std::cout << "\t[p50]\t[p99]\t[p99.9]\t[fair]\t[p50]\t[p99]\t[p99.9]\t[fair]" << std::endl;
+  }
+
+  void end_dataset()
+  {
+    if (opt_.format == "dat")
+      std::cout << "\n\n" << std::flush;
+  }
+
+  void report(const record& rec)
+  {
+    if (opt_.format == "csv") {
+      std::cout << rec.type << ',' << rec.nthread;
+      print_csv(std::cout, rec.wr);
+      print_csv(std::cout, rec.rd);
+      std::cout << std::endl;
+    } else if (opt_.format == "json") {
+      std::cout << (first_ ? "\n" : ",\n")
+                << "{\"type\":\"" << rec.type << "\",\"nthread\":" << rec.nthread << ',';
+      print_json(std::cout, "write", rec.wr);
+      std::cout << ',';
+      print_json(std::cout, "read", rec.rd);
+      std::cout << '}' << std::flush;
+    } else {
+      const bool rd = (0 < rec.rd.nthread && rec.rwlock);
+      print_dat(std::cout, rec.wr, true);
+      std::cout << '\t';
+      print_dat(std::cout, rec.rd, rd);
+      print_dat_latency(std::cout, rec.wr, true);
+      print_dat_latency(std::cout, rec.rd, rd);
+      std::cout << std::endl;
+    }
+    first_ = false;
+  }
+};
 
 
 template <typename Mutex>
-void perf_lock(const char* title, unsigned nthread)
+void perf_lock(const char* title, const options& opt, reporter& out)
 {
-  print_header(title, nthread);
-  std::cout << "# Wt/Rd\t[raw]\t[ops]\t[sd]\t-\t-\t-\t-" << std::endl;
-  perform_lock_contention<Mutex>({ nthread, 0 });
-  std::cout << "\n\n" << std::flush;
+  for (unsigned nthread : opt.nthreads) {
+    out.begin_dataset(title, nthread, false);
+    out.report(perform_contention<Mutex, false>(title, { nthread, 0 }, opt));
+    out.end_dataset();
+  }
 }
 
 
 template <typename SharedMutex>
-void perf_rwlock(const char* title, unsigned nthread)
+void perf_rwlock(const char* title, const options& opt, reporter& out)
 {
-  print_header(title, nthread);
-  std::cout << "# Write\t[raw]\t[ops]\t[sd]\tRead\t[raw]\t[ops]\t[sd]" << std::endl;
-  for (unsigned nwt = 1; nwt < nthread; nwt++) {
-    config cfg = { nwt, nthread - nwt };
-    perform_rwlock_contention<SharedMutex>(cfg);
+  for (unsigned nthread : opt.nthreads) {
+    out.begin_dataset(title, nthread, true);
+    if (0 <= opt.wratio) {
+      out.report(perform_contention<SharedMutex, true>(title, { nthread, 0 }, opt));
+    } else {
+      for (unsigned nwt = 1; nwt < nthread; nwt++) {
+        config cfg = { nwt, nthread - nwt };
+        out.report(perform_contention<SharedMutex, true>(title, cfg, opt));
+      }
+    }
+    out.end_dataset();
   }
-  std::cout << "\n\n" << std::flush;
 }
 
 
-int main()
+using reader_prefer_shared_mutex = yamc::alternate::basic_shared_mutex<yamc::rwlock::ReaderPrefer>;
+using writer_prefer_shared_mutex = yamc::alternate::basic_shared_mutex<yamc::rwlock::WriterPrefer>;
+using task_fairness_shared_mutex  = yamc::fair::basic_shared_mutex<yamc::rwlock::TaskFairness>;
+using phase_fairness_shared_mutex = yamc::fair::basic_shared_mutex<yamc::rwlock::PhaseFairness>;
+
+struct perf_entry {
+  const char* name;
+  bool standard;  // run by default
+  void (*perf)(const char*, const options&, reporter&);
+};
+
+// standard entries keep dataset index order of perf_rwlock.sh
+const perf_entry perf_entries[] = {
+  { "StdMutex",   true, &perf_lock<std::mutex> },
+  { "FifoMutex",  true, &perf_lock<yamc::fair::mutex> },
+  { "TicketSpin", true, &perf_lock<yamc::spin_ticket::mutex> },
+  { "ReaderPrefer", true, &perf_rwlock<reader_prefer_shared_mutex> },
+  { "WriterPrefer", true, &perf_rwlock<writer_prefer_shared_mutex> },
+  { "TaskFair",     true, &perf_rwlock<task_fairness_shared_mutex> },
+  { "PhaseFair",    true, &perf_rwlock<phase_fairness_shared_mutex> },
+  { "Distributed",  true, &perf_rwlock<yamc::distributed::shared_mutex> },
+  { "LockFree/ReaderPrefer", true, &perf_rwlock<yamc::alternate::basic_shared_mutex<yamc::rwlock::LockFree<yamc::rwlock::ReaderPrefer>>> },
+  { "LockFree/WriterPrefer", true, &perf_rwlock<yamc::alternate::basic_shared_mutex<yamc::rwlock::LockFree<yamc::rwlock::WriterPrefer>>> },
+  // spinlock with each backoff policy
+  { "TTAS/Exponential",            true, &perf_lock<yamc::spin_ttas::basic_mutex<yamc::backoff::exponential<>>> },
+  { "TTAS/TruncatedExponential",   true, &perf_lock<yamc::spin_ttas::basic_mutex<yamc::backoff::truncated_exponential<>>> },
+  { "TTAS/BoundedRandom",          true, &perf_lock<yamc::spin_ttas::basic_mutex<yamc::backoff::bounded_random<>>> },
+  { "TTAS/Yield",                  true, &perf_lock<yamc::spin_ttas::basic_mutex<yamc::backoff::yield>> },
+  { "TTAS/Busy",                   true, &perf_lock<yamc::spin_ttas::basic_mutex<yamc::backoff::busy>> },
+  // hardware lock elision
+  { "Elision/TTAS",   true, &perf_lock<yamc::elision::mutex<>> },
+  { "Elision/Shared", true, &perf_rwlock<yamc::elision::shared_mutex<>> },
+  // phase-fair ticket spinlock (PF-T)
+  { "PhaseFair/TicketSpin", true, &perf_rwlock<yamc::spin_ticket::shared_mutex> },
+
+  // other mutex types
+  { "Spin",      false, &perf_lock<yamc::spin::mutex> },
+  { "SpinWeak",  false, &perf_lock<yamc::spin_weak::mutex> },
+  { "TTAS",      false, &perf_lock<yamc::spin_ttas::mutex> },
+  { "MCS",       false, &perf_lock<yamc::spin_mcs::mutex> },
+  { "Fair/Recursive",   false, &perf_lock<yamc::fair::recursive_mutex> },
+  { "Fair/Shared",      false, &perf_rwlock<yamc::fair::shared_mutex> },
+  { "Alternate/Recursive", false, &perf_lock<yamc::alternate::recursive_mutex> },
+  { "Alternate/Timed",     false, &perf_lock<yamc::alternate::timed_mutex> },
+  { "Alternate/Shared",    false, &perf_rwlock<yamc::alternate::shared_mutex> },
+  { "Checked",           false, &perf_lock<yamc::checked::mutex> },
+  { "Checked/Recursive", false, &perf_lock<yamc::checked::recursive_mutex> },
+  { "Checked/Shared",    false, &perf_rwlock<yamc::checked::shared_mutex> },
+  { "Futex",          false, &perf_lock<yamc::futex::mutex> },
+  { "Futex/Adaptive", false, &perf_lock<yamc::futex::adaptive_mutex> },
+#if defined(ENABLE_POSIX_NATIVE_MUTEX)
+  { "Posix/Mutex",     false, &perf_lock<yamc::posix::mutex> },
+  { "Posix/Recursive", false, &perf_lock<yamc::posix::recursive_mutex> },
+  { "Posix/RwLock",    false, &perf_rwlock<yamc::posix::shared_mutex> },
+#if YAMC_POSIX_SPINLOCK_SUPPORTED
+  { "Posix/Spinlock",  false, &perf_lock<yamc::posix::spinlock> },
+#endif
+#endif
+#if defined(ENABLE_WIN_NATIVE_MUTEX)
+  { "Win/CriticalSection", false, &perf_lock<yamc::win::critical_section> },
+  { "Win/NativeMutex",     false, &perf_lock<yamc::win::native_mutex> },
+  { "Win/SlimRwLock",      false, &perf_rwlock<yamc::win::slim_rwlock> },
+#endif
+#if defined(ENABLE_APPLE_NATIVE_MUTEX)
+  { "Apple/UnfairLock", false, &perf_lock<yamc::apple::unfair_lock> },
+#endif
+};
+
+
+int usage(const char* prog)
+{
+  std::cerr
+    << "usage: " << prog << " [options] [type...]\n"
+    << "  -l, --list              list available mutex types\n"
+    << "  -a, --all               run all mutex types\n"
+    << "  -t, --threads N[,N..]   number of threads [" << PERF_NTHREAD << "]\n"
+    << "  -r, --ratio PERCENT     mix write/read ops in each thread\n"
+    << "  -c, --task WEIGHT       critical section length [" << PERF_WEIGHT_TASK << "]\n"
+    << "  -w, --wait WEIGHT       think-time length [" << PERF_WEIGHT_WAIT << "]\n"
+    << "  -d, --duration SEC      measurement duration [" << PERF_DURATION << "]\n"
+    << "  -p, --pin               pin threads to CPUs\n"
+    << "  -f, --format FMT        output format dat|csv|json [dat]" << std::endl;
+  return 1;
+}
+
+
+int main(int argc, char* argv[])
 {
-  unsigned nthread = 10;
-  using reader_prefer_shared_mutex = yamc::alternate::basic_shared_mutex<yamc::rwlock::ReaderPrefer>;
-  using writer_prefer_shared_mutex = yamc::alternate::basic_shared_mutex<yamc::rwlock::WriterPrefer>;
-  using task_fairness_shared_mutex  = yamc::fair::basic_shared_mutex<yamc::rwlock::TaskFairness>;
-  using phase_fairness_shared_mutex = yamc::fair::basic_shared_mutex<yamc::rwlock::PhaseFairness>;
-
-  perf_lock<std::mutex>       ("StdMutex", nthread);
-  perf_lock<yamc::fair::mutex>("FifoMutex", nthread);
-
-  perf_rwlock<reader_prefer_shared_mutex>("ReaderPrefer", nthread);
-  perf_rwlock<writer_prefer_shared_mutex>("WriterPrefer", nthread);
-  perf_rwlock<task_fairness_shared_mutex> ("TaskFair", nthread);
-  perf_rwlock<phase_fairness_shared_mutex>("PhaseFair", nthread);
+  options opt;
+  bool all = false;
+  std::vector<std::string> types;
+
+  for (int i = 1; i < argc; i++) {
+    std::string arg = argv[i];
+    std::string val;
+    const auto eq = arg.find('=');
+    if (arg.compare(0, 2, "--") == 0 && eq != std::string::npos) {
+      val = arg.substr(eq + 1);
+      arg = arg.substr(0, eq);
+    }
+    auto param = [&]() -> const std::string& {
+      if (val.empty() && i + 1 < argc)
+        val = argv[++i];
+      return val;
+    };
+    if (arg == "-h" || arg == "--help") {
+      return usage(argv[0]);
+    } else if (arg == "-l" || arg == "--list") {
+      for (const auto& e : perf_entries) {
+        std::cout << e.name << (e.standard ? " *" : "") << '\n';
+      }
+      return 0;
+    } else if (arg == "-a" || arg == "--all") {
+      all = true;
+    } else if (arg == "-t" || arg == "--threads") {
+      const std::string& s = param();
+      for (std::size_t pos = 0; pos < s.size(); ) {
+        const auto next = std::min(s.find(',', pos), s.size());
+        opt.nthreads.push_back(static_cast<unsigned>(std::strtoul(s.substr(pos, next - pos).c_str(), nullptr, 10)));
+        pos = next + 1;
+      }
+    } else if (arg == "-r" || arg == "--ratio") {
+      opt.wratio = std::atoi(param().c_str());
+    } else if (arg == "-c" || arg == "--task") {
+      opt.task = static_cast<unsigned>(std::strtoul(param().c_str(), nullptr, 10));
+    } else if (arg == "-w" || arg == "--wait") {
+      opt.wait = static_cast<unsigned>(std::strtoul(param().c_str(), nullptr, 10));
+    } else if (arg == "-d" || arg == "--duration") {
+      opt.duration = std::atof(param().c_str());
+    } else if (arg == "-p" || arg == "--pin") {
+      opt.pin = true;
+    } else if (arg == "-f" || arg == "--format") {
+      opt.format = param();
+    } else if (arg[0] == '-') {
+      std::cerr << "unknown option: " << arg << std::endl;
+      return usage(argv[0]);
+    } else {
+      types.push_back(arg);
+    }
+  }
+  if (opt.nthreads.empty())
+    opt.nthreads.push_back(PERF_NTHREAD);
+  for (unsigned n : opt.nthreads) {
+    if (n == 0) {
+      std::cerr << "invalid number of threads" << std::endl;
+      return 1;
+    }
+  }
+  if (100 < opt.wratio || (opt.format != "dat" && opt.format != "csv" && opt.format != "json")) {
+    return usage(argv[0]);
+  }
+  for (const auto& t : types) {
+    bool found = false;
+    for (const auto& e : perf_entries) {
+      found |= (t == e.name);
+    }
+    if (!found) {
+      std::cerr << "unknown type: " << t << std::endl;
+      return 1;
+    }
+  }
+
+  reporter out(opt);
+  for (const auto& e : perf_entries) {
+    bool run = types.empty() ? (all || e.standard) : false;
+    for (const auto& t : types) {
+      run |= (t == e.name);
+    }
+    if (run)
+      e.perf(e.name, opt, out);
+  }
 }
@@ -20,22 +20,22 @@ set ylabel "ops/sec/thread"
 set xrange [0.5:9.5]
 set yrange [0:]
 
-plot "${DATFILE}" index 2 using 1:3   with lines     lt 1 title "ReaderPerfer/WriteLock", \
-     "${DATFILE}" index 2 using 1:3:4 with errorbars lt 1 notitle, \
-     "${DATFILE}" index 2 using 1:7   with lines     lt 2 title "ReaderPerfer/ReadLock", \
-     "${DATFILE}" index 2 using 1:7:8 with errorbars lt 2 notitle, \
-     "${DATFILE}" index 3 using 1:3   with lines     lt 3 title "WriterPerfer/WriteLock", \
-     "${DATFILE}" index 3 using 1:3:4 with errorbars lt 3 notitle, \
-     "${DATFILE}" index 3 using 1:7   with lines     lt 4 title "WriterPerfer/ReadLock", \
-     "${DATFILE}" index 3 using 1:7:8 with errorbars lt 4 notitle, \
-     "${DATFILE}" index 4 using 1:3   with lines     lt 5 title "TaskFair/WriteLock", \
-     "${DATFILE}" index 4 using 1:3:4 with errorbars lt 5 notitle, \
-     "${DATFILE}" index 4 using 1:7   with lines     lt 6 title "TaskFair/ReadLock", \
-     "${DATFILE}" index 4 using 1:7:8 with errorbars lt 6 notitle, \
-     "${DATFILE}" index 5 using 1:3   with lines     lt 7 title "PhaseFair/WriteLock", \
-     "${DATFILE}" index 5 using 1:3:4 with errorbars lt 7 notitle, \
-     "${DATFILE}" index 5 using 1:7   with lines     lt 8 title "PhaseFair/ReadLock", \
-     "${DATFILE}" index 5 using 1:7:8 with errorbars lt 8 notitle,
+plot "${DATFILE}" index 3 using 1:3   with lines     lt 1 title "ReaderPerfer/WriteLock", \
+     "${DATFILE}" index 3 using 1:3:4 with errorbars lt 1 notitle, \
+     "${DATFILE}" index 3 using 1:7   with lines     lt 2 title "ReaderPerfer/ReadLock", \
+     "${DATFILE}" index 3 using 1:7:8 with errorbars lt 2 notitle, \
+     "${DATFILE}" index 4 using 1:3   with lines     lt 3 title "WriterPerfer/WriteLock", \
+     "${DATFILE}" index 4 using 1:3:4 with errorbars lt 3 notitle, \
+     "${DATFILE}" index 4 using 1:7   with lines     lt 4 title "WriterPerfer/ReadLock", \
+     "${DATFILE}" index 4 using 1:7:8 with errorbars lt 4 notitle, \
+     "${DATFILE}" index 5 using 1:3   with lines     lt 5 title "TaskFair/WriteLock", \
+     "${DATFILE}" index 5 using 1:3:4 with errorbars lt 5 notitle, \
+     "${DATFILE}" index 5 using 1:7   with lines     lt 6 title "TaskFair/ReadLock", \
+     "${DATFILE}" index 5 using 1:7:8 with errorbars lt 6 notitle, \
+     "${DATFILE}" index 6 using 1:3   with lines     lt 7 title "PhaseFair/WriteLock", \
+     "${DATFILE}" index 6 using 1:3:4 with errorbars lt 7 notitle, \
+     "${DATFILE}" index 6 using 1:7   with lines     lt 8 title "PhaseFair/ReadLock", \
+     "${DATFILE}" index 6 using 1:7:8 with errorbars lt 8 notitle,
 EOT
 
 
@@ -51,10 +51,10 @@ set ylabel "ops/sec/thread"
 set xrange [0.5:9.5]
 set yrange [0:]
 
-plot "${DATFILE}" index 2 using 1:3 with linespoints lt 1 title "ReaderPerfer/WriteLock", \
-     "${DATFILE}" index 2 using 1:7 with linespoints lt 2 title "ReaderPerfer/ReadLock", \
-     "${DATFILE}" index 3 using 1:3 with linespoints lt 3 title "WriterPerfer/WriteLock", \
-     "${DATFILE}" index 3 using 1:7 with linespoints lt 4 title "WriterPerfer/ReadLock",
+plot "${DATFILE}" index 3 using 1:3 with linespoints lt 1 title "ReaderPerfer/WriteLock", \
+     "${DATFILE}" index 3 using 1:7 with linespoints lt 2 title "ReaderPerfer/ReadLock", \
+     "${DATFILE}" index 4 using 1:3 with linespoints lt 3 title "WriterPerfer/WriteLock", \
+     "${DATFILE}" index 4 using 1:7 with linespoints lt 4 title "WriterPerfer/ReadLock",
 EOT
 
 
@@ -70,8 +70,10 @@ set ylabel "ops/sec/thread"
 set xrange [0.5:9.5]
 set yrange [0:]
 
-plot "${DATFILE}" index 4 using 1:3 with linespoints lt 5 title "TaskFair/WriteLock", \
-     "${DATFILE}" index 4 using 1:7 with linespoints lt 6 title "TaskFair/ReadLock", \
-     "${DATFILE}" index 5 using 1:3 with linespoints lt 7 title "PhaseFair/WriteLock", \
-     "${DATFILE}" index 5 using 1:7 with linespoints lt 8 title "PhaseFair/ReadLock",
+plot "${DATFILE}" index 5 using 1:3 with linespoints lt 5 title "TaskFair/WriteLock", \
+     "${DATFILE}" index 5 using 1:7 with linespoints lt 6 title "TaskFair/ReadLock", \
+     "${DATFILE}" index 6 using 1:3 with linespoints lt 7 title "PhaseFair/WriteLock", \
+     "${DATFILE}" index 6 using 1:7 with linespoints lt 8 title "PhaseFair/ReadLock", \
+     "${DATFILE}" index 17 using 1:3 with linespoints lt 9 title "PhaseFair/TicketSpin/WriteLock", \
+     "${DATFILE}" index 17 using 1:7 with linespoints lt 10 title "PhaseFair/TicketSpin/ReadLock",
 EOT
@@ -0,0 +1,155 @@
+/*
+ * perf_seqlock.cpp
+ */
+#include <cmath>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <iterator>
+#include <numeric>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "alternate_shared_mutex.hpp"
+#include "fair_shared_mutex.hpp"
+#include "distributed_shared_mutex.hpp"
+#include "ttas_spin_mutex.hpp"
+#include "yamc_seqlock.hpp"
+#include "yamc_testutil.hpp"
+
+
+// measurement duration
+#define PERF_DURATION std::chrono::seconds(5)
+
+#define PERF_WEIGHT_WAIT 200
+#define PERF_WRITE_INTERVAL std::chrono::microseconds(100)
+
+// dummy task (waste CPU instructions)
+#define PERF_DUMMY_TASK(weight_) { volatile unsigned n = (weight_); while (--n); }
+
+
+// snapshot of a few cache lines
+struct snapshot {
+  unsigned v[48];
+};
+
+
+// shared mutex + snapshot, which has same interface as yamc::seqlock
+template <typename SharedMutex>
+class locked_snapshot {
+  snapshot data_{};
+  mutable SharedMutex mtx_;
+public:
+  snapshot load() const
+  {
+    mtx_.lock_shared();
+    snapshot s = data_;
+    mtx_.unlock_shared();
+    return s;
+  }
+  void store(const snapshot& s)
+  {
+    mtx_.lock();
+    data_ = s;
+    mtx_.unlock();
+  }
+};
+
+
+template <typename Snapshot>
+void perform_read_throughput(std::size_t nreader)
+{
+  yamc::test::barrier gate(nreader + 2);
+  std::vector<std::thread> thds;
+  std::vector<std::size_t> counters(nreader);
+  std::size_t nwissue = 0;
+
+  std::atomic<int> running = {1};
+  Snapshot data;
+
+  // setup writer thread
+  thds.emplace_back([&]{
+    snapshot s = {};
+    gate.await();  // start
+    while (running.load(std::memory_order_relaxed)) {
+      for (auto& e : s.v) { ++e; }
+      data.store(s);
+      ++nwissue;
+      std::this_thread::sleep_for(PERF_WRITE_INTERVAL);
+    }
+    gate.await();  // end
+  });
+
+  // setup reader threads
+  for (std::size_t i = 0; i < nreader; i++) {
+    std::size_t idx = i;
+    thds.emplace_back([&,idx]{
+      std::size_t nrcount = 0;
+      volatile unsigned sink = 0;
+      gate.await();  // start
+      while (running.load(std::memory_order_relaxed)) {
+        snapshot s = data.load();
+        sink = s.v[0];  // consume snapshot
+        ++nrcount;  // read op
+        PERF_DUMMY_TASK(PERF_WEIGHT_WAIT)
+      }
+      gate.await();  // end
+      counters[idx] = nrcount;
+      (void)sink;
+    });
+  }
+
+  // run measurement
+  yamc::test::stopwatch<> sw;
+  gate.await();  // start
+  std::this_thread::sleep_for(PERF_DURATION);
+  running.store(0, std::memory_order_relaxed);
+  gate.await();  // end
+  double elapsed = (double)sw.elapsed().count() / 1000000.;  // [sec]
+
+  for (auto& t : thds) {
+    t.join();
+  }
+  std::size_t nrissue = std::accumulate(counters.begin(), counters.end(), std::size_t{0});
+
+  // average [count/sec/thread]
+  double ravg = (double)nrissue / nreader / elapsed;
+  // SD(standard deviation) [count/sec/thread]
+  double rsd = std::sqrt(std::accumulate(counters.begin(), counters.end(), 0.,
+                                          [ravg, elapsed](double acc, std::size_t v) {
+                                            return acc + (v / elapsed - ravg) * (v / elapsed - ravg);
+                                          }) / nreader);
+
+  // print result
+  std::cout
+    << nreader << '\t' << nrissue << '\t' << ravg << '\t' << rsd << '\t' << nwissue << std::endl;
+}
+
+
+template <typename Snapshot>
+void perf_read(const char* title, unsigned nthread)
+{
+  std::cout
+    << "# " << title
+    << " ncpu=" << std::thread::hardware_concurrency() << " nthread=" << nthread
+    << " wait=" << PERF_WEIGHT_WAIT
+    << " duration=" << PERF_DURATION.count() << std::endl;
+  std::cout << "# Read\t[raw]\t[ops]\t[sd]\tWrite" << std::endl;
+  for (unsigned nrd = 1; nrd < nthread; nrd++) {
+    perform_read_throughput<Snapshot>(nrd);
+  }
+  std::cout << "\n\n" << std::flush;
+}
+
+
+int main()
+{
+  unsigned nthread = 10;
+
+  perf_read<yamc::seqlock<snapshot>>("Seqlock", nthread);
+  perf_read<locked_snapshot<yamc::alternate::basic_shared_mutex<yamc::rwlock::ReaderPrefer>>>("ReaderPrefer", nthread);
+  perf_read<locked_snapshot<yamc::alternate::basic_shared_mutex<yamc::rwlock::WriterPrefer>>>("WriterPrefer", nthread);
+  perf_read<locked_snapshot<yamc::alternate::basic_shared_mutex<yamc::rwlock::LockFree<yamc::rwlock::ReaderPrefer>>>>("LockFree/ReaderPrefer", nthread);
+  perf_read<locked_snapshot<yamc::fair::basic_shared_mutex<yamc::rwlock::PhaseFairness>>>("PhaseFair", nthread);
+  perf_read<locked_snapshot<yamc::distributed::shared_mutex>>("Distributed", nthread);
+}
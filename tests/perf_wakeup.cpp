@@ -0,0 +1,202 @@
+/*
+ * perf_wakeup.cpp
+ *
+ * release-to-resume latency of semaphore and latch
+ * - ping-pong: two threads handoff binary semaphores alternately
+ * - fan-out: single releaser wakes up N blocked waiters at once
+ */
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "yamc_semaphore.hpp"
+#include "yamc_latch.hpp"
+#include "yamc_testutil.hpp"
+#if defined(__APPLE__)
+#include "gcd_semaphore.hpp"
+#define ENABLE_GCD_SEMAPHORE
+#endif
+#if defined(__linux__) && !defined(__APPLE__)
+#include "posix_semaphore.hpp"
+#define ENABLE_POSIX_SEMAPHORE
+#endif
+#if defined(_WIN32)
+#include "win_semaphore.hpp"
+#define ENABLE_WIN_SEMAPHORE
+#endif
+
+
+#define PERF_ITERATION 10000
+#define PERF_FANOUT_ITERATION 1000
+
+// interval between fan-out rounds, waiters are blocked after it
+#define PERF_FANOUT_INTERVAL std::chrono::microseconds(200)
+
+
+inline std::int64_t now_ns()
+{
+  using namespace std::chrono;
+  return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+inline void update_max(std::atomic<std::int64_t>& a, std::int64_t v)
+{
+  std::int64_t cur = a.load(std::memory_order_relaxed);
+  while (cur < v && !a.compare_exchange_weak(cur, v, std::memory_order_relaxed)) {}
+}
+
+void print_latency(const yamc::test::histogram& h)
+{
+  std::cout
+    << '\t' << h.quantile(0.5) << '\t' << h.quantile(0.99) << '\t' << h.quantile(0.999)
+    << '\t' << h.quantile(1.0);
+}
+
+void print_header(const char* title, const char* scenario, unsigned niteration)
+{
+  std::cout
+    << "# " << title << " " << scenario
+    << " ncpu=" << std::thread::hardware_concurrency() << " iteration=" << niteration << std::endl;
+}
+
+
+template <typename Semaphore>
+void perf_pingpong(const char* title)
+{
+  Semaphore ping(0), pong(0);
+  std::atomic<std::int64_t> stamp{0};
+  yamc::test::histogram lat, peer_lat;  // [nsec]
+
+  {
+    yamc::test::join_thread thd([&]{
+      for (unsigned i = 0; i < PERF_ITERATION; i++) {
+        ping.acquire();
+        peer_lat.add(now_ns() - stamp.load(std::memory_order_relaxed));
+        stamp.store(now_ns(), std::memory_order_relaxed);
+        pong.release();
+      }
+    });
+    for (unsigned i = 0; i < PERF_ITERATION; i++) {
+      stamp.store(now_ns(), std::memory_order_relaxed);
+      ping.release();
+      pong.acquire();
+      lat.add(now_ns() - stamp.load(std::memory_order_relaxed));
+    }
+  }
+  lat.merge(peer_lat);
+
+  print_header(title, "PingPong", PERF_ITERATION);
+  std::cout << "# -\t[p50]\t[p99]\t[p99.9]\t[max]" << std::endl;
+  std::cout << 2;
+  print_latency(lat);
+  std::cout << "\n\n" << std::flush;
+}
+
+
+/// Waiter::wait(round) blocks until Waiter::wake(round, nwaiter)
+template <typename Waiter>
+void perform_fanout(std::size_t nwaiter)
+{
+  Waiter waiter(nwaiter, PERF_FANOUT_ITERATION);
+  yamc::counting_semaphore<> done(0);
+  std::atomic<std::int64_t> stamp{0};
+  std::atomic<std::int64_t> round_max{0};
+  std::vector<yamc::test::histogram> lats(nwaiter);
+  yamc::test::histogram all_lat, last_lat;  // [nsec]
+
+  std::vector<std::thread> thds;
+  for (std::size_t i = 0; i < nwaiter; i++) {
+    thds.emplace_back([&,i]{
+      for (unsigned r = 0; r < PERF_FANOUT_ITERATION; r++) {
+        waiter.wait(r);
+        const std::int64_t l = now_ns() - stamp.load(std::memory_order_relaxed);
+        lats[i].add(l);
+        update_max(round_max, l);
+        done.release();
+      }
+    });
+  }
+  for (unsigned r = 0; r < PERF_FANOUT_ITERATION; r++) {
+    std::this_thread::sleep_for(PERF_FANOUT_INTERVAL);
+    stamp.store(now_ns(), std::memory_order_relaxed);
+    waiter.wake(r, nwaiter);
+    for (std::size_t k = 0; k < nwaiter; k++) {
+      done.acquire();
+    }
+    last_lat.add(round_max.exchange(0, std::memory_order_relaxed));
+  }
+  for (auto& t : thds) {
+    t.join();
+  }
+  for (const auto& h : lats) {
+    all_lat.merge(h);
+  }
+
+  std::cout << nwaiter;
+  print_latency(all_lat);
+  print_latency(last_lat);
+  std::cout << std::endl;
+}
+
+
+template <typename Waiter>
+void perf_fanout(const char* title, unsigned nthread)
+{
+  print_header(title, "FanOut", PERF_FANOUT_ITERATION);
+  std::cout << "# Waiter\t[p50]\t[p99]\t[p99.9]\t[max]\t[last:p50]\t[p99]\t[p99.9]\t[max]" << std::endl;
+  for (unsigned n = 1; n <= nthread; n++) {
+    perform_fanout<Waiter>(n);
+  }
+  std::cout << "\n\n" << std::flush;
+}
+
+
+template <typename Semaphore>
+struct semaphore_waiter {
+  Semaphore sem{0};
+  semaphore_waiter(std::size_t, unsigned) {}
+  void wait(unsigned) { sem.acquire(); }
+  void wake(unsigned, std::size_t n) { sem.release(static_cast<std::ptrdiff_t>(n)); }
+};
+
+struct latch_waiter {
+  std::vector<std::unique_ptr<yamc::latch>> latches;
+  latch_waiter(std::size_t, unsigned nround)
+  {
+    for (unsigned r = 0; r < nround; r++) {
+      latches.emplace_back(new yamc::latch(1));
+    }
+  }
+  void wait(unsigned r) { latches[r]->wait(); }
+  void wake(unsigned r, std::size_t) { latches[r]->count_down(); }
+};
+
+
+template <typename Semaphore>
+void perf_semaphore(const char* title, unsigned nthread)
+{
+  perf_pingpong<Semaphore>(title);
+  perf_fanout<semaphore_waiter<Semaphore>>(title, nthread);
+}
+
+
+int main()
+{
+  unsigned nthread = 8;
+
+  perf_semaphore<yamc::counting_semaphore<>>("Semaphore", nthread);
+#if defined(ENABLE_POSIX_SEMAPHORE)
+  perf_semaphore<yamc::posix::counting_semaphore<>>("PosixSemaphore", nthread);
+#endif
+#if defined(ENABLE_WIN_SEMAPHORE)
+  perf_semaphore<yamc::win::counting_semaphore<>>("WinSemaphore", nthread);
+#endif
+#if defined(ENABLE_GCD_SEMAPHORE)
+  perf_semaphore<yamc::gcd::counting_semaphore<>>("GcdSemaphore", nthread);
+#endif
+  perf_fanout<latch_waiter>("Latch", nthread);
+}
@@ -0,0 +1,174 @@
+/*
+ * rcu_test.cpp
+ */
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "gtest/gtest.h"
+#include "yamc_rcu.hpp"
+#include "ttas_spin_mutex.hpp"
+#include "fair_mutex.hpp"
+#include "yamc_testutil.hpp"
+
+
+#define TEST_READER_THREADS 4
+#define TEST_UPDATE_COUNT 1000
+#define TEST_STORE_COUNT 100
+
+
+// count live objects
+struct counted {
+  static std::atomic<int> live;
+  std::vector<int> v;
+
+  explicit counted(int n = 0) : v(16, n) { ++live; }
+  counted(const counted& rhs) : v(rhs.v) { ++live; }
+  ~counted() { --live; }
+};
+
+std::atomic<int> counted::live{0};
+
+
+using MutexTypes = ::testing::Types<
+  std::mutex,
+  yamc::spin_ttas::mutex,
+  yamc::fair::mutex
+>;
+
+template <typename Mutex>
+struct RcuCellTest : ::testing::Test {};
+
+TYPED_TEST_SUITE(RcuCellTest, MutexTypes);
+
+// rcu_cell constructor
+TYPED_TEST(RcuCellTest, Ctor)
+{
+  yamc::rcu_cell<int, TypeParam> c0;
+  EXPECT_EQ(0, *c0.read());
+  yamc::rcu_cell<int, TypeParam> c1{42};
+  EXPECT_EQ(42, *c1.read());
+  yamc::rcu_cell<int, TypeParam> c2{std::unique_ptr<int>(new int(7))};
+  EXPECT_EQ(7, *c2.read());
+}
+
+// rcu_cell::store()
+TYPED_TEST(RcuCellTest, Store)
+{
+  yamc::rcu_cell<std::map<int, int>, TypeParam> c;
+  std::map<int, int> m;
+  m[1] = 42;
+  EXPECT_NO_THROW(c.store(m));
+  auto p = c.read();
+  ASSERT_EQ(1u, p->size());
+  EXPECT_EQ(42, p->at(1));
+}
+
+// rcu_cell::update()
+TYPED_TEST(RcuCellTest, Update)
+{
+  yamc::rcu_cell<int, TypeParam> c{1};
+  EXPECT_NO_THROW(c.update([](int& v) { v *= 10; }));
+  EXPECT_EQ(10, *c.read());
+}
+
+// rcu_cell::update() throws exception
+TYPED_TEST(RcuCellTest, UpdateThrow)
+{
+  {
+    yamc::rcu_cell<counted, TypeParam> c{counted{1}};
+    EXPECT_THROW(c.update([](counted& v) { v.v[0] = 2; throw 42; }), int);
+    EXPECT_EQ(1, c.read()->v[0]);
+    EXPECT_EQ(1, counted::live);
+  }
+  EXPECT_EQ(0, counted::live);
+}
+
+// read_ptr is movable
+TYPED_TEST(RcuCellTest, MoveReadPtr)
+{
+  yamc::rcu_cell<int, TypeParam> c{42};
+  auto p1 = c.read();
+  auto p2 = std::move(p1);
+  EXPECT_EQ(nullptr, p1.get());
+  EXPECT_EQ(42, *p2);
+}
+
+// store() waits for readers holding old value
+TYPED_TEST(RcuCellTest, WaitReader)
+{
+  SETUP_STEPTEST;
+  yamc::rcu_cell<counted, TypeParam> c{counted{1}};
+  std::atomic<bool> ready{false};
+  yamc::test::join_thread thd([&]{
+    auto p = c.read();
+    ready = true;
+    while (step.load() < 1) {
+      std::this_thread::yield();
+    }
+    EXPECT_STEP(2);
+    // old value is alive while holding snapshot
+    EXPECT_EQ(1, p->v[0]);
+    EXPECT_EQ(2, counted::live);
+  });
+  {
+    std::unique_ptr<counted> value(new counted{2});
+    while (!ready) {
+      std::this_thread::yield();
+    }
+    EXPECT_STEP(1);
+    c.store(std::move(value));
+    EXPECT_STEP(3);
+    EXPECT_EQ(1, counted::live);
+    EXPECT_EQ(2, c.read()->v[0]);
+  }
+}
+
+// reader never observe reclaimed value
+TYPED_TEST(RcuCellTest, ConsistentRead)
+{
+  {
+    yamc::rcu_cell<counted, TypeParam> c;
+    std::atomic<int> done = {0};
+    yamc::test::task_runner(
+      1 + TEST_READER_THREADS,
+      [&](std::size_t id) {
+        if (id == 0) {
+          // writer-thread
+          for (int n = 1; n <= TEST_STORE_COUNT; n++) {
+            c.store(counted{n});
+          }
+          done = 1;
+        } else {
+          // reader-threads
+          int last = 0;
+          while (!done) {
+            auto p = c.read();
+            for (auto e : p->v) {
+              ASSERT_EQ(p->v[0], e);
+            }
+            EXPECT_LE(last, p->v[0]);
+            last = p->v[0];
+          }
+        }
+      });
+    EXPECT_EQ(TEST_STORE_COUNT, c.read()->v[0]);
+    EXPECT_EQ(1, counted::live);
+  }
+  EXPECT_EQ(0, counted::live);
+}
+
+// concurrent update() are serialized
+TYPED_TEST(RcuCellTest, ConcurrentUpdate)
+{
+  yamc::rcu_cell<std::size_t, TypeParam> c;
+  yamc::test::task_runner(
+    TEST_READER_THREADS,
+    [&](std::size_t) {
+      for (std::size_t n = 0; n < TEST_UPDATE_COUNT; n++) {
+        c.update([](std::size_t& v) { ++v; });
+      }
+    });
+  EXPECT_EQ(std::size_t(TEST_READER_THREADS * TEST_UPDATE_COUNT), *c.read());
+}
@@ -5,6 +5,10 @@
 #include "checked_shared_mutex.hpp"
 #include "fair_shared_mutex.hpp"
 #include "alternate_shared_mutex.hpp"
+#include "distributed_shared_mutex.hpp"
+#include "ticket_spin_shared_mutex.hpp"
+#include "parking_shared_mutex.hpp"
+#include "elision_mutex.hpp"
 #include "yamc_shared_lock.hpp"
 #if defined(__linux__) || defined(__APPLE__)
 #include "posix_native_mutex.hpp"
@@ -30,10 +34,22 @@ using SharedMutexTypes = ::testing::Types<
   yamc::fair::basic_shared_mutex<yamc::rwlock::PhaseFairness>,
   yamc::fair::basic_shared_timed_mutex<yamc::rwlock::TaskFairness>,
   yamc::fair::basic_shared_timed_mutex<yamc::rwlock::PhaseFairness>,
+  yamc::parking::basic_shared_mutex<yamc::rwlock::TaskFairness>,
+  yamc::parking::basic_shared_mutex<yamc::rwlock::PhaseFairness>,
+  yamc::parking::basic_shared_timed_mutex<yamc::rwlock::TaskFairness>,
+  yamc::parking::basic_shared_timed_mutex<yamc::rwlock::PhaseFairness>,
   yamc::alternate::basic_shared_mutex<yamc::rwlock::ReaderPrefer>,
   yamc::alternate::basic_shared_mutex<yamc::rwlock::WriterPrefer>,
   yamc::alternate::basic_shared_timed_mutex<yamc::rwlock::ReaderPrefer>,
-  yamc::alternate::basic_shared_timed_mutex<yamc::rwlock::WriterPrefer>
+  yamc::alternate::basic_shared_timed_mutex<yamc::rwlock::WriterPrefer>,
+  yamc::alternate::basic_shared_mutex<yamc::rwlock::LockFree<yamc::rwlock::ReaderPrefer>>,
+  yamc::alternate::basic_shared_mutex<yamc::rwlock::LockFree<yamc::rwlock::WriterPrefer>>,
+  yamc::alternate::basic_shared_timed_mutex<yamc::rwlock::LockFree<yamc::rwlock::ReaderPrefer>>,
+  yamc::alternate::basic_shared_timed_mutex<yamc::rwlock::LockFree<yamc::rwlock::WriterPrefer>>,
+  yamc::distributed::shared_mutex,
+  yamc::spin_ticket::shared_mutex,
+  yamc::spin_ticket::basic_shared_mutex<yamc::backoff::yield>,
+  yamc::elision::shared_mutex<>
 #if defined(ENABLE_POSIX_NATIVE_MUTEX)
   , yamc::posix::shared_mutex
 #if YAMC_POSIX_TIMEOUT_SUPPORTED
@@ -222,8 +238,12 @@ using SharedTimedMutexTypes = ::testing::Types<
   yamc::checked::shared_timed_mutex,
   yamc::fair::basic_shared_timed_mutex<yamc::rwlock::TaskFairness>,
   yamc::fair::basic_shared_timed_mutex<yamc::rwlock::PhaseFairness>,
+  yamc::parking::basic_shared_timed_mutex<yamc::rwlock::TaskFairness>,
+  yamc::parking::basic_shared_timed_mutex<yamc::rwlock::PhaseFairness>,
   yamc::alternate::basic_shared_timed_mutex<yamc::rwlock::ReaderPrefer>,
-  yamc::alternate::basic_shared_timed_mutex<yamc::rwlock::WriterPrefer>
+  yamc::alternate::basic_shared_timed_mutex<yamc::rwlock::WriterPrefer>,
+  yamc::alternate::basic_shared_timed_mutex<yamc::rwlock::LockFree<yamc::rwlock::ReaderPrefer>>,
+  yamc::alternate::basic_shared_timed_mutex<yamc::rwlock::LockFree<yamc::rwlock::WriterPrefer>>
 #if defined(ENABLE_POSIX_NATIVE_MUTEX) && YAMC_POSIX_TIMEOUT_SUPPORTED
   , yamc::posix::shared_timed_mutex
 #endif
@@ -445,7 +465,9 @@ TYPED_TEST(SharedTimedMutexTest, TryLockSharedUntilTimeout)
 
 using RWLockReaderPreferTypes = ::testing::Types<
   yamc::alternate::basic_shared_mutex<yamc::rwlock::ReaderPrefer>,
-  yamc::alternate::basic_shared_timed_mutex<yamc::rwlock::ReaderPrefer>
+  yamc::alternate::basic_shared_timed_mutex<yamc::rwlock::ReaderPrefer>,
+  yamc::alternate::basic_shared_mutex<yamc::rwlock::LockFree<yamc::rwlock::ReaderPrefer>>,
+  yamc::alternate::basic_shared_timed_mutex<yamc::rwlock::LockFree<yamc::rwlock::ReaderPrefer>>
 >;
 
 template <typename Mutex>
@@ -516,7 +538,10 @@ TYPED_TEST(RWLockReaderPreferTest, LockOrder)
 
 using RwLockWriterPreferTypes = ::testing::Types<
   yamc::alternate::basic_shared_mutex<yamc::rwlock::WriterPrefer>,
-  yamc::alternate::basic_shared_timed_mutex<yamc::rwlock::WriterPrefer>
+  yamc::alternate::basic_shared_timed_mutex<yamc::rwlock::WriterPrefer>,
+  yamc::alternate::basic_shared_mutex<yamc::rwlock::LockFree<yamc::rwlock::WriterPrefer>>,
+  yamc::alternate::basic_shared_timed_mutex<yamc::rwlock::LockFree<yamc::rwlock::WriterPrefer>>,
+  yamc::distributed::shared_mutex
 >;
 
 template <typename Mutex>
@@ -579,3 +604,107 @@ TYPED_TEST(RwLockWriterPreferTest, LockOrder)
   });
   EXPECT_LE(TEST_TICKS * 6, sw.elapsed());
 }
+
+
+using UpgradeMutexTypes = ::testing::Types<
+  yamc::alternate::basic_shared_mutex<yamc::rwlock::ReaderPrefer>,
+  yamc::alternate::basic_shared_mutex<yamc::rwlock::WriterPrefer>,
+  yamc::alternate::basic_shared_mutex<yamc::rwlock::LockFree<yamc::rwlock::ReaderPrefer>>,
+  yamc::alternate::basic_shared_mutex<yamc::rwlock::LockFree<yamc::rwlock::WriterPrefer>>,
+  yamc::alternate::basic_shared_timed_mutex<yamc::rwlock::ReaderPrefer>,
+  yamc::alternate::basic_shared_timed_mutex<yamc::rwlock::WriterPrefer>,
+  yamc::fair::basic_shared_mutex<yamc::rwlock::TaskFairness>,
+  yamc::fair::basic_shared_mutex<yamc::rwlock::PhaseFairness>,
+  yamc::fair::basic_shared_timed_mutex<yamc::rwlock::TaskFairness>,
+  yamc::fair::basic_shared_timed_mutex<yamc::rwlock::PhaseFairness>
+>;
+
+template <typename Mutex>
+struct UpgradeMutexTest : ::testing::Test {};
+
+TYPED_TEST_SUITE(UpgradeMutexTest, UpgradeMutexTypes);
+
+// upgrade-lock coexists with shared-lock, excludes exclusive-lock and other upgrade-lock
+TYPED_TEST(UpgradeMutexTest, LockUpgrade)
+{
+  TypeParam mtx;
+  ASSERT_NO_THROW(mtx.lock_upgrade());
+  yamc::test::task_runner(1, [&](std::size_t) {
+    EXPECT_FALSE(mtx.try_lock());
+    EXPECT_FALSE(mtx.try_lock_upgrade());
+    ASSERT_TRUE(mtx.try_lock_shared());
+    mtx.unlock_shared();
+  });
+  ASSERT_NO_THROW(mtx.unlock_upgrade());
+  EXPECT_TRUE(mtx.try_lock_upgrade());
+  mtx.unlock_upgrade();
+  EXPECT_TRUE(mtx.try_lock());
+  mtx.unlock();
+}
+
+// unlock_upgrade_and_lock() waits for shared-lock owners
+TYPED_TEST(UpgradeMutexTest, UnlockUpgradeAndLock)
+{
+  SETUP_STEPTEST;
+  yamc::test::phaser phaser(2);
+  TypeParam mtx;
+  yamc::test::task_runner(2, [&](std::size_t id) {
+    auto ph = phaser.get(id);
+    switch (id) {
+    case 0:
+      ASSERT_NO_THROW(mtx.lock_upgrade());
+      ph.await();     // p1
+      EXPECT_STEP(2);
+      ASSERT_NO_THROW(mtx.unlock_upgrade_and_lock());
+      EXPECT_STEP(4);
+      mtx.unlock();
+      break;
+    case 1:
+      ASSERT_NO_THROW(mtx.lock_shared());
+      EXPECT_STEP(1);
+      ph.advance(1);  // p1
+      WAIT_TICKS;
+      EXPECT_STEP(3);
+      mtx.unlock_shared();
+      break;
+    }
+  });
+}
+
+// unlock_upgrade_and_lock_shared()
+TYPED_TEST(UpgradeMutexTest, UnlockUpgradeAndLockShared)
+{
+  TypeParam mtx;
+  ASSERT_NO_THROW(mtx.lock_upgrade());
+  ASSERT_NO_THROW(mtx.unlock_upgrade_and_lock_shared());
+  yamc::test::task_runner(1, [&](std::size_t) {
+    EXPECT_FALSE(mtx.try_lock());
+    ASSERT_TRUE(mtx.try_lock_upgrade());
+    mtx.unlock_upgrade();
+  });
+  mtx.unlock_shared();
+}
+
+// read-modify-write by upgraders among readers
+TYPED_TEST(UpgradeMutexTest, UpgradeAtomicity)
+{
+  TypeParam mtx;
+  std::size_t counter = 0;
+  yamc::test::task_runner(2 * TEST_READER_THREADS, [&](std::size_t id) {
+    for (std::size_t n = 0; n < 1000; ++n) {
+      if (id % 2 == 0) {
+        mtx.lock_upgrade();
+        const std::size_t value = counter;
+        mtx.unlock_upgrade_and_lock();
+        counter = value + 1;
+        mtx.unlock();
+      } else {
+        mtx.lock_shared();
+        const std::size_t value = counter;
+        mtx.unlock_shared();
+        EXPECT_LE(value, TEST_READER_THREADS * 1000u);
+      }
+    }
+  });
+  EXPECT_EQ(TEST_READER_THREADS * 1000u, counter);
+}
@@ -216,6 +216,65 @@ TYPED_TEST(SemaphoreTest, ReleaseUpdate)
   );
 }
 
+// semaphore::release(update) with more waiters
+TYPED_TEST(SemaphoreTest, ReleasePartial)
+{
+  using counting_semaphore = typename TypeParam::counting_semaphore_def;
+  counting_semaphore sem{0};
+  std::atomic<int> acquired{0};
+  yamc::test::task_runner(
+    5,
+    [&](std::size_t id) {
+      if (id == 0) {
+        // signal-thread
+        EXPECT_NO_THROW(sem.release(2));
+        while (acquired.load() < 2) {
+          std::this_thread::yield();
+        }
+        std::this_thread::sleep_for(TEST_EXPECT_TIMEOUT);
+        EXPECT_EQ(2, acquired.load());
+        EXPECT_NO_THROW(sem.release(2));
+      } else {
+        // 4 wait-threads
+        EXPECT_NO_THROW(sem.acquire());
+        ++acquired;
+      }
+    }
+  );
+  EXPECT_EQ(4, acquired.load());
+  EXPECT_FALSE(sem.try_acquire());
+}
+
+// semaphore::release(update) wakes up only `update' waiters
+TYPED_TEST(SemaphoreTest, ReleasePartialMany)
+{
+  using counting_semaphore = typename TypeParam::counting_semaphore_def;
+  counting_semaphore sem{0};
+  std::atomic<int> acquired{0};
+  yamc::test::task_runner(
+    TEST_THREADS,
+    [&](std::size_t id) {
+      if (id == 0) {
+        // signal-thread
+        std::this_thread::sleep_for(TEST_EXPECT_TIMEOUT);
+        EXPECT_NO_THROW(sem.release(3));
+        while (acquired.load() < 3) {
+          std::this_thread::yield();
+        }
+        std::this_thread::sleep_for(TEST_EXPECT_TIMEOUT);
+        EXPECT_EQ(3, acquired.load());
+        EXPECT_NO_THROW(sem.release(TEST_THREADS - 1 - 3));
+      } else {
+        // (TEST_THREADS - 1) wait-threads
+        EXPECT_NO_THROW(sem.acquire());
+        ++acquired;
+      }
+    }
+  );
+  EXPECT_EQ(TEST_THREADS - 1, acquired.load());
+  EXPECT_FALSE(sem.try_acquire());
+}
+
 // use semaphore as Mutex
 TYPED_TEST(SemaphoreTest, UseAsMutex)
 {
@@ -236,6 +295,123 @@ TYPED_TEST(SemaphoreTest, UseAsMutex)
 }
 
 
+// multi-permit acquire is provided only by generic semaphore
+template <typename Selector>
+struct MultiPermitSemaphoreTest : ::testing::Test {};
+
+TYPED_TEST_SUITE(MultiPermitSemaphoreTest, ::testing::Types<GenericSemaphore>);
+
+// semaphore::acquire(n)
+TYPED_TEST(MultiPermitSemaphoreTest, AcquireMany)
+{
+  using counting_semaphore = typename TypeParam::counting_semaphore_def;
+  counting_semaphore sem{3};
+  EXPECT_NO_THROW(sem.acquire(3));
+  EXPECT_FALSE(sem.try_acquire());
+}
+
+// semaphore::try_acquire(n)
+TYPED_TEST(MultiPermitSemaphoreTest, TryAcquireMany)
+{
+  using counting_semaphore = typename TypeParam::counting_semaphore_def;
+  counting_semaphore sem{3};
+  EXPECT_TRUE(sem.try_acquire(2));
+  EXPECT_TRUE(sem.try_acquire(1));
+  EXPECT_FALSE(sem.try_acquire());
+}
+
+// semaphore::try_acquire(n) failure takes no permit
+TYPED_TEST(MultiPermitSemaphoreTest, TryAcquireManyFail)
+{
+  using counting_semaphore = typename TypeParam::counting_semaphore_def;
+  counting_semaphore sem{2};
+  EXPECT_FALSE(sem.try_acquire(3));
+  EXPECT_TRUE(sem.try_acquire(2));
+}
+
+// semaphore::try_acquire_for(n)
+TYPED_TEST(MultiPermitSemaphoreTest, TryAcquireManyFor)
+{
+  using counting_semaphore = typename TypeParam::counting_semaphore_def;
+  counting_semaphore sem{2};
+  EXPECT_TRUE(sem.try_acquire_for(2, TEST_NOT_TIMEOUT));
+}
+
+// semaphore::try_acquire_until(n)
+TYPED_TEST(MultiPermitSemaphoreTest, TryAcquireManyUntil)
+{
+  using counting_semaphore = typename TypeParam::counting_semaphore_def;
+  counting_semaphore sem{2};
+  EXPECT_TRUE(sem.try_acquire_until(2, std::chrono::system_clock::now() + TEST_NOT_TIMEOUT));
+}
+
+// semaphore::try_acquire_for(n) timeout gives back partial permits
+TYPED_TEST(MultiPermitSemaphoreTest, TryAcquireManyForTimeout)
+{
+  using counting_semaphore = typename TypeParam::counting_semaphore_def;
+  counting_semaphore sem{2};
+  yamc::test::stopwatch<std::chrono::steady_clock> sw;
+  EXPECT_FALSE(sem.try_acquire_for(3, TEST_EXPECT_TIMEOUT));
+  EXPECT_LE(TEST_EXPECT_TIMEOUT, sw.elapsed());
+  EXPECT_TRUE(sem.try_acquire(2));
+}
+
+// semaphore::try_acquire_until(n) timeout with steady_clock
+TYPED_TEST(MultiPermitSemaphoreTest, TryAcquireManyUntilTimeout)
+{
+  using counting_semaphore = typename TypeParam::counting_semaphore_def;
+  counting_semaphore sem{1};
+  yamc::test::stopwatch<std::chrono::steady_clock> sw;
+  EXPECT_FALSE(sem.try_acquire_until(2, std::chrono::steady_clock::now() + TEST_EXPECT_TIMEOUT));
+  EXPECT_LE(TEST_EXPECT_TIMEOUT, sw.elapsed());
+  EXPECT_TRUE(sem.try_acquire());
+}
+
+// semaphore::acquire(n) waits for all permits
+TYPED_TEST(MultiPermitSemaphoreTest, AcquireManyRelease)
+{
+  SETUP_STEPTEST;
+  using counting_semaphore = typename TypeParam::counting_semaphore_def;
+  counting_semaphore sem{1};
+  yamc::test::join_thread thd([&]{
+    EXPECT_STEP(1);
+    EXPECT_NO_THROW(sem.release());
+    std::this_thread::sleep_for(TEST_EXPECT_TIMEOUT);
+    EXPECT_STEP(2);
+    EXPECT_NO_THROW(sem.release());
+  });
+  // wait-thread
+  {
+    EXPECT_NO_THROW(sem.acquire(3));
+    EXPECT_STEP(3);
+  }
+}
+
+// semaphore::acquire(n) is not starved by single-permit acquirers
+TYPED_TEST(MultiPermitSemaphoreTest, AcquireManyNotStarved)
+{
+  using counting_semaphore = typename TypeParam::counting_semaphore_def;
+  counting_semaphore sem{2};
+  std::atomic<bool> done{false};
+  yamc::test::task_runner(
+    TEST_THREADS,
+    [&](std::size_t id) {
+      if (id == 0) {
+        EXPECT_NO_THROW(sem.acquire(2));
+        done = true;
+        EXPECT_NO_THROW(sem.release(2));
+      } else {
+        while (!done.load()) {
+          EXPECT_NO_THROW(sem.acquire());
+          std::this_thread::yield();
+          EXPECT_NO_THROW(sem.release());
+        }
+      }
+    });
+  EXPECT_TRUE(sem.try_acquire(2));
+}
+
+
 template <typename Selector>
 struct LeastMaxValueTest : ::testing::Test {};
 
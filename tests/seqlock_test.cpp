@@ -0,0 +1,131 @@
+/*
+ * seqlock_test.cpp
+ */
+#include <cstdint>
+#include <mutex>
+#include "gtest/gtest.h"
+#include "yamc_seqlock.hpp"
+#include "naive_spin_mutex.hpp"
+#include "ttas_spin_mutex.hpp"
+#include "fair_mutex.hpp"
+#include "yamc_testutil.hpp"
+
+
+#define TEST_READER_THREADS 4
+#define TEST_UPDATE_COUNT 10000
+
+
+// multiple cache lines of snapshot
+struct snapshot {
+  std::uint32_t v[40];
+};
+
+
+using MutexTypes = ::testing::Types<
+  std::mutex,
+  yamc::spin::mutex,
+  yamc::spin_ttas::mutex,
+  yamc::fair::mutex
+>;
+
+template <typename Mutex>
+struct SeqlockTest : ::testing::Test {};
+
+TYPED_TEST_SUITE(SeqlockTest, MutexTypes);
+
+// seqlock constructor
+TYPED_TEST(SeqlockTest, Ctor)
+{
+  yamc::seqlock<int, TypeParam> sl0;
+  EXPECT_EQ(0, sl0.load());
+  yamc::seqlock<int, TypeParam> sl1{42};
+  EXPECT_EQ(42, sl1.load());
+}
+
+// seqlock::store()
+TYPED_TEST(SeqlockTest, Store)
+{
+  yamc::seqlock<snapshot, TypeParam> sl;
+  snapshot s;
+  for (auto& e : s.v) { e = 42; }
+  EXPECT_NO_THROW(sl.store(s));
+  snapshot r = sl.load();
+  for (auto e : r.v) {
+    EXPECT_EQ(42u, e);
+  }
+}
+
+// seqlock::update()
+TYPED_TEST(SeqlockTest, Update)
+{
+  yamc::seqlock<int, TypeParam> sl{1};
+  EXPECT_NO_THROW(sl.update([](int& v) { v *= 10; }));
+  EXPECT_EQ(10, sl.load());
+}
+
+// seqlock::try_load()
+TYPED_TEST(SeqlockTest, TryLoad)
+{
+  yamc::seqlock<int, TypeParam> sl{42};
+  int v = 0;
+  EXPECT_TRUE(sl.try_load(v));
+  EXPECT_EQ(42, v);
+}
+
+// seqlock::sequence()
+TYPED_TEST(SeqlockTest, Sequence)
+{
+  yamc::seqlock<int, TypeParam> sl;
+  const std::size_t seq = sl.sequence();
+  EXPECT_EQ(0u, seq % 2);
+  sl.store(1);
+  EXPECT_EQ(seq + 2, sl.sequence());
+  sl.update([](int& v) { ++v; });
+  EXPECT_EQ(seq + 4, sl.sequence());
+}
+
+// reader never observe torn snapshot
+TYPED_TEST(SeqlockTest, ConsistentRead)
+{
+  yamc::seqlock<snapshot, TypeParam> sl;
+  std::atomic<int> done = {0};
+  yamc::test::task_runner(
+    1 + TEST_READER_THREADS,
+    [&](std::size_t id) {
+      if (id == 0) {
+        // writer-thread
+        snapshot s;
+        for (std::uint32_t n = 1; n <= TEST_UPDATE_COUNT; n++) {
+          for (auto& e : s.v) { e = n; }
+          sl.store(s);
+        }
+        done = 1;
+      } else {
+        // reader-threads
+        std::uint32_t last = 0;
+        while (!done) {
+          snapshot r = sl.load();
+          for (auto e : r.v) {
+            ASSERT_EQ(r.v[0], e);
+          }
+          EXPECT_LE(last, r.v[0]);
+          last = r.v[0];
+        }
+      }
+    });
+  EXPECT_EQ(std::uint32_t(TEST_UPDATE_COUNT), sl.load().v[0]);
+}
+
+// concurrent update() are serialized
+TYPED_TEST(SeqlockTest, ConcurrentUpdate)
+{
+  yamc::seqlock<std::size_t, TypeParam> sl;
+  yamc::test::task_runner(
+    TEST_READER_THREADS,
+    [&](std::size_t) {
+      for (std::size_t n = 0; n < TEST_UPDATE_COUNT; n++) {
+        sl.update([](std::size_t& v) { ++v; });
+      }
+    });
+  EXPECT_EQ(std::size_t(TEST_READER_THREADS * TEST_UPDATE_COUNT), sl.load());
+}
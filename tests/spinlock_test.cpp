@@ -1,10 +1,16 @@
 /*
  * spinlock_test.cpp
  */
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <type_traits>
 #include "gtest/gtest.h"
 #include "naive_spin_mutex.hpp"
 #include "ttas_spin_mutex.hpp"
+#include "mcs_spin_mutex.hpp"
+#include "ticket_spin_mutex.hpp"
+#include "cohort_mutex.hpp"
 #include "yamc_testutil.hpp"
 #if defined(__linux__) || defined(__APPLE__)
 #include "posix_native_mutex.hpp"
@@ -20,12 +26,32 @@ using SpinMutexTypes = ::testing::Types<
   yamc::spin::basic_mutex<yamc::backoff::exponential<>>,
   yamc::spin_weak::basic_mutex<yamc::backoff::exponential<>>,
   yamc::spin_ttas::basic_mutex<yamc::backoff::exponential<>>,
+  yamc::spin_mcs::basic_mutex<yamc::backoff::exponential<>>,
+  yamc::spin_ticket::basic_mutex<yamc::backoff::exponential<>>,
+  yamc::spin_ticket::basic_mutex<yamc::backoff::proportional<>>,
   yamc::spin::basic_mutex<yamc::backoff::yield>,
   yamc::spin_weak::basic_mutex<yamc::backoff::yield>,
   yamc::spin_ttas::basic_mutex<yamc::backoff::yield>,
+  yamc::spin_mcs::basic_mutex<yamc::backoff::yield>,
+  yamc::spin_ticket::basic_mutex<yamc::backoff::yield>,
   yamc::spin::basic_mutex<yamc::backoff::busy>,
   yamc::spin_weak::basic_mutex<yamc::backoff::busy>,
-  yamc::spin_ttas::basic_mutex<yamc::backoff::busy>
+  yamc::spin_ttas::basic_mutex<yamc::backoff::busy>,
+  yamc::spin_mcs::basic_mutex<yamc::backoff::busy>,
+  yamc::spin_ticket::basic_mutex<yamc::backoff::busy>,
+  yamc::spin::basic_mutex<yamc::backoff::truncated_exponential<>>,
+  yamc::spin_weak::basic_mutex<yamc::backoff::truncated_exponential<>>,
+  yamc::spin_ttas::basic_mutex<yamc::backoff::truncated_exponential<>>,
+  yamc::spin::basic_mutex<yamc::backoff::bounded_random<>>,
+  yamc::spin_weak::basic_mutex<yamc::backoff::bounded_random<>>,
+  yamc::spin_ttas::basic_mutex<yamc::backoff::bounded_random<>>,
+  yamc::spin::basic_timed_mutex<yamc::backoff::exponential<>>,
+  yamc::spin_ttas::basic_timed_mutex<yamc::backoff::exponential<>>,
+  yamc::spin::basic_timed_mutex<yamc::backoff::busy>,
+  yamc::spin_ttas::basic_timed_mutex<yamc::backoff::busy>,
+  yamc::cohort::mutex<>,
+  yamc::cohort::mutex<yamc::spin_mcs::mutex, yamc::spin_ttas::mutex>,
+  yamc::cohort::basic_mutex<yamc::spin::mutex, yamc::spin_ttas::mutex, 1>
 #if defined(ENABLE_POSIX_NATIVE_MUTEX) && YAMC_POSIX_SPINLOCK_SUPPORTED
   , yamc::posix::spinlock
 #endif
@@ -34,31 +60,53 @@ using SpinMutexTypes = ::testing::Types<
 template <typename Mutex>
 struct SpinMutexTest : ::testing::Test {};
 
+// number of test threads
+template <typename Mutex>
+struct test_threads {
+  static std::size_t value() { return TEST_THREADS; }
+};
+
+// queue-based spinlock hands off lock to preempted waiter when threads outnumber processors,
+// limit test threads to processors to finish test in reasonable time.
+struct fifo_test_threads {
+  static std::size_t value()
+  {
+    const unsigned ncpu = std::thread::hardware_concurrency();
+    return (std::min)(static_cast<unsigned>(TEST_THREADS), (ncpu != 0) ? ncpu : 2u);
+  }
+};
+template <typename BackoffPolicy>
+struct test_threads<yamc::spin_mcs::basic_mutex<BackoffPolicy>> : fifo_test_threads {};
+template <typename BackoffPolicy>
+struct test_threads<yamc::spin_ticket::basic_mutex<BackoffPolicy>> : fifo_test_threads {};
+
 TYPED_TEST_SUITE(SpinMutexTest, SpinMutexTypes);
 
 // mutex::lock()
 TYPED_TEST(SpinMutexTest, BasicLock)
 {
   TypeParam mtx;
+  const std::size_t nthread = test_threads<TypeParam>::value();
   std::size_t counter = 0;
   yamc::test::task_runner(
-    TEST_THREADS,
+    nthread,
     [&](std::size_t /*id*/) {
       for (std::size_t n = 0; n < TEST_ITERATION; ++n) {
         std::lock_guard<TypeParam> lk(mtx);
         counter = counter + 1;
       }
     });
-  EXPECT_EQ(TEST_ITERATION * TEST_THREADS, counter);
+  EXPECT_EQ(TEST_ITERATION * nthread, counter);
 }
 
 // mutex::try_lock()
 TYPED_TEST(SpinMutexTest, TryLock)
 {
   TypeParam mtx;
+  const std::size_t nthread = test_threads<TypeParam>::value();
   std::size_t counter = 0;
   yamc::test::task_runner(
-    TEST_THREADS,
+    nthread,
     [&](std::size_t /*id*/) {
       for (std::size_t n = 0; n < TEST_ITERATION; ++n) {
         while (!mtx.try_lock()) {
@@ -68,7 +116,7 @@ TYPED_TEST(SpinMutexTest, TryLock)
         counter = counter + 1;
       }
     });
-  EXPECT_EQ(TEST_ITERATION * TEST_THREADS, counter);
+  EXPECT_EQ(TEST_ITERATION * nthread, counter);
 }
 
 // mutex::try_lock() failure
@@ -90,6 +138,61 @@ TYPED_TEST(SpinMutexTest, TryLockFail)
 }
 
 
+namespace {
+
+// GlobalLock which counts lock() call
+struct counting_lock {
+  static std::atomic<int> nlock;
+  yamc::spin_ttas::mutex mtx;
+
+  void lock() { ++nlock; mtx.lock(); }
+  bool try_lock() { return mtx.try_lock() && (++nlock, true); }
+  void unlock() { mtx.unlock(); }
+};
+std::atomic<int> counting_lock::nlock{0};
+
+} // namespace
+
+// cohort::mutex releases global lock without waiter
+TEST(CohortTest, ReleaseGlobal)
+{
+  counting_lock::nlock = 0;
+  yamc::cohort::mutex<counting_lock> mtx;
+  for (int i = 0; i < 3; i++) {
+    mtx.lock();
+    mtx.unlock();
+  }
+  ASSERT_TRUE(mtx.try_lock());
+  mtx.unlock();
+  EXPECT_EQ(4, counting_lock::nlock);
+}
+
+// cohort::mutex passes global lock to waiter in the same cohort
+TEST(CohortTest, PassGlobal)
+{
+  SETUP_STEPTEST;
+  counting_lock::nlock = 0;
+  yamc::cohort::mutex<counting_lock> mtx;
+  const unsigned node0 = yamc::cohort::this_thread_node();
+  unsigned node1 = 0;
+  mtx.lock();
+  {
+    yamc::test::join_thread thd([&]{
+      node1 = yamc::cohort::this_thread_node();
+      mtx.lock();
+      EXPECT_STEP(3);
+      mtx.unlock();
+    });
+    EXPECT_STEP(1);
+    EXPECT_STEP(2);
+    mtx.unlock();
+  }
+  if (node0 % YAMC_COHORT_NODES != node1 % YAMC_COHORT_NODES) {
+    GTEST_SKIP() << "threads run on different NUMA nodes";
+  }
+  EXPECT_EQ(1, counting_lock::nlock);
+}
+
 // lockfree property of atomic<int>
 TEST(AtomicTest, LockfreeInt)
 {
@@ -103,6 +206,27 @@ TEST(BackoffTest, Macro)
   bool yamc_backoff_spin_default = std::is_same<YAMC_BACKOFF_SPIN_DEFAULT, yamc::backoff::exponential<>>::value;
   EXPECT_TRUE(yamc_backoff_spin_default);
   EXPECT_EQ(4000, YAMC_BACKOFF_EXPONENTIAL_INITCOUNT);
+  EXPECT_EQ(100, YAMC_BACKOFF_PROPORTIONAL_SPINCOUNT);
+  EXPECT_EQ(16, YAMC_BACKOFF_PROPORTIONAL_YIELDCOUNT);
+  EXPECT_EQ(4, YAMC_BACKOFF_TRUNCATED_MINCOUNT);
+  EXPECT_EQ(1024, YAMC_BACKOFF_TRUNCATED_MAXCOUNT);
+  EXPECT_EQ(64, YAMC_BACKOFF_RANDOM_MAXCOUNT);
+  EXPECT_EQ(64, YAMC_BACKOFF_DEADLINE_CHECKCOUNT);
+  EXPECT_EQ(10, YAMC_BACKOFF_DEADLINE_CHECKTIME);
+}
+
+// yamc::backoff::truncated_exponential<> limit
+TEST(BackoffTest, TruncatedExponential)
+{
+  using policy = yamc::backoff::truncated_exponential<4, 32>;
+  policy::state s;
+  EXPECT_EQ(4u, s.limit);
+  policy::wait(s);
+  EXPECT_EQ(8u, s.limit);
+  for (int i = 0; i < 10; ++i) {
+    policy::wait(s);
+  }
+  EXPECT_EQ(32u, s.limit);
 }
 
 // backoff::exponential<100>
@@ -138,6 +262,91 @@ TEST(BackoffTest, Exponential1)
   EXPECT_EQ(0u, state.counter);
 }
 
+// backoff::detail::xorshift32 seed differs on each construction and thread
+TEST(BackoffTest, RandomSeed)
+{
+  int addr = 0;  // same seed address
+  yamc::backoff::detail::xorshift32 r0{&addr};
+  yamc::backoff::detail::xorshift32 r1{&addr};
+  const std::uint32_t v0 = r0(), v1 = r1();
+  std::uint32_t v2 = 0;
+  {
+    yamc::test::join_thread thd([&]{
+      yamc::backoff::detail::xorshift32 r2{&addr};
+      v2 = r2();
+    });
+  }
+  EXPECT_NE(v0, v1);
+  EXPECT_NE(v0, v2);
+  EXPECT_NE(v1, v2);
+}
+
+namespace {
+
+// manually advanced clock which counts now() calls
+struct manual_clock {
+  using rep = std::chrono::microseconds::rep;
+  using period = std::chrono::microseconds::period;
+  using duration = std::chrono::microseconds;
+  using time_point = std::chrono::time_point<manual_clock>;
+  static constexpr bool is_steady = true;
+
+  static time_point current;
+  static duration step;
+  static int nread;
+
+  static time_point now()
+  {
+    ++nread;
+    current += step;
+    return current;
+  }
+};
+
+manual_clock::time_point manual_clock::current;
+manual_clock::duration manual_clock::step;
+int manual_clock::nread;
+
+} // namespace
+
+// backoff::deadline widens clock reading interval on short waits
+TEST(BackoffTest, DeadlineShortWait)
+{
+  manual_clock::current = manual_clock::time_point{};
+  manual_clock::step = std::chrono::microseconds(0);
+  manual_clock::nread = 0;
+  const auto tp = manual_clock::current + std::chrono::seconds(1);
+  yamc::backoff::deadline<manual_clock, manual_clock::duration, 64> dl(tp);
+  EXPECT_FALSE(dl.expired());
+  EXPECT_EQ(1, manual_clock::nread);
+  for (int i = 1; i < 1000; ++i) {
+    EXPECT_FALSE(dl.expired());
+  }
+  EXPECT_LE(16, 1000 / manual_clock::nread);  // read once every 64 calls at most
+  manual_clock::current = tp;
+  for (int i = 0; i < 64; ++i) {
+    if (dl.expired())
+      return;
+  }
+  ADD_FAILURE() << "deadline not detected within 64 calls";
+}
+
+// backoff::deadline reads clock on each call on long waits
+TEST(BackoffTest, DeadlineLongWait)
+{
+  manual_clock::current = manual_clock::time_point{};
+  manual_clock::step = std::chrono::microseconds(YAMC_BACKOFF_DEADLINE_CHECKTIME);
+  manual_clock::nread = 0;
+  const auto tp = manual_clock::current + std::chrono::seconds(1);
+  yamc::backoff::deadline<manual_clock, manual_clock::duration, 64> dl(tp);
+  for (int i = 1; i <= 1000; ++i) {
+    EXPECT_FALSE(dl.expired());
+    EXPECT_EQ(i, manual_clock::nread);
+  }
+  manual_clock::current = tp;
+  EXPECT_TRUE(dl.expired());
+}
+
 // backoff::yield
 TEST(BackoffTest, Yield)
 {
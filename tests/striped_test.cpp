@@ -0,0 +1,160 @@
+/*
+ * striped_test.cpp
+ */
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include "gtest/gtest.h"
+#include "yamc_striped.hpp"
+#include "naive_spin_mutex.hpp"
+#include "ttas_spin_mutex.hpp"
+#include "alternate_shared_mutex.hpp"
+#include "checked_mutex.hpp"
+#include "checked_shared_mutex.hpp"
+#include "yamc_testutil.hpp"
+
+
+#define TEST_THREADS   8
+#define TEST_ITERATION 10000u
+
+
+using MutexTypes = ::testing::Types<
+  std::mutex,
+  yamc::spin::mutex,
+  yamc::spin_ttas::mutex,
+  yamc::checked::mutex
+>;
+
+template <typename Mutex>
+struct StripedTest : ::testing::Test {};
+
+TYPED_TEST_SUITE(StripedTest, MutexTypes);
+
+// striped::lock(key)/unlock(key)
+TYPED_TEST(StripedTest, LockKey)
+{
+  yamc::striped<TypeParam> table;
+  EXPECT_NO_THROW(table.lock(42));
+  EXPECT_NO_THROW(table.unlock(42));
+  EXPECT_NO_THROW(table.lock(std::string("key")));
+  EXPECT_NO_THROW(table.unlock(std::string("key")));
+}
+
+// striped::try_lock(key)
+TYPED_TEST(StripedTest, TryLockKey)
+{
+  yamc::striped<TypeParam> table;
+  ASSERT_TRUE(table.try_lock(42));
+  {
+    yamc::test::join_thread thd([&]{
+      EXPECT_FALSE(table.try_lock(42));
+    });
+  }
+  EXPECT_NO_THROW(table.unlock(42));
+}
+
+// key is mapped to fixed stripe
+TYPED_TEST(StripedTest, Index)
+{
+  yamc::striped<TypeParam, 8> table;
+  EXPECT_EQ(8u, table.size());
+  for (int key = 0; key < 100; key++) {
+    EXPECT_LT(table.index(key), 8u);
+    EXPECT_EQ(table.index(key), table.index(key));
+    EXPECT_EQ(&table.at(table.index(key)), &table.get(key));
+  }
+}
+
+// each stripe occupies its own cache line
+TYPED_TEST(StripedTest, Padding)
+{
+  yamc::striped<TypeParam, 4> table;
+  for (std::size_t i = 1; i < table.size(); i++) {
+    auto p0 = reinterpret_cast<std::uintptr_t>(&table.at(i - 1));
+    auto p1 = reinterpret_cast<std::uintptr_t>(&table.at(i));
+    EXPECT_LE(std::uintptr_t(YAMC_CACHELINE_SIZE), p1 - p0);
+    EXPECT_EQ(0u, p1 % YAMC_CACHELINE_SIZE);
+  }
+  EXPECT_LE(4u * YAMC_CACHELINE_SIZE, sizeof(table));
+}
+
+// heap allocated table keeps cache line alignment
+TYPED_TEST(StripedTest, HeapPadding)
+{
+  std::unique_ptr<yamc::striped<TypeParam, 4>> table{ new yamc::striped<TypeParam, 4> };
+  std::unique_ptr<yamc::striped<TypeParam, 4>[]> tables{ new yamc::striped<TypeParam, 4>[3] };
+  EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(&table->at(0)) % YAMC_CACHELINE_SIZE);
+  for (std::size_t i = 0; i < 3; i++) {
+    for (std::size_t j = 0; j < tables[i].size(); j++) {
+      EXPECT_EQ(0u, reinterpret_cast<std::uintptr_t>(&tables[i].at(j)) % YAMC_CACHELINE_SIZE);
+    }
+  }
+}
+
+// striped::lock_all(keys...) with duplicate stripes
+TYPED_TEST(StripedTest, LockAllDuplicate)
+{
+  yamc::striped<TypeParam, 2> table;
+  EXPECT_NO_THROW(table.lock_all(1, 2, 3, 4, 1));
+  EXPECT_NO_THROW(table.unlock_all(1, 2, 3, 4, 1));
+  EXPECT_NO_THROW(table.lock_all());
+  EXPECT_NO_THROW(table.unlock_all());
+}
+
+// striped::lock_all(keys...) in any key order never deadlocks
+TYPED_TEST(StripedTest, LockAllOrder)
+{
+  yamc::striped<TypeParam, 4> table;
+  std::size_t counter = 0;
+  yamc::test::task_runner(
+    TEST_THREADS,
+    [&](std::size_t id) {
+      for (unsigned n = 0; n < TEST_ITERATION; n++) {
+        if (id % 2) {
+          table.lock_all(0, 1, 2, 3);
+          ++counter;
+          table.unlock_all(0, 1, 2, 3);
+        } else {
+          table.lock_all(3, 2, 1, 0);
+          ++counter;
+          table.unlock_all(3, 2, 1, 0);
+        }
+      }
+    });
+  EXPECT_EQ(TEST_ITERATION * TEST_THREADS, counter);
+}
+
+
+using SharedMutexTypes = ::testing::Types<
+  yamc::alternate::shared_mutex,
+  yamc::checked::shared_mutex
+>;
+
+template <typename Mutex>
+struct StripedSharedTest : ::testing::Test {};
+
+TYPED_TEST_SUITE(StripedSharedTest, SharedMutexTypes);
+
+// striped::lock_shared(key)/unlock_shared(key)
+TYPED_TEST(StripedSharedTest, LockShared)
+{
+  yamc::striped<TypeParam> table;
+  ASSERT_NO_THROW(table.lock_shared(42));
+  {
+    yamc::test::join_thread thd([&]{
+      EXPECT_TRUE(table.try_lock_shared(42));
+      EXPECT_NO_THROW(table.unlock_shared(42));
+      EXPECT_FALSE(table.try_lock(42));
+    });
+  }
+  EXPECT_NO_THROW(table.unlock_shared(42));
+}
+
+// striped::lock_all_shared(keys...)
+TYPED_TEST(StripedSharedTest, LockAllShared)
+{
+  yamc::striped<TypeParam, 2> table;
+  EXPECT_NO_THROW(table.lock_all_shared(1, 2, 3));
+  EXPECT_NO_THROW(table.unlock_all_shared(1, 2, 3));
+}
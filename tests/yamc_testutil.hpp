@@ -27,12 +27,15 @@
 #define YAMC_TESTUTIL_HPP_
 
 #include <cassert>
+#include <cmath>
+#include <cstdint>
 #include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
 #include <memory>
 #include <mutex>
+#include <numeric>
 #include <thread>
 #include <vector>
 
@@ -218,6 +221,64 @@ public:
   }
 };
 
+
+/// latency histogram with 16 sub-buckets per power of two (relative error < 1/16)
+class histogram {
+  static const unsigned nsub = 16;
+  std::vector<std::uint64_t> bins_;
+
+  static unsigned index(std::uint64_t v)
+  {
+    if (v < nsub)
+      return static_cast<unsigned>(v);
+    unsigned msb = 4;
+    while (v >> (msb + 1))
+      ++msb;
+    return (msb - 3) * nsub + static_cast<unsigned>((v >> (msb - 4)) & (nsub - 1));
+  }
+
+  static std::uint64_t lower_bound(unsigned idx)
+  {
+    if (idx < nsub)
+      return idx;
+    const unsigned msb = idx / nsub + 3;
+    return static_cast<std::uint64_t>(nsub + idx % nsub) << (msb - 4);
+  }
+
+public:
+  histogram() : bins_(61 * nsub) {}
+
+  void add(std::uint64_t v)
+  {
+    ++bins_[index(v)];
+  }
+
+  std::uint64_t count() const
+  {
+    return std::accumulate(bins_.begin(), bins_.end(), std::uint64_t{0});
+  }
+
+  void merge(const histogram& rhs)
+  {
+    for (std::size_t i = 0; i < bins_.size(); i++) {
+      bins_[i] += rhs.bins_[i];
+    }
+  }
+
+  /// q-th quantile value (0 < q <= 1)
+  std::uint64_t quantile(double q) const
+  {
+    const std::uint64_t rank = static_cast<std::uint64_t>(std::ceil(q * count()));
+    std::uint64_t acc = 0;
+    for (unsigned i = 0; i < bins_.size(); i++) {
+      acc += bins_[i];
+      if (0 < acc && rank <= acc)
+        return lower_bound(i);
+    }
+    return 0;
+  }
+};
+
 } // namespace test
 
 